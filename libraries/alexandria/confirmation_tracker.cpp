@@ -0,0 +1,49 @@
+#include <sophiatx/alexandria/confirmation_tracker.hpp>
+
+#include <fc/thread/scoped_lock.hpp>
+
+namespace sophiatx { namespace alexandria {
+
+void confirmation_tracker::start( const transaction_id_type& id )
+{
+   fc::scoped_lock< fc::mutex > lock( _mutex );
+   entry& e = _confirmations[ id ];
+   e.confirmation = transaction_confirmation();
+   e.confirmation.id = id;
+   e.generation = ++_last_generation;
+}
+
+void confirmation_tracker::finish( const transaction_confirmation& c )
+{
+   fc::scoped_lock< fc::mutex > lock( _mutex );
+   entry& e = _confirmations[ c.id ];
+   e.confirmation = c;
+   e.generation = ++_last_generation;
+   _finished.emplace_back( c.id, e.generation );
+
+   while( _finished.size() > _max_finished )
+   {
+      auto itr = _confirmations.find( _finished.front().first );
+      // the transaction may have been broadcast again since, that outcome stays
+      if( itr != _confirmations.end() && itr->second.generation == _finished.front().second )
+         _confirmations.erase( itr );
+      _finished.pop_front();
+   }
+}
+
+optional< transaction_confirmation > confirmation_tracker::find( const transaction_id_type& id )const
+{
+   fc::scoped_lock< fc::mutex > lock( _mutex );
+   auto itr = _confirmations.find( id );
+   if( itr == _confirmations.end() )
+      return optional< transaction_confirmation >();
+   return itr->second.confirmation;
+}
+
+size_t confirmation_tracker::size()const
+{
+   fc::scoped_lock< fc::mutex > lock( _mutex );
+   return _confirmations.size();
+}
+
+} } // sophiatx::alexandria
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <sophiatx/alexandria/lib_alexandria.hpp>
+
+#include <fc/thread/mutex.hpp>
+
+#include <deque>
+#include <map>
+
+namespace sophiatx { namespace alexandria {
+
+/**
+ * Outcome of the transactions broadcast asynchronously, shared with the tasks waiting for their blocks.
+ *
+ * A transaction broadcast again replaces the outcome of its earlier broadcast.  Only the last max_finished
+ * outcomes are kept, each entry carries the generation it was recorded in so forgetting an old outcome never
+ * removes a newer one of the same transaction.
+ */
+class confirmation_tracker
+{
+   public:
+      static const size_t default_max_finished = 100000;
+
+      explicit confirmation_tracker( size_t max_finished = default_max_finished ) : _max_finished( max_finished ) {}
+
+      /// records the transaction as in flight
+      void start( const transaction_id_type& id );
+      void finish( const transaction_confirmation& c );
+
+      /// the outcome so far, or nothing if the transaction was not broadcast or its outcome was forgotten
+      optional< transaction_confirmation > find( const transaction_id_type& id )const;
+
+      size_t size()const;
+
+   private:
+      struct entry
+      {
+         transaction_confirmation   confirmation;
+         uint64_t                   generation = 0;
+      };
+
+      mutable fc::mutex                                           _mutex;
+      size_t                                                      _max_finished;
+      uint64_t                                                    _last_generation = 0;
+      std::map< transaction_id_type, entry >                      _confirmations;
+      /// finished outcomes in the order they finished, with the generation they were recorded in
+      std::deque< std::pair< transaction_id_type, uint64_t > >    _finished;
+};
+
+} } // sophiatx::alexandria
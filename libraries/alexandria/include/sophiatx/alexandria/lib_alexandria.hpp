@@ -62,6 +62,20 @@ struct memo_data {
    }
 };
 
+/** Outcome of a transaction broadcast with broadcast_transaction_async */
+struct transaction_confirmation
+{
+   transaction_id_type  id;
+   /// true once the transaction was included in a block
+   bool                 confirmed = false;
+   uint32_t             block_num = 0;
+   uint32_t             transaction_num = 0;
+   /// set if the node rejected the transaction
+   optional< string >   error;
+};
+
+class remote_node_pool;
+
 namespace detail {
 class alexandria_api_impl;
 }
@@ -70,6 +84,7 @@ class alexandria_api
 {
    public:
       alexandria_api( fc::api< remote_node_api > rapi );
+      alexandria_api( std::shared_ptr< remote_node_pool > pool );
       virtual ~alexandria_api();
 
       /** Returns a list of all commands supported by the alexandria API.
@@ -378,6 +393,21 @@ class alexandria_api
        */
       annotated_signed_transaction broadcast_transaction(signed_transaction tx) const;
 
+      /**
+       * Broadcast transaction to node without waiting for it to be included in a block. Many transactions can be
+       * in flight at once, use get_transaction_confirmation to learn their outcome.
+       * @param tx Signed transaction to be broadcasts
+       * @return id of the transaction
+       */
+      transaction_id_type broadcast_transaction_async(signed_transaction tx) const;
+
+      /**
+       * Get the outcome of a transaction broadcast with broadcast_transaction_async
+       * @param id Id of the transaction
+       * @return block of the transaction once confirmed, or the error the node rejected it with
+       */
+      transaction_confirmation get_transaction_confirmation(transaction_id_type id) const;
+
       /**
        * Creating single operation form vector of operations
        * @param op_vec Vector of operations that should be in this transaction
@@ -504,6 +534,41 @@ class alexandria_api
        */
       string decrypt_data(string data, public_key_type public_key, string private_key) const;
 
+      /**
+       * Sign digests with one private key. The key is parsed once and the digests are signed in parallel.
+       * @param digests - digests to be signed
+       * @param pk - private key for signing (in WIF format)
+       * @return signatures in the order of the digests
+       */
+      vector<fc::ecc::compact_signature> sign_digest_batch(vector<digest_type> digests, string pk) const;
+
+      /**
+       * Verify signatures made with one key, in parallel
+       * @param digests - digests corresponding to the signatures
+       * @param pub_key - public key that is expected to have signed every digest
+       * @param signatures - signature of each digest
+       * @return validity of each signature, in the order of the digests
+       */
+      vector<bool> verify_signature_batch(vector<digest_type> digests, public_key_type pub_key, vector<fc::ecc::compact_signature> signatures) const;
+
+      /**
+       * Encrypt data for one recipient. The shared secret is computed once and the items are encrypted in parallel.
+       * @param data - data to encrypt
+       * @param public_key - public key of recipient
+       * @param private_key - private key of sender
+       * @return encrypted data in the order of the input
+       */
+      vector<string> encrypt_data_batch(vector<string> data, public_key_type public_key, string private_key) const;
+
+      /**
+       * Decrypt data from one sender. The shared secret is computed once and the items are decrypted in parallel.
+       * @param data - data to decrypt
+       * @param public_key - public key of sender
+       * @param private_key - private key of recipient
+       * @return decrypted data in the order of the input
+       */
+      vector<string> decrypt_data_batch(vector<string> data, public_key_type public_key, string private_key) const;
+
       /**
        * Check if account account exists
        * @param account_name - name of the account
@@ -646,6 +711,7 @@ class alexandria_api
 FC_REFLECT_ENUM( sophiatx::alexandria::authority_type, (owner)(active) )
 FC_REFLECT( sophiatx::alexandria::key_pair, (pub_key)(wif_priv_key) )
 FC_REFLECT( sophiatx::alexandria::memo_data, (nonce)(check)(encrypted) )
+FC_REFLECT( sophiatx::alexandria::transaction_confirmation, (id)(confirmed)(block_num)(transaction_num)(error) )
 
 FC_API( sophiatx::alexandria::alexandria_api,
         /// alexandria api
@@ -703,6 +769,8 @@ FC_API( sophiatx::alexandria::alexandria_api,
 
         /// helper api
         (broadcast_transaction)
+        (broadcast_transaction_async)
+        (get_transaction_confirmation)
         (create_transaction)
         (create_simple_transaction)
         (calculate_fee)
@@ -724,5 +792,9 @@ FC_API( sophiatx::alexandria::alexandria_api,
         (to_base58)
         (encrypt_data)
         (decrypt_data)
+        (sign_digest_batch)
+        (verify_signature_batch)
+        (encrypt_data_batch)
+        (decrypt_data_batch)
       )
 
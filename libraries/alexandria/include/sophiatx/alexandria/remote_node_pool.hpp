@@ -0,0 +1,99 @@
+#pragma once
+
+#include <sophiatx/alexandria/remote_node_api.hpp>
+
+#include <sophiatx/plugins/json_rpc/binary_rpc_client.hpp>
+
+#include <fc/api.hpp>
+#include <fc/thread/mutex.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace sophiatx { namespace alexandria {
+
+/**
+ * Head block data used to fill in the TaPoS fields and the expiration of new transactions
+ */
+struct reference_block
+{
+   block_id_type        head_block_id;
+   fc::time_point_sec   time;
+   /// local time the data was fetched at
+   fc::time_point       fetched;
+};
+
+/**
+ * Keeps several websocket connections to a node and hands them out round robin, so that calls made from
+ * different tasks are in flight on different connections at the same time.  Connections closed by the node are
+ * reopened the next time they are handed out, the closed one is freed once the last call using it is done.
+ *
+ * The head block reference is cached and fetched again once it is a block interval old, instead of on every
+ * transaction created.
+ *
+ * With binary_rpc set, an additional connection using the binary RPC transport is kept for the calls that move
+ * large payloads, see binary().
+ */
+class remote_node_pool
+{
+   public:
+      /// an open connection to the node
+      struct node_connection
+      {
+         /// set when the node closed the connection
+         std::atomic< bool >           closed{ false };
+         /// the websocket client and connection behind api, if any
+         std::shared_ptr< void >       transport;
+         fc::api< remote_node_api >    api;
+      };
+
+      /// opens a new connection to the node
+      typedef std::function< std::shared_ptr< node_connection >() > connector;
+
+      /// a connection handed out by get(), kept open while any copy of the lease is alive
+      class lease
+      {
+         public:
+            explicit lease( std::shared_ptr< node_connection > connection ) : _connection( std::move( connection ) ) {}
+
+            auto operator->()const { return _connection->api.operator->(); }
+            const fc::api< remote_node_api >& api()const { return _connection->api; }
+
+         private:
+            std::shared_ptr< node_connection > _connection;
+      };
+
+      remote_node_pool( const std::string& server, uint32_t connections, bool binary_rpc = false );
+      /// a pool of the single given connection, which is not reopened
+      explicit remote_node_pool( fc::api< remote_node_api > api );
+      /// a pool of connections opened with connect
+      remote_node_pool( connector connect, uint32_t connections );
+      ~remote_node_pool();
+
+      lease get();
+
+      reference_block get_reference_block();
+
+      /// the binary RPC connection, reopened if it was closed, or null if the pool was created without it
+      std::shared_ptr< json_rpc::binary_rpc_client > binary();
+
+      uint32_t size()const { return _connections.size(); }
+
+   private:
+      std::string                                        _server;
+      connector                                          _connect;
+      std::vector< std::shared_ptr< node_connection > >  _connections;
+      std::atomic< uint32_t >                            _next{ 0 };
+      fc::mutex                                          _connect_mutex;
+
+      bool                                               _binary_rpc = false;
+      std::shared_ptr< json_rpc::binary_rpc_client >     _binary;
+
+      fc::mutex                                          _reference_mutex;
+      reference_block                                    _reference;
+};
+
+} } // sophiatx::alexandria
+
+FC_REFLECT( sophiatx::alexandria::reference_block, (head_block_id)(time)(fetched) )
@@ -1,10 +1,15 @@
 #include <sophiatx/utilities/git_revision.hpp>
+#include <sophiatx/utilities/batch_thread_pool.hpp>
 #include <sophiatx/utilities/key_conversion.hpp>
+#include <sophiatx/utilities/memo_nonce.hpp>
+#include <sophiatx/utilities/shared_secret_cache.hpp>
 
 #include <sophiatx/protocol/base.hpp>
 #include <sophiatx/alexandria/lib_alexandria.hpp>
 #include <sophiatx/alexandria/api_documentation.hpp>
 #include <sophiatx/alexandria/reflect_util.hpp>
+#include <sophiatx/alexandria/remote_node_pool.hpp>
+#include <sophiatx/alexandria/confirmation_tracker.hpp>
 
 
 #include <boost/algorithm/string/replace.hpp>
@@ -28,8 +33,11 @@
 #include <fc/crypto/aes.hpp>
 #include <fc/thread/mutex.hpp>
 #include <fc/thread/scoped_lock.hpp>
+#include <fc/thread/thread.hpp>
 #include <fc/smart_ref_impl.hpp>
 
+#include <thread>
+
 namespace sophiatx { namespace alexandria {
 
 using sophiatx::plugins::condenser_api::legacy_asset;
@@ -55,30 +63,105 @@ class alexandria_api_impl
 
 public:
    alexandria_api& self;
-   alexandria_api_impl( alexandria_api& s, fc::api< remote_node_api > rapi )
-      : self( s ), _remote_api( rapi )
+   alexandria_api_impl( alexandria_api& s, std::shared_ptr< remote_node_pool > pool )
+      : self( s ), _remote_nodes( pool ), _confirmations( std::make_shared< confirmation_tracker >() )
    {}
+
+   /// references the cached head block and expires relative to its time, advanced by the age of the cache
+   void set_tapos( signed_transaction& tx )const
+   {
+      auto ref = _remote_nodes->get_reference_block();
+      tx.set_reference_block( ref.head_block_id );
+      tx.set_expiration( ref.time + uint32_t( ( fc::time_point::now() - ref.fetched ).to_seconds() ) + _tx_expiration_seconds );
+   }
+
+   fc::ecc::private_key parse_private_key( const string& wif )const
+   {
+      auto key = sophiatx::utilities::wif_to_key( wif );
+      FC_ASSERT( key.valid(), "Invalid private key" );
+      return *key;
+   }
+
+   /// documents are fetched through the binary transport if it is enabled, their data is not escaped into JSON
+   map< uint64_t, condenser_api::api_received_object > get_received_documents( uint32_t app_id, const string& account_name,
+                                                                              const string& search_type, const string& start,
+                                                                              uint32_t count )const
+   {
+      auto binary = _remote_nodes->binary();
+      if( !binary )
+         return remote()->get_received_documents( app_id, account_name, search_type, start, count );
+
+      return binary->call< custom::get_received_documents_return >( "custom_api", "get_received_documents",
+         custom::get_received_documents_args{ app_id, account_name, search_type, start, count } ).history;
+   }
+
+   /// the key is only parsed and the secret derived the first time the pair is used
+   fc::sha512 get_shared_secret( const string& wif, const public_key_type& public_key )
+   {
+      auto id = sophiatx::utilities::shared_secret_cache::pair_id( wif.data(), wif.size(), public_key );
+      return _shared_secrets.get( id, [&]() { return parse_private_key( wif ).get_shared_secret( public_key ); } );
+   }
+
+   string encrypt_memo( const string& data, const fc::sha512& shared_secret, int64_t nonce )const
+   {
+      memo_data m;
+      m.nonce = nonce;
+
+      fc::sha512::encoder enc;
+      fc::raw::pack( enc, m.nonce );
+      fc::raw::pack( enc, shared_secret );
+      auto encrypt_key = enc.result();
+
+      m.encrypted = fc::aes_encrypt( encrypt_key, fc::raw::pack_to_vector(data) );
+      m.check = fc::sha256::hash( encrypt_key )._hash[0];
+      return string(m);
+   }
+
+   string decrypt_memo( const string& data, const fc::sha512& shared_secret )const
+   {
+      auto m = memo_data::from_string( data );
+
+      FC_ASSERT(m , "Can not parse input!");
+
+      fc::sha512::encoder enc;
+      fc::raw::pack(enc, m->nonce);
+      fc::raw::pack(enc, shared_secret);
+      auto encryption_key = enc.result();
+
+      uint64_t check = fc::sha256::hash(encryption_key)._hash[ 0 ];
+
+      FC_ASSERT(check == m->check, "Checksum does not match!");
+
+      vector<char> decrypted = fc::aes_decrypt(encryption_key, m->encrypted);
+      return fc::raw::unpack_from_vector<std::string>(decrypted);
+   }
+
+   /// a pooled connection to the node, kept open while the returned lease is alive
+   remote_node_pool::lease remote()const
+   {
+      return _remote_nodes->get();
+   }
    virtual ~alexandria_api_impl()
    {}
 
    variant info() const
    {
-      auto dynamic_props = _remote_api->get_dynamic_global_properties();
+      auto dynamic_props = remote()->get_dynamic_global_properties();
       fc::mutable_variant_object result(fc::variant(dynamic_props).get_object());
-      result["witness_majority_version"] = fc::string( _remote_api->get_witness_schedule().majority_version );
-      result["hardfork_version"] = fc::string( _remote_api->get_hardfork_version() );
+      result["witness_majority_version"] = fc::string( remote()->get_witness_schedule().majority_version );
+      result["hardfork_version"] = fc::string( remote()->get_hardfork_version() );
       //result["head_block_id"] = dynamic_props.head_block_id;
       result["head_block_age"] = fc::get_approximate_relative_time_string(dynamic_props.time,
                                                                           time_point_sec(time_point::now()),
                                                                           " old");
       result["participation"] = (100*dynamic_props.recent_slots_filled.popcount()) / 128.0;
-      result["median_sbd1_price"] = _remote_api->get_current_median_history_price(SBD1_SYMBOL);
-      result["median_sbd2_price"] = _remote_api->get_current_median_history_price(SBD2_SYMBOL);
-      result["median_sbd3_price"] = _remote_api->get_current_median_history_price(SBD3_SYMBOL);
-      result["median_sbd4_price"] = _remote_api->get_current_median_history_price(SBD4_SYMBOL);
-      result["median_sbd5_price"] = _remote_api->get_current_median_history_price(SBD5_SYMBOL);
+      result["median_sbd1_price"] = remote()->get_current_median_history_price(SBD1_SYMBOL);
+      result["median_sbd2_price"] = remote()->get_current_median_history_price(SBD2_SYMBOL);
+      result["median_sbd3_price"] = remote()->get_current_median_history_price(SBD3_SYMBOL);
+      result["median_sbd4_price"] = remote()->get_current_median_history_price(SBD4_SYMBOL);
+      result["median_sbd5_price"] = remote()->get_current_median_history_price(SBD5_SYMBOL);
 
-      result["account_creation_fee"] = _remote_api->get_chain_properties().account_creation_fee;
+      result["account_creation_fee"] = remote()->get_chain_properties().account_creation_fee;
       return result;
    }
 
@@ -114,7 +197,7 @@ public:
 
       try
       {
-         auto v = _remote_api->get_version();
+         auto v = remote()->get_version();
          result["server_blockchain_version"] = v.blockchain_version;
          result["server_sophiatx_revision"] = v.sophiatx_revision;
          result["server_fc_revision"] = v.fc_revision;
@@ -132,7 +215,7 @@ public:
    vector<condenser_api::api_account_object> get_account( string account_name ) const
    {
       string decoded_name = make_random_fixed_string(account_name);
-      auto accounts = _remote_api->get_accounts( { account_name, decoded_name } );
+      auto accounts = remote()->get_accounts( { account_name, decoded_name } );
       FC_ASSERT( !accounts.empty(), "Unknown account" );
       std::vector<condenser_api::api_account_object>  accounts_ret(std::make_move_iterator(accounts.begin()),
                                                                    std::make_move_iterator(accounts.end()));
@@ -150,7 +233,7 @@ public:
 
    optional< condenser_api::api_witness_object > get_witness( string owner_account )
    {
-      return _remote_api->get_witness_by_account( owner_account );
+      return remote()->get_witness_by_account( owner_account );
    }
 
    std::map<string,std::function<string(fc::variant,const fc::variants&)>> get_result_formatters() const
@@ -210,7 +293,12 @@ public:
       return m;
    }
 
-   fc::api< remote_node_api >              _remote_api;
+   std::shared_ptr< remote_node_pool >     _remote_nodes;
+   std::shared_ptr< confirmation_tracker > _confirmations;
+   /// signs, verifies and encrypts the items of the batch apis
+   sophiatx::utilities::batch_thread_pool   _batch_pool{ std::max( std::thread::hardware_concurrency(), 1u ) };
+   /// ECDH secrets of the pairs memos were recently encrypted or decrypted between
+   sophiatx::utilities::shared_secret_cache _shared_secrets{ 1024 };
    uint32_t                                _tx_expiration_seconds = 30;
    chain_id_type                           _chain_id;
 
@@ -226,23 +314,35 @@ public:
 namespace sophiatx { namespace alexandria {
 
 alexandria_api::alexandria_api(fc::api< remote_node_api > rapi)
-   : my(new detail::alexandria_api_impl(*this, rapi))
+   : my(new detail::alexandria_api_impl(*this, std::make_shared< remote_node_pool >( rapi )))
+{}
+
+alexandria_api::alexandria_api(std::shared_ptr< remote_node_pool > pool)
+   : my(new detail::alexandria_api_impl(*this, pool))
 {}
 
 alexandria_api::~alexandria_api(){}
 
 optional< database_api::api_signed_block_object > alexandria_api::get_block(uint32_t num)
 {
-   return my->_remote_api->get_block( num );
+   auto binary = my->_remote_nodes->binary();
+   if( !binary )
+      return my->remote()->get_block( num );
+
+   auto r = binary->call< block_api::get_block_return >( "block_api", "get_block", block_api::get_block_args{ num } );
+   if( !r.block )
+      return optional< database_api::api_signed_block_object >();
+
+   return database_api::api_signed_block_object( std::move( *r.block ) );
 }
 
 vector< condenser_api::api_operation_object > alexandria_api::get_ops_in_block(uint32_t block_num, bool only_virtual)
 {
-   return my->_remote_api->get_ops_in_block( block_num, only_virtual );
+   return my->remote()->get_ops_in_block( block_num, only_virtual );
 }
 
 vector< account_name_type > alexandria_api::get_active_witnesses()const {
-   return my->_remote_api->get_active_witnesses();
+   return my->remote()->get_active_witnesses();
 }
 
 variant alexandria_api::info()
@@ -257,7 +357,7 @@ variant_object alexandria_api::about()
 
 vector< account_name_type > alexandria_api::list_witnesses(const string& lowerbound, uint32_t limit)
 {
-   return my->_remote_api->lookup_witness_accounts( lowerbound, limit );
+   return my->remote()->lookup_witness_accounts( lowerbound, limit );
 }
 
 optional< condenser_api::api_witness_object > alexandria_api::get_witness(string owner_account)
@@ -308,7 +408,7 @@ alexandria_api::get_result_formatters() const
 }
 
 condenser_api::api_feed_history_object alexandria_api::get_feed_history(string symbol)const {
-   return my->_remote_api->get_feed_history(asset_symbol_type::from_string(symbol));
+   return my->remote()->get_feed_history(asset_symbol_type::from_string(symbol));
 }
 
 operation alexandria_api::create_account( string creator,
@@ -326,14 +426,14 @@ operation alexandria_api::create_account( string creator,
    op.active = authority( 1, active, 1 );
    op.memo_key = memo;
    op.json_metadata = json_meta;
-   op.fee = my->_remote_api->get_chain_properties().account_creation_fee * asset( 1, SOPHIATX_SYMBOL );
+   op.fee = my->remote()->get_chain_properties().account_creation_fee * asset( 1, SOPHIATX_SYMBOL );
 
    return op;
 } FC_CAPTURE_AND_RETHROW( (creator)(name_seed)(json_meta)(owner)(active)(memo)) }
 
 vector< database_api::api_owner_authority_history_object > alexandria_api::get_owner_history( string account )const
 {
-   return my->_remote_api->get_owner_history( account );
+   return my->remote()->get_owner_history( account );
 }
 
 operation alexandria_api::update_account(
@@ -366,7 +466,7 @@ operation alexandria_api::update_witness( string witness_account_name,
 
    witness_update_operation op;
 
-   optional< condenser_api::api_witness_object > wit = my->_remote_api->get_witness_by_account( witness_account_name );
+   optional< condenser_api::api_witness_object > wit = my->remote()->get_witness_by_account( witness_account_name );
    if( !wit.valid() )
    {
       op.url = url;
@@ -439,7 +539,7 @@ operation alexandria_api::withdraw_vesting(string from, asset vesting_shares)
 }
 
 annotated_signed_transaction alexandria_api::get_transaction( transaction_id_type id )const {
-   return my->_remote_api->get_transaction( id );
+   return my->remote()->get_transaction( id );
 }
 
 vector<condenser_api::api_account_object> alexandria_api::get_account( string account_name ) const
@@ -489,7 +589,7 @@ operation alexandria_api::cancel_application_buying(string app_owner, string buy
 vector<condenser_api::api_application_buying_object> alexandria_api::get_application_buyings(string name, string search_type, uint32_t count)
 {
     try{
-       return my->_remote_api->get_application_buyings(name, count, search_type);
+       return my->remote()->get_application_buyings(name, count, search_type);
     }FC_CAPTURE_AND_RETHROW((name)(search_type)(count))
 }
 
@@ -564,7 +664,7 @@ vector< condenser_api::api_received_object >  alexandria_api::get_received_docum
    try{
       typedef std::map< uint64_t, condenser_api::api_received_object > ObjectMap;
       std::vector<condenser_api::api_received_object> ret;
-      ObjectMap from_api = my->_remote_api->get_received_documents(app_id, account_name, search_type, start, count);
+      ObjectMap from_api = my->get_received_documents(app_id, account_name, search_type, start, count);
       std::transform( from_api.begin(), from_api.end(),
                    std::back_inserter(ret),
                    boost::bind(&ObjectMap::value_type::second,_1) );
@@ -574,7 +674,7 @@ vector< condenser_api::api_received_object >  alexandria_api::get_received_docum
 
 vector< condenser_api::api_operation_object > alexandria_api::get_account_history( string account, uint32_t from, uint32_t limit ) {
    typedef std::map< uint32_t, condenser_api::api_operation_object > ObjectMap;
-   ObjectMap from_api = my->_remote_api->get_account_history( account, from, limit );
+   ObjectMap from_api = my->remote()->get_account_history( account, from, limit );
    std::vector < condenser_api::api_operation_object > ret;
    std::transform( from_api.begin(), from_api.end(),
                    std::back_inserter(ret),
@@ -584,12 +684,12 @@ vector< condenser_api::api_operation_object > alexandria_api::get_account_histor
 #else
 map< uint64_t, condenser_api::api_received_object >  alexandria_api::get_received_documents(uint32_t app_id, string account_name, string search_type, string start, uint32_t count){
    try{
-      return my->_remote_api->get_received_documents(app_id, account_name, search_type, start, count);
+      return my->get_received_documents(app_id, account_name, search_type, start, count);
     }FC_CAPTURE_AND_RETHROW((app_id)(account_name)(search_type)(start)(count))
 }
 
 map< uint32_t, condenser_api::api_operation_object > alexandria_api::get_account_history( string account, uint32_t from, uint32_t limit ) {
-   auto result = my->_remote_api->get_account_history( account, from, limit );
+   auto result = my->remote()->get_account_history( account, from, limit );
    return result;
 }
 #endif
@@ -598,7 +698,7 @@ map< uint32_t, condenser_api::api_operation_object > alexandria_api::get_account
 annotated_signed_transaction alexandria_api::broadcast_transaction(signed_transaction tx) const
 {
    try {
-      auto result = my->_remote_api->broadcast_transaction_synchronous( tx );
+      auto result = my->remote()->broadcast_transaction_synchronous( tx );
       annotated_signed_transaction rtrx(tx);
       rtrx.block_num = result.block_num;
       rtrx.transaction_num = result.trx_num;
@@ -606,6 +706,43 @@ annotated_signed_transaction alexandria_api::broadcast_transaction(signed_transa
     }FC_CAPTURE_AND_RETHROW((tx))
 }
 
+transaction_id_type alexandria_api::broadcast_transaction_async(signed_transaction tx) const
+{
+   try {
+      auto id = tx.id();
+      auto confirmations = my->_confirmations;
+      auto remote = my->remote();
+      confirmations->start( id );
+      fc::async( [confirmations, remote, tx, id]()
+      {
+         transaction_confirmation c;
+         c.id = id;
+         try
+         {
+            auto result = remote->broadcast_transaction_synchronous( tx );
+            c.confirmed = true;
+            c.block_num = result.block_num;
+            c.transaction_num = result.trx_num;
+         }
+         catch( const fc::exception& e )
+         {
+            c.error = e.to_string();
+         }
+         confirmations->finish( c );
+      }, "alexandria broadcast" );
+      return id;
+    }FC_CAPTURE_AND_RETHROW((tx))
+}
+
+transaction_confirmation alexandria_api::get_transaction_confirmation(transaction_id_type id) const
+{
+   try {
+      auto confirmation = my->_confirmations->find( id );
+      FC_ASSERT( confirmation.valid(), "Transaction was not broadcast by broadcast_transaction_async" );
+      return *confirmation;
+    }FC_CAPTURE_AND_RETHROW((id))
+}
+
 signed_transaction alexandria_api::create_transaction(vector<operation> op_vec) const
 {
     try{
@@ -630,9 +767,7 @@ signed_transaction alexandria_api::create_transaction(vector<operation> op_vec)
             tx.operations.push_back(op);
         }
 
-        auto dyn_props = my->_remote_api->get_dynamic_global_properties();
-        tx.set_reference_block( dyn_props.head_block_id );
-        tx.set_expiration( dyn_props.time + fc::seconds(my->_tx_expiration_seconds) );
+        my->set_tapos( tx );
 
         tx.validate();
         return tx;
@@ -660,9 +795,7 @@ signed_transaction alexandria_api::create_simple_transaction(operation op) const
         op.visit(op_v);
         tx.operations.push_back(op);
 
-        auto dyn_props = my->_remote_api->get_dynamic_global_properties();
-        tx.set_reference_block( dyn_props.head_block_id );
-        tx.set_expiration( dyn_props.time + fc::seconds(my->_tx_expiration_seconds) );
+        my->set_tapos( tx );
 
         tx.validate();
         return tx;
@@ -679,7 +812,7 @@ operation alexandria_api::delete_account(string account_name) {
 
 vector<condenser_api::api_application_object> alexandria_api::get_applications(vector<string> names) {
    try{
-      return my->_remote_api->get_applications(names);
+      return my->remote()->get_applications(names);
    }FC_CAPTURE_AND_RETHROW((names))
 }
 
@@ -687,7 +820,7 @@ digest_type alexandria_api::get_transaction_digest(signed_transaction tx) {
    try{
       if(my->_chain_id == fc::sha256())
       {
-         auto v = my->_remote_api->get_version();
+         auto v = my->remote()->get_version();
          my->_chain_id = fc::sha256(v.chain_id);
       }
       return tx.sig_digest(my->_chain_id);
@@ -781,55 +914,84 @@ string alexandria_api::to_base58(std::vector<char> data) const {
 
 string alexandria_api::encrypt_data(string data, public_key_type public_key, string private_key) const {
    try {
-      memo_data m;
-
-      auto priv_key = *sophiatx::utilities::wif_to_key(private_key);
-
-      m.nonce = fc::time_point::now().time_since_epoch().count();
-
-      auto shared_secret = priv_key.get_shared_secret( public_key );
-
-      fc::sha512::encoder enc;
-      fc::raw::pack( enc, m.nonce );
-      fc::raw::pack( enc, shared_secret );
-      auto encrypt_key = enc.result();
-
-      m.encrypted = fc::aes_encrypt( encrypt_key, fc::raw::pack_to_vector(data) );
-      m.check = fc::sha256::hash( encrypt_key )._hash[0];
-      return string(m);
+      auto shared_secret = my->get_shared_secret( private_key, public_key );
+      return my->encrypt_memo( data, shared_secret, sophiatx::utilities::reserve_memo_nonces( 1 ) );
    } FC_CAPTURE_AND_RETHROW((data)(public_key)(private_key))
 }
 
 string alexandria_api::decrypt_data(string data, public_key_type public_key, string private_key) const {
    try {
-      auto m = memo_data::from_string( data );
-
-      FC_ASSERT(m , "Can not parse input!");
-
-      fc::sha512 shared_secret;
-      auto priv_key = *sophiatx::utilities::wif_to_key(private_key);
-
-      shared_secret = priv_key.get_shared_secret(public_key);
-
-      fc::sha512::encoder enc;
-      fc::raw::pack(enc, m->nonce);
-      fc::raw::pack(enc, shared_secret);
-      auto encryption_key = enc.result();
+      auto shared_secret = my->get_shared_secret( private_key, public_key );
+      return my->decrypt_memo( data, shared_secret );
+   } FC_CAPTURE_AND_RETHROW((data)(public_key)(private_key))
+}
 
-      uint64_t check = fc::sha256::hash(encryption_key)._hash[ 0 ];
+vector<fc::ecc::compact_signature> alexandria_api::sign_digest_batch(vector<digest_type> digests, string pk) const {
+   try{
+      auto priv_key = my->parse_private_key( pk );
+      vector<fc::ecc::compact_signature> signatures( digests.size() );
+      my->_batch_pool.run( digests.size(), [&]( size_t i )
+      {
+         signatures[i] = priv_key.sign_compact( digests[i] );
+      });
+      return signatures;
+   }FC_CAPTURE_AND_RETHROW((digests.size()))
+}
 
-      FC_ASSERT(check == m->check, "Checksum does not match!");
+vector<bool> alexandria_api::verify_signature_batch(vector<digest_type> digests, public_key_type pub_key,
+                                                   vector<fc::ecc::compact_signature> signatures) const {
+   try{
+      FC_ASSERT( digests.size() == signatures.size(), "Every digest needs one signature" );
+      // vector<bool> elements can not be written concurrently
+      vector<char> valid( digests.size(), 0 );
+      my->_batch_pool.run( digests.size(), [&]( size_t i )
+      {
+         try
+         {
+            valid[i] = pub_key == fc::ecc::public_key( signatures[i], digests[i] );
+         }
+         catch( const fc::exception& )
+         {
+            // a signature that does not recover to any key is invalid
+         }
+      });
+      return vector<bool>( valid.begin(), valid.end() );
+   }FC_CAPTURE_AND_RETHROW((digests.size())(pub_key))
+}
 
-      vector<char> decrypted = fc::aes_decrypt(encryption_key, m->encrypted);
-      return fc::raw::unpack_from_vector<std::string>(decrypted);
+vector<string> alexandria_api::encrypt_data_batch(vector<string> data, public_key_type public_key, string private_key) const {
+   try {
+      auto shared_secret = my->get_shared_secret( private_key, public_key );
+      int64_t nonce = sophiatx::utilities::reserve_memo_nonces( std::max< int64_t >( data.size(), 1 ) );
+      vector<string> encrypted( data.size() );
+      my->_batch_pool.run( data.size(), [&]( size_t i )
+      {
+         encrypted[i] = my->encrypt_memo( data[i], shared_secret, nonce + int64_t( i ) );
+      });
+      return encrypted;
+   } FC_CAPTURE_AND_RETHROW((data.size())(public_key))
+}
 
-   } FC_CAPTURE_AND_RETHROW((data)(public_key)(private_key))
+vector<string> alexandria_api::decrypt_data_batch(vector<string> data, public_key_type public_key, string private_key) const {
+   try {
+      auto shared_secret = my->get_shared_secret( private_key, public_key );
+      vector<string> decrypted( data.size() );
+      my->_batch_pool.run( data.size(), [&]( size_t i )
+      {
+         try
+         {
+            decrypted[i] = my->decrypt_memo( data[i], shared_secret );
+         }
+         FC_CAPTURE_AND_RETHROW((i))
+      });
+      return decrypted;
+   } FC_CAPTURE_AND_RETHROW((data.size())(public_key))
 }
 
 bool alexandria_api::account_exist(string account_name) const {
    try {
       string decoded_name = make_random_fixed_string(account_name);
-      auto accounts = my->_remote_api->get_accounts( { account_name, decoded_name } );
+      auto accounts = my->remote()->get_accounts( { account_name, decoded_name } );
 
       if( !accounts.empty()) {
          return true;
@@ -966,7 +1128,7 @@ string alexandria_api::get_account_name_from_seed(string seed) const{
 }
 
 asset alexandria_api::calculate_fee(operation op, asset_symbol_type symbol)const{
-   auto props = my->_remote_api->get_chain_properties();
+   auto props = my->remote()->get_chain_properties();
 
    if(op.which() == operation::tag<account_create_operation>::value){
       return props.account_creation_fee;
@@ -995,7 +1157,7 @@ asset alexandria_api::calculate_fee(operation op, asset_symbol_type symbol)const
 }
 
 asset alexandria_api::fiat_to_sphtx(asset fiat)const{
-   auto price = my->_remote_api->get_feed_history(fiat.symbol).current_median_price;
+   auto price = my->remote()->get_feed_history(fiat.symbol).current_median_price;
    if(price.base.amount == 0 || price.quote.amount == 0)
       return fiat;
    if(price.base.symbol!= fiat.symbol && price.quote.symbol!=fiat.symbol)
@@ -1016,7 +1178,7 @@ set<public_key_type> alexandria_api::get_required_signatures(signed_transaction
                  req_owner_approvals.begin() , req_owner_approvals.end(),
                  std::back_inserter( v_approving_account_names ) );
 
-      auto approving_account_objects = my->_remote_api->get_accounts( v_approving_account_names );
+      auto approving_account_objects = my->remote()->get_accounts( v_approving_account_names );
       
       FC_ASSERT( approving_account_objects.size() == v_approving_account_names.size(), "", ("aco.size:", approving_account_objects.size())("acn",v_approving_account_names.size()) );
 
@@ -0,0 +1,100 @@
+#include <sophiatx/alexandria/remote_node_pool.hpp>
+
+#include <fc/network/http/websocket.hpp>
+#include <fc/rpc/websocket_api.hpp>
+#include <fc/thread/scoped_lock.hpp>
+
+namespace sophiatx { namespace alexandria {
+
+namespace {
+
+struct websocket_transport
+{
+   fc::http::websocket_client                           client;
+   fc::http::websocket_connection_ptr                   connection;
+   std::shared_ptr< fc::rpc::websocket_api_connection > api_connection;
+   boost::signals2::scoped_connection                   closed_connection;
+};
+
+std::shared_ptr< remote_node_pool::node_connection > connect_websocket( const std::string& server )
+{
+   auto c = std::make_shared< remote_node_pool::node_connection >();
+   auto transport = std::make_shared< websocket_transport >();
+   transport->connection = transport->client.connect( server );
+   transport->api_connection = std::make_shared< fc::rpc::websocket_api_connection >( *transport->connection );
+   c->api = transport->api_connection->get_remote_api< remote_node_api >( 0, "condenser_api" );
+
+   // the transport, and with it this handler, is destroyed before the flag it sets
+   remote_node_pool::node_connection* raw = c.get();
+   transport->closed_connection = transport->connection->closed.connect( [server, raw]
+   {
+      wlog( "Connection to ${s} closed by the node", ("s", server) );
+      raw->closed = true;
+   } );
+   c->transport = transport;
+   return c;
+}
+
+} // anonymous
+
+remote_node_pool::remote_node_pool( const std::string& server, uint32_t connections, bool binary_rpc )
+   : remote_node_pool( [server]() { return connect_websocket( server ); }, connections )
+{
+   _server = server;
+   _binary_rpc = binary_rpc;
+   if( _binary_rpc )
+      _binary = std::make_shared< json_rpc::binary_rpc_client >( _server );
+}
+
+remote_node_pool::remote_node_pool( fc::api< remote_node_api > api )
+{
+   _connections.push_back( std::make_shared< node_connection >() );
+   _connections.back()->api = api;
+}
+
+remote_node_pool::remote_node_pool( connector connect, uint32_t connections )
+   : _connect( std::move( connect ) )
+{
+   FC_ASSERT( connections > 0, "At least one connection to the node is required" );
+   for( uint32_t i = 0; i < connections; ++i )
+      _connections.push_back( _connect() );
+}
+
+remote_node_pool::~remote_node_pool() {}
+
+remote_node_pool::lease remote_node_pool::get()
+{
+   fc::scoped_lock< fc::mutex > lock( _connect_mutex );
+   auto& c = _connections[ _next++ % _connections.size() ];
+   // leases of the closed connection keep it alive until the calls using it are done
+   if( c->closed && _connect )
+      c = _connect();
+   return lease( c );
+}
+
+std::shared_ptr< json_rpc::binary_rpc_client > remote_node_pool::binary()
+{
+   if( !_binary_rpc )
+      return nullptr;
+
+   fc::scoped_lock< fc::mutex > lock( _connect_mutex );
+   // calls still holding the closed client finish with an error
+   if( !_binary->is_open() )
+      _binary = std::make_shared< json_rpc::binary_rpc_client >( _server );
+   return _binary;
+}
+
+reference_block remote_node_pool::get_reference_block()
+{
+   fc::scoped_lock< fc::mutex > lock( _reference_mutex );
+   if( fc::time_point::now() - _reference.fetched >= fc::seconds( SOPHIATX_BLOCK_INTERVAL ) )
+   {
+      auto props = get()->get_dynamic_global_properties();
+      _reference.head_block_id = props.head_block_id;
+      _reference.time = props.time;
+      _reference.fetched = fc::time_point::now();
+   }
+   return _reference;
+}
+
+} } // sophiatx::alexandria
@@ -0,0 +1,95 @@
+#include <sophiatx/chain/authority_checker.hpp>
+#include <sophiatx/chain/database.hpp>
+
+#include <sophiatx/protocol/exceptions.hpp>
+
+#include <algorithm>
+
+namespace sophiatx { namespace chain {
+
+using namespace sophiatx::protocol;
+
+authority_checker::authority_checker( const database& db, const flat_set< public_key_type >& signatures, uint32_t max_recursion )
+   : _db( db ), _signatures( signatures ), _max_recursion( max_recursion )
+{
+   // flat_set is sorted, so _provided_signatures is too
+   _provided_signatures.reserve( signatures.size() );
+   for( const auto& key : signatures )
+      _provided_signatures.emplace_back( key, false );
+   static const account_name_type temp_account( SOPHIATX_TEMP_ACCOUNT );
+   _approved_by.push_back( temp_account );
+}
+
+void authority_checker::verify( const signed_transaction& trx )
+{ try {
+   flat_set< account_name_type > required_active;
+   flat_set< account_name_type > required_owner;
+   vector< authority > other;
+   trx.get_required_authorities( required_active, required_owner, other );
+
+   for( const auto& auth : other )
+   {
+      SOPHIATX_ASSERT( check_authority( auth ), tx_missing_other_auth, "Missing Authority", ("auth",auth)("sigs",_signatures) );
+   }
+
+   for( const auto& id : required_active )
+   {
+      SOPHIATX_ASSERT( check_authority( id ) ||
+                       check_authority( get_account_authority( id ).owner ),
+                       tx_missing_active_auth, "Missing Active Authority ${id}",
+                       ("id",id)("auth",authority( get_account_authority( id ).active ))("owner",authority( get_account_authority( id ).owner )) );
+   }
+
+   for( const auto& id : required_owner )
+   {
+      SOPHIATX_ASSERT( check_authority( get_account_authority( id ).owner ),
+                       tx_missing_owner_auth, "Missing Owner Authority ${id}",
+                       ("id",id)("auth",authority( get_account_authority( id ).owner )) );
+   }
+
+   SOPHIATX_ASSERT(
+      !has_unused_signatures(),
+      tx_irrelevant_sig,
+      "Unnecessary signature(s) detected"
+      );
+} FC_CAPTURE_AND_RETHROW( (trx) ) }
+
+bool authority_checker::check_authority( const account_name_type& account )
+{
+   if( is_approved( account ) )
+      return true;
+   return check_authority( get_account_authority( account ).active );
+}
+
+bool authority_checker::has_unused_signatures()const
+{
+   return std::any_of( _provided_signatures.begin(), _provided_signatures.end(),
+                       []( const provided_signature& sig ) { return !sig.second; } );
+}
+
+const account_authority_object& authority_checker::get_account_authority( const account_name_type& account )
+{
+   for( const account_authority_object* auth : _accounts )
+      if( auth->account == account )
+         return *auth;
+
+   const auto& auth = _db.get< account_authority_object, by_account >( account );
+   _accounts.push_back( &auth );
+   return auth;
+}
+
+bool authority_checker::signed_by( const public_key_type& key )
+{
+   auto itr = std::lower_bound( _provided_signatures.begin(), _provided_signatures.end(), key,
+                                []( const provided_signature& sig, const public_key_type& k ) { return sig.first < k; } );
+   if( itr == _provided_signatures.end() || itr->first != key )
+      return false;
+   return itr->second = true;
+}
+
+bool authority_checker::is_approved( const account_name_type& account )const
+{
+   return std::find( _approved_by.begin(), _approved_by.end(), account ) != _approved_by.end();
+}
+
+} } // sophiatx::chain
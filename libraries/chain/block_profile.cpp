@@ -0,0 +1,20 @@
+#include <sophiatx/chain/block_profile.hpp>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+namespace sophiatx { namespace chain {
+
+uint64_t profile_ticks()
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+   return __rdtsc();
+#else
+   return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+} } // sophiatx::chain
@@ -1,4 +1,5 @@
 #include <sophiatx/protocol/sophiatx_operations.hpp>
+#include <sophiatx/protocol/operation_util_impl.hpp>
 
 #include <sophiatx/chain/block_summary_object.hpp>
 #include <sophiatx/chain/compound.hpp>
@@ -16,9 +17,11 @@
 #include <sophiatx/chain/custom_content_object.hpp>
 #include <sophiatx/chain/transaction_object.hpp>
 #include <sophiatx/chain/shared_db_merkle.hpp>
+#include <sophiatx/chain/replay_report.hpp>
 #include <sophiatx/chain/operation_notification.hpp>
 #include <sophiatx/chain/witness_schedule.hpp>
 #include <sophiatx/chain/application_object.hpp>
+#include <sophiatx/chain/authority_checker.hpp>
 
 #include <sophiatx/chain/util/asset.hpp>
 #include <sophiatx/chain/util/uint256.hpp>
@@ -118,8 +121,9 @@ void database::open( const open_args& args, const genesis_state_type& genesis )
          undo_all();
          FC_ASSERT( revision() == head_block_num(), "Chainbase revision does not match head block num",
             ("rev", revision())("head_block", head_block_num()) );
+         enable_state_digest();
          if (args.do_validate_invariants)
-            validate_invariants();
+            audit_invariants();
       });
 
       if( head_block_num() )
@@ -186,8 +190,22 @@ uint32_t database::reindex( const open_args& args, const genesis_state_type& gen
 
       with_write_lock( [&]()
       {
+         replay_reporter reporter( *this, args.replay_report, args.replay_report_interval );
+         auto replay_block = [&]( const signed_block& block )
+         {
+            uint32_t operations = 0;
+            for( const auto& trx : block.transactions )
+               operations += trx.operations.size();
+
+            auto apply_start = fc::time_point::now();
+            apply_block( block, skip_flags );
+            reporter.record_apply( block.block_num(), operations, fc::time_point::now() - apply_start );
+         };
+
          _block_log.set_locking( false );
+         auto read_start = fc::time_point::now();
          auto itr = _block_log.read_block( 0 );
+         reporter.record_read( fc::time_point::now() - read_start );
          auto last_block_num = _block_log.head()->block_num();
          if( args.stop_replay_at > 0 && args.stop_replay_at < last_block_num )
             last_block_num = args.stop_replay_at;
@@ -202,15 +220,18 @@ uint32_t database::reindex( const open_args& args, const genesis_state_type& gen
             if( cur_block_num % 100000 == 0 )
                std::cerr << "   " << double( cur_block_num * 100 ) / last_block_num << "%   " << cur_block_num << " of " << last_block_num <<
                "   (" << (get_free_memory() / (1024*1024)) << "M free)\n";
-            apply_block( itr.first, skip_flags );
+            replay_block( itr.first );
 
             if( (args.benchmark.first > 0) && (cur_block_num % args.benchmark.first == 0) )
                args.benchmark.second( cur_block_num, get_abstract_index_cntr() );
+            read_start = fc::time_point::now();
             itr = _block_log.read_block( itr.second );
+            reporter.record_read( fc::time_point::now() - read_start );
          }
 
-         apply_block( itr.first, skip_flags );
+         replay_block( itr.first );
          last_block_number = itr.first.block_num();
+         reporter.flush( last_block_number );
 
          if( (args.benchmark.first > 0) && (last_block_number % args.benchmark.first == 0) )
             args.benchmark.second( last_block_number, get_abstract_index_cntr() );
@@ -275,7 +296,10 @@ bool database::is_known_block( const block_id_type& id )const
 bool database::is_known_transaction( const transaction_id_type& id )const
 { try {
    const auto& trx_idx = get_index<transaction_index>().indices().get<by_trx_id>();
-   return trx_idx.find( id ) != trx_idx.end();
+   if( trx_idx.find( id ) == trx_idx.end() )
+      return false;
+   // the dedup entry of a transaction evicted from the pool stays in the pending state until it is rebuilt
+   return _evicted_pending_tx.find( id ) == _evicted_pending_tx.end() || _pending_tx.find( id ) != nullptr;
 } FC_CAPTURE_AND_RETHROW() }
 
 block_id_type database::find_block_id_for_num( uint32_t block_num )const
@@ -350,12 +374,17 @@ optional<signed_block> database::fetch_block_by_number( uint32_t block_num )cons
 
 const signed_transaction database::get_recent_transaction( const transaction_id_type& trx_id ) const
 { try {
-   auto& index = get_index<transaction_index>().indices().get<by_trx_id>();
+   const pending_transaction* pending = _pending_tx.find( trx_id );
+   if( pending != nullptr )
+      return pending->trx;
+
+   auto& index = get_index<transaction_body_index>().indices().get<by_trx_id>();
    auto itr = index.find(trx_id);
-   FC_ASSERT(itr != index.end());
+   FC_ASSERT( itr != index.end(), "Transaction is not pending${s}",
+              ("s", _store_recent_transactions ? " nor in a recent block" : " and recent transactions are not stored") );
    signed_transaction trx;
    fc::raw::unpack_from_buffer( itr->packed_trx, trx );
-   return trx;;
+   return trx;
 } FC_CAPTURE_AND_RETHROW() }
 
 std::vector< block_id_type > database::get_block_ids_on_fork( block_id_type head_of_fork ) const
@@ -540,6 +569,34 @@ account_name_type database::get_fee_payer(const operation& op){
    return op.visit(op_v);
 }
 
+share_type database::get_transaction_fee( const signed_transaction& trx )const
+{
+   class op_visitor{
+   public:
+      const database* db;
+      op_visitor(const database* _db){db = _db;};
+      typedef share_type result_type;
+      result_type operator()(const base_operation& bop){
+         if(bop.has_special_fee() || bop.fee.amount <= 0)
+            return 0;
+         if(bop.fee.symbol == SOPHIATX_SYMBOL)
+            return bop.fee.amount;
+         try {
+            return db->to_sophiatx(bop.fee).amount;
+         } catch( const fc::exception& ) {
+            // the fee is checked when the operation is applied, here it only ranks the transaction
+            return 0;
+         }
+      }
+   };
+
+   op_visitor op_v(this);
+   share_type fee = 0;
+   for( const auto& op : trx.operations )
+      fee += op.visit(op_v);
+   return fee;
+}
+
 optional<account_name_type> database::get_sponsor(const account_name_type& who) const {
    try {
       const account_fee_sponsor_object *s = find<account_fee_sponsor_object, by_sponsored>(who);
@@ -579,7 +636,7 @@ bool database::push_block(const signed_block& new_block, uint32_t skip)
    bool result;
    detail::with_skip_flags( *this, skip, [&]()
    {
-      detail::without_pending_transactions( *this, std::move(_pending_tx), [&]()
+      detail::without_pending_transactions( *this, _pending_tx.release(), [&]()
       {
          try
          {
@@ -740,7 +797,21 @@ void database::_push_transaction( const signed_transaction& trx )
    // If this is the first transaction pushed after applying a block, start a new undo session.
    // This allows us to quickly rewind to the clean state of the head block, in case a new block arrives.
    if( !_pending_tx_session.valid() )
+   {
       _pending_tx_session = start_undo_session();
+      // transactions left over from a popped session are not reflected in the new one
+      _pending_tx_state_reusable = _pending_tx.empty();
+      _pending_tx_skip_flags = 0;
+      _evicted_pending_tx.clear();
+   }
+
+   FC_ASSERT( _evicted_pending_tx.find( trx.id() ) == _evicted_pending_tx.end(),
+              "Transaction was evicted from the pending pool, it may be pushed again after the next block", ("id", trx.id()) );
+
+   const account_name_type fee_payer = trx.operations.empty() ? account_name_type() : get_fee_payer( trx.operations.front() );
+   const share_type fee = get_transaction_fee( trx );
+   const uint32_t packed_size = fc::raw::pack_size( trx );
+   const pending_transaction* evicted = _pending_tx.check_admission( fee_payer, fee, packed_size );
 
    // Create a temporary undo session as a child of _pending_tx_session.
    // The temporary session will be discarded by the destructor if
@@ -749,7 +820,17 @@ void database::_push_transaction( const signed_transaction& trx )
 
    auto temp_session = start_undo_session();
    _apply_transaction( trx );
-   _pending_tx.push_back( trx );
+   _pending_tx.insert( trx, trx.id(), fee_payer, fee, packed_size );
+   _pending_tx_skip_flags |= get_node_properties().skip_flags;
+
+   if( evicted != nullptr )
+   {
+      // The changes and the dedup entry of the evicted transaction stay in the pending state until it is
+      // rebuilt, at most once per block.  Transactions depending on it are dropped by that rebuild.
+      _evicted_pending_tx.insert( evicted->id );
+      _pending_tx.erase( *evicted );
+      _pending_tx_state_reusable = false;
+   }
 
    notify_changed_objects();
    // The transaction applied successfully. Merge its changes into the pending block session.
@@ -782,7 +863,8 @@ signed_block database::generate_block(
 signed_block database::_generate_block(
    fc::time_point_sec when,
    const account_name_type& witness_owner,
-   const fc::ecc::private_key& block_signing_private_key
+   const fc::ecc::private_key& block_signing_private_key,
+   bool reuse_pending_state
    )
 {
    uint32_t skip = get_node_properties().skip_flags;
@@ -804,57 +886,117 @@ signed_block database::_generate_block(
 
    signed_block pending_block;
 
+   // Checks a transaction applied with any of these skipped may not pass when the block is applied
+   static const uint32_t validity_skip_flags = skip_transaction_signatures | skip_transaction_dupe_check
+      | skip_tapos_check | skip_authority_check | skip_validate;
+
    with_write_lock( [&]()
    {
+      uint64_t postponed_tx_count = 0;
+
       //
-      // The following code throws away existing pending_tx_session and
-      // rebuilds it by re-applying pending transactions.
+      // The pending state is head block state with _pending_tx applied in arrival order, evaluated
+      // at the current head block time, which is also the time transactions are evaluated at while
+      // the new block is applied.  So as long as the head has not changed and the pending
+      // transactions were checked at least as strictly as the block will be, any prefix of the pool
+      // in arrival order is a valid sequence of transactions for the new block and can be taken
+      // without re-applying anything.  The pool only admits the best paying transactions, but on
+      // this path the block takes them in arrival order rather than best paying first.
       //
-      // This rebuild is necessary because pending transactions' validity
-      // and semantics may have changed since they were received, because
-      // time-based semantics are evaluated based on the current block
-      // time.  These changes can only be reflected in the database when
-      // the value of the "when" variable is known, which means we need to
-      // re-apply pending transactions in this method.
+      // The only property that depends on "when" is expiration.  If an expired transaction would
+      // end up in the block, we fall back to the full rebuild below, which drops it along with any
+      // later transaction that depended on it.
       //
-      _pending_tx_session.reset();
-      _pending_tx_session = start_undo_session();
-
-      uint64_t postponed_tx_count = 0;
-      // pop pending state (reset to head block state)
-      for( const signed_transaction& tx : _pending_tx )
+      if( reuse_pending_state && _pending_tx_session.valid() && _pending_tx_state_reusable
+         && !( _pending_tx_skip_flags & ~skip & validity_skip_flags ) )
       {
-         // Only include transactions that have not expired yet for currently generating block,
-         // this should clear problem transactions and allow block production to continue
+         for( const auto& ptx : _pending_tx.get< pending_transaction_pool::by_sequence >() )
+         {
+            uint64_t new_total_size = total_block_size + ptx.packed_size;
 
-         if( tx.expiration < when )
-            continue;
+            // later transactions were applied on top of this one, so they are all postponed
+            if( new_total_size >= maximum_block_size )
+            {
+               postponed_tx_count = _pending_tx.size() - pending_block.transactions.size();
+               break;
+            }
 
-         uint64_t new_total_size = total_block_size + fc::raw::pack_size( tx );
+            if( ptx.expiration < when )
+            {
+               reuse_pending_state = false;
+               break;
+            }
 
-         // postpone transaction if it would make block too big
-         if( new_total_size >= maximum_block_size )
-         {
-            postponed_tx_count++;
-            continue;
+            total_block_size = new_total_size;
+            pending_block.transactions.push_back( ptx.trx );
          }
 
-         try
+         if( !reuse_pending_state )
          {
-            auto temp_session = start_undo_session();
-            _apply_transaction( tx );
-            temp_session.squash();
-
-            total_block_size += fc::raw::pack_size( tx );
-            pending_block.transactions.push_back( tx );
+            pending_block.transactions.clear();
+            total_block_size = max_block_header_size;
+            postponed_tx_count = 0;
          }
-         catch ( const fc::exception& e )
+      }
+      else
+      {
+         reuse_pending_state = false;
+      }
+
+      if( !reuse_pending_state )
+      {
+         //
+         // The following code throws away existing pending_tx_session and
+         // rebuilds it by re-applying pending transactions.
+         //
+         // This rebuild is necessary because pending transactions' validity
+         // and semantics may have changed since they were received, because
+         // time-based semantics are evaluated based on the current block
+         // time.  These changes can only be reflected in the database when
+         // the value of the "when" variable is known, which means we need to
+         // re-apply pending transactions in this method.
+         //
+         _pending_tx_session.reset();
+         _pending_tx_session = start_undo_session();
+         _evicted_pending_tx.clear();
+
+         // Only include transactions that have not expired yet for currently generating block,
+         // this should clear problem transactions and allow block production to continue
+         uint32_t expired_tx_count = _pending_tx.remove_expired( when );
+         if( expired_tx_count > 0 )
+            dlog( "Dropped ${n} expired pending transactions", ("n", expired_tx_count) );
+
+         // Best paying transactions first. A transaction that depends on a lower paying one
+         // fails here and is retried after the block is pushed.
+         for( const auto& ptx : _pending_tx.get< pending_transaction_pool::by_priority >() )
          {
-            // Do nothing, transaction will not be re-applied
-            //wlog( "Transaction was not processed while generating block due to ${e}", ("e", e) );
-            //wlog( "The transaction was ${t}", ("t", tx) );
+            uint64_t new_total_size = total_block_size + ptx.packed_size;
+
+            // postpone transaction if it would make block too big
+            if( new_total_size >= maximum_block_size )
+            {
+               postponed_tx_count++;
+               continue;
+            }
+
+            try
+            {
+               auto temp_session = start_undo_session();
+               _apply_transaction( ptx.trx );
+               temp_session.squash();
+
+               total_block_size = new_total_size;
+               pending_block.transactions.push_back( ptx.trx );
+            }
+            catch ( const fc::exception& e )
+            {
+               // Do nothing, transaction will not be re-applied
+               //wlog( "Transaction was not processed while generating block due to ${e}", ("e", e) );
+               //wlog( "The transaction was ${t}", ("t", tx) );
+            }
          }
       }
+
       if( postponed_tx_count > 0 )
       {
          wlog( "Postponed ${n} transactions due to block size limit", ("n", postponed_tx_count) );
@@ -865,7 +1007,7 @@ signed_block database::_generate_block(
 
    // We have temporarily broken the invariant that
    // _pending_tx_session is the result of applying _pending_tx, as
-   // _pending_tx now consists of the set of postponed transactions.
+   // the pending state has been discarded.
    // However, the push_block() call below will re-create the
    // _pending_tx_session.
 
@@ -904,7 +1046,19 @@ signed_block database::_generate_block(
       FC_ASSERT( fc::raw::pack_size(pending_block) <= SOPHIATX_MAX_BLOCK_SIZE );
    }
 
-   push_block( pending_block, skip );
+   try
+   {
+      push_block( pending_block, skip );
+   }
+   catch( const fc::exception& e )
+   {
+      if( !reuse_pending_state )
+         throw;
+
+      // push_block() has restored the pending state, build the block again the slow way
+      wlog( "Block built from the pending state was rejected, re-applying pending transactions: ${e}", ("e", e.to_detail_string()) );
+      return _generate_block( when, witness_owner, block_signing_private_key, false );
+   }
 
    return pending_block;
 }
@@ -927,6 +1081,9 @@ void database::pop_block()
       _fork_db.pop_block();
       undo();
 
+      while( _state_digests.size() && _state_digests.back().block_num > head_block_num() )
+         _state_digests.pop_back();
+
       _popped_tx.insert( _popped_tx.begin(), head_block->transactions.begin(), head_block->transactions.end() );
 
    }
@@ -940,6 +1097,7 @@ void database::clear_pending()
       assert( (_pending_tx.size() == 0) || _pending_tx_session.valid() );
       _pending_tx.clear();
       _pending_tx_session.reset();
+      _evicted_pending_tx.clear();
    }
    FC_CAPTURE_AND_RETHROW()
 }
@@ -997,6 +1155,57 @@ void database::notify_on_applied_transaction( const signed_transaction& tx )
    SOPHIATX_TRY_NOTIFY( on_applied_transaction, tx )
 }
 
+template< typename Signal, typename Handler >
+boost::signals2::connection database::connect_plugin_handler( Signal& signal, const Handler& func, const std::string& plugin_name,
+   const char* signal_name, int32_t group )
+{
+   const size_t id = _block_profiler.add_handler( plugin_name, signal_name );
+   auto profiled = [this, func, id, plugin_name, signal_name]( const auto& arg )
+   {
+      const bool check_budget = _plugin_handler_budget.count() > 0;
+      const fc::time_point start = check_budget ? fc::time_point::now() : fc::time_point();
+      {
+         scoped_phase_timer timer( _block_profiler.handler( id ) );
+         func( arg );
+      }
+      if( check_budget )
+      {
+         const fc::microseconds elapsed = fc::time_point::now() - start;
+         if( elapsed > _plugin_handler_budget )
+            wlog( "${p} ${s} handler took ${t} us, budget is ${b} us",
+               ("p", plugin_name)("s", signal_name)("t", elapsed.count())("b", _plugin_handler_budget.count()) );
+      }
+   };
+
+   if( group < 0 )
+      return signal.connect( profiled );
+   return signal.connect( group, profiled );
+}
+
+boost::signals2::connection database::add_pre_apply_operation_handler( const apply_operation_handler_t& func,
+   const std::string& plugin_name, int32_t group )
+{
+   return connect_plugin_handler( pre_apply_operation, func, plugin_name, "pre_apply_operation", group );
+}
+
+boost::signals2::connection database::add_post_apply_operation_handler( const apply_operation_handler_t& func,
+   const std::string& plugin_name, int32_t group )
+{
+   return connect_plugin_handler( post_apply_operation, func, plugin_name, "post_apply_operation", group );
+}
+
+boost::signals2::connection database::add_applied_block_handler( const applied_block_handler_t& func,
+   const std::string& plugin_name, int32_t group )
+{
+   return connect_plugin_handler( applied_block, func, plugin_name, "applied_block", group );
+}
+
+boost::signals2::connection database::add_pre_apply_transaction_handler( const apply_transaction_handler_t& func,
+   const std::string& plugin_name, int32_t group )
+{
+   return connect_plugin_handler( on_pre_apply_transaction, func, plugin_name, "on_pre_apply_transaction", group );
+}
+
 account_name_type database::get_scheduled_witness( uint32_t slot_num )const
 {
    const dynamic_global_property_object& dpo = get_dynamic_global_properties();
@@ -1478,12 +1687,13 @@ void database::initialize_indexes()
    add_core_index< account_authority_index                 >(*this);
    add_core_index< witness_index                           >(*this);
    add_core_index< transaction_index                       >(*this);
+   add_local_core_index< transaction_body_index            >(*this);
    add_core_index< block_summary_index                     >(*this);
    add_core_index< witness_schedule_index                  >(*this);
    add_core_index< witness_vote_index                      >(*this);
    add_core_index< feed_history_index                      >(*this);
-   add_core_index< operation_index                         >(*this);
-   add_core_index< account_history_index                   >(*this);
+   add_local_core_index< operation_index                   >(*this);
+   add_local_core_index< account_history_index             >(*this);
    add_core_index< hardfork_property_index                 >(*this);
    add_core_index< owner_authority_history_index           >(*this);
    add_core_index< account_recovery_request_index          >(*this);
@@ -1762,6 +1972,72 @@ void database::set_flush_interval( uint32_t flush_blocks )
    _next_flush_block = 0;
 }
 
+void database::set_store_recent_transactions( bool store )
+{
+   _store_recent_transactions = store;
+}
+
+void database::set_invariant_audit_interval( uint32_t blocks )
+{
+   _invariant_audit_interval = blocks;
+}
+
+void database::set_prevalidation_threads( uint32_t threads )
+{
+   _prevalidator.resize( threads );
+}
+
+void database::enable_state_digest()
+{
+   _state_digests.clear();
+   for( const auto* idx : get_abstract_index_cntr() )
+      idx->set_digest_enabled( _state_digest_history && _state_digest_type_ids.count( idx->type_id() ) );
+
+   if( _state_digest_history )
+      ilog( "Maintaining state digest, digest at block ${b}: ${d}", ("b", head_block_num())("d", compute_state_digest().digest) );
+}
+
+state_digest database::compute_state_digest()const
+{
+   state_digest result;
+   result.block_num = head_block_num();
+   result.block_id = head_block_id();
+
+   for( const auto* idx : get_abstract_index_cntr() )
+   {
+      if( !idx->digest_enabled() )
+         continue;
+
+      index_digest d;
+      d.type_id = idx->type_id();
+      d.size = idx->size();
+      d.digest = idx->digest();
+      result.indices.push_back( d );
+   }
+   std::sort( result.indices.begin(), result.indices.end(),
+      []( const index_digest& a, const index_digest& b ) { return a.type_id < b.type_id; } );
+
+   result.digest = fc::sha256::hash( result.indices );
+   return result;
+}
+
+optional< state_digest > database::find_state_digest( uint32_t block_num )const
+{
+   if( _state_digests.empty() || block_num < _state_digests.front().block_num )
+      return optional< state_digest >();
+
+   // digests are kept for consecutive blocks
+   size_t offset = block_num - _state_digests.front().block_num;
+   if( offset >= _state_digests.size() || _state_digests[ offset ].block_num != block_num )
+      return optional< state_digest >();
+   return _state_digests[ offset ];
+}
+
+void database::set_pending_transaction_limits( uint32_t max_transactions, uint32_t max_transactions_per_account )
+{
+   _pending_tx.set_limits( max_transactions, max_transactions_per_account );
+}
+
 //////////////////// private methods ////////////////////
 
 void database::apply_block( const signed_block& next_block, uint32_t skip )
@@ -1801,6 +2077,9 @@ void database::apply_block( const signed_block& next_block, uint32_t skip )
          /// check invariants
          //if( is_producing() || !( skip & skip_validate_invariants ) )
             validate_invariants();
+
+         if( _invariant_audit_interval != 0 && block_num % _invariant_audit_interval == 0 )
+            audit_invariants();
    }
    FC_CAPTURE_AND_RETHROW( (next_block) );
 
@@ -1877,6 +2156,10 @@ void database::check_free_memory( bool force_print, uint32_t current_block_num )
 void database::_apply_block( const signed_block& next_block )
 { try {
    uint32_t next_block_num = next_block.block_num();
+
+   _block_profiler.begin_block();
+   BOOST_SCOPE_EXIT( this_ ) { this_->_block_profiler.end_block(); } BOOST_SCOPE_EXIT_END
+   scoped_phase_timer block_timer( _block_profiler.phase( block_phase::apply_block ) );
    //block_id_type next_block_id = next_block.id();
 
    uint32_t skip = get_node_properties().skip_flags;
@@ -1936,7 +2219,12 @@ void database::_apply_block( const signed_block& next_block )
       }
    }
 
-   const witness_object& signing_witness = validate_block_header(skip, next_block);
+   const witness_object* signing_witness_ptr = nullptr;
+   {
+      scoped_phase_timer timer( _block_profiler.phase( block_phase::validate_header ) );
+      signing_witness_ptr = &validate_block_header(skip, next_block);
+   }
+   const witness_object& signing_witness = *signing_witness_ptr;
 
    _current_block_num    = next_block_num;
    _current_trx_in_block = 0;
@@ -1970,7 +2258,17 @@ void database::_apply_block( const signed_block& next_block )
       );
 
 
-   for( const auto& trx : next_block.transactions )
+   // Run the checks that do not depend on state for all transactions in parallel, so that only
+   // evaluation is left to the serial loop below
+   std::vector< prevalidated_transaction > prevalidated;
+   if( _prevalidator.size() > 0 && next_block.transactions.size() > 1 )
+   {
+      prevalidated = _prevalidator.prevalidate( next_block.transactions, get_chain_id(),
+                                                !( skip & skip_validate ),
+                                                !( skip & ( skip_transaction_signatures | skip_authority_check ) ) );
+   }
+
+   for( size_t i = 0; i < next_block.transactions.size(); ++i )
    {
       /* We do not need to push the undo state for each transaction
        * because they either all apply and are valid or the
@@ -1978,43 +2276,64 @@ void database::_apply_block( const signed_block& next_block )
        * for transactions when validating broadcast transactions or
        * when building a block.
        */
-      apply_transaction( trx, skip );
+      // consumed by _apply_transaction()
+      _current_prevalidated = prevalidated.empty() ? nullptr : &prevalidated[i];
+      scoped_phase_timer timer( _block_profiler.phase( block_phase::transactions ) );
+      apply_transaction( next_block.transactions[i], skip );
       ++_current_trx_in_block;
    }
 
-   update_global_dynamic_data(next_block);
-   update_signing_witness(signing_witness, next_block);
+   auto profiled = [&]( block_phase phase, const auto& f )
+   {
+      scoped_phase_timer timer( _block_profiler.phase( phase ) );
+      f();
+   };
+
+   profiled( block_phase::update_global_dynamic_data, [&]() { update_global_dynamic_data(next_block); } );
+   profiled( block_phase::update_signing_witness, [&]() { update_signing_witness(signing_witness, next_block); } );
 
-   update_last_irreversible_block();
+   profiled( block_phase::update_last_irreversible_block, [&]() { update_last_irreversible_block(); } );
 
-   create_block_summary(next_block);
-   clear_expired_transactions();
-   update_witness_schedule(*this);
-   process_interests();
+   profiled( block_phase::create_block_summary, [&]() { create_block_summary(next_block); } );
+   profiled( block_phase::clear_expired_transactions, [&]() { clear_expired_transactions(); } );
+   profiled( block_phase::update_witness_schedule, [&]() { update_witness_schedule(*this); } );
+   profiled( block_phase::process_interests, [&]() { process_interests(); } );
 
-   update_median_feeds();
+   profiled( block_phase::update_median_feeds, [&]() { update_median_feeds(); } );
 
-   clear_null_account_balance();
-   process_funds();
-   process_vesting_withdrawals();
+   profiled( block_phase::clear_null_account_balance, [&]() { clear_null_account_balance(); } );
+   profiled( block_phase::process_funds, [&]() { process_funds(); } );
+   profiled( block_phase::process_vesting_withdrawals, [&]() { process_vesting_withdrawals(); } );
 
-   account_recovery_processing();
-   expire_escrow_ratification();
+   profiled( block_phase::account_recovery_processing, [&]() { account_recovery_processing(); } );
+   profiled( block_phase::expire_escrow_ratification, [&]() { expire_escrow_ratification(); } );
 
-   process_hardforks();
+   profiled( block_phase::process_hardforks, [&]() { process_hardforks(); } );
 
    // notify observers that the block has been applied
-   notify_applied_block( next_block );
+   profiled( block_phase::notify_applied_block, [&]() { notify_applied_block( next_block ); } );
 
-   notify_changed_objects();
+   profiled( block_phase::notify_changed_objects, [&]() { notify_changed_objects(); } );
 
-   const auto& econ = get_economic_model();
-   const auto& gpo = get_dynamic_global_properties();
+   profiled( block_phase::record_block, [&]()
+   {
+      const auto& econ = get_economic_model();
+      const auto& gpo = get_dynamic_global_properties();
 
-   modify(econ, [&](economic_model_object& e){
-      e.record_block(next_block_num, gpo.current_supply.amount);
-   });
+      modify(econ, [&](economic_model_object& e){
+         e.record_block(next_block_num, gpo.current_supply.amount);
+      });
+   } );
 
+   if( _state_digest_history )
+   {
+      scoped_phase_timer timer( _block_profiler.phase( block_phase::state_digest ) );
+      while( _state_digests.size() && _state_digests.back().block_num >= next_block_num )
+         _state_digests.pop_back();
+      _state_digests.push_back( compute_state_digest() );
+      while( _state_digests.size() > _state_digest_history )
+         _state_digests.pop_front();
+   }
 }
 FC_CAPTURE_LOG_AND_RETHROW( (next_block.block_num()) )
 }
@@ -2071,33 +2390,59 @@ void database::process_interests() {
    try {
       uint32_t block_no = head_block_num(); //process_interests is called after the current block is accepted
       uint32_t batch = block_no % SOPHIATX_INTEREST_BLOCKS;
-      const auto &econ = get_economic_model();
-      share_type supply_increase = 0;
-      uint64_t id = batch;
-      while( const account_object *a = find_account(id)) {
-         share_type interest = 0;
-
-         if(head_block_num() > SOPHIATX_INTEREST_DELAY) {
-            modify(econ, [ & ](economic_model_object &eo) {
-                 interest = eo.withdraw_interests(a->holdings_considered_for_interests,
-                                                  std::min(uint32_t(SOPHIATX_INTEREST_BLOCKS), head_block_num()));
-            });
-         }
+      const auto& batch_idx = get_index< account_index, by_interest_batch >();
+      auto itr = batch_idx.lower_bound( boost::make_tuple( true, batch ) );
+      auto end = batch_idx.upper_bound( boost::make_tuple( true, batch ) );
+
+      // collected first, paying an account can move it out of the batch
+      std::vector< std::pair< const account_object*, share_type > > due;
+      for( ; itr != end; ++itr )
+         due.emplace_back( &*itr, 0 );
+      if( due.empty() )
+         return;
 
+      if(head_block_num() > SOPHIATX_INTEREST_DELAY) {
+         uint32_t period = std::min(uint32_t(SOPHIATX_INTEREST_BLOCKS), head_block_num());
+         modify(get_economic_model(), [ & ](economic_model_object &eo) {
+              for( auto& d : due )
+                 d.second = eo.withdraw_interests(d.first->holdings_considered_for_interests, period);
+         });
+      }
+
+      share_type supply_increase = 0;
+      for( const auto& d : due ) {
+         const share_type interest = d.second;
          supply_increase += interest;
-         modify(*a, [ & ](account_object &ao) {
+         modify(*d.first, [ & ](account_object &ao) {
               ao.balance.amount += interest;
               ao.holdings_considered_for_interests = ao.total_balance() * SOPHIATX_INTEREST_BLOCKS;
          });
          if(interest > 0)
-            push_virtual_operation(interest_operation(a->name, asset(interest, SOPHIATX_SYMBOL)));
-         id += SOPHIATX_INTEREST_BLOCKS;
+            push_virtual_operation(interest_operation(d.first->name, asset(interest, SOPHIATX_SYMBOL)));
       }
 
       adjust_supply(asset(supply_increase, SOPHIATX_SYMBOL));
    }FC_CAPTURE_AND_RETHROW()
 }
 
+block_profile database::get_block_profile()const
+{
+   static const std::vector< std::string > operation_names = []()
+   {
+      std::vector< std::string > names;
+      operation op;
+      for( int i = 0; i < operation::count(); ++i )
+      {
+         op.set_which( i );
+         names.emplace_back();
+         op.visit( fc::get_operation_name( names.back() ) );
+      }
+      return names;
+   }();
+
+   return _block_profiler.report( operation_names );
+}
+
 void database::process_header_extensions( const signed_block& next_block )
 {
    process_header_visitor _v( next_block.witness, *this );
@@ -2153,16 +2498,19 @@ void database::apply_transaction(const signed_transaction& trx, uint32_t skip)
 
 void database::_apply_transaction(const signed_transaction& trx)
 { try {
-   _current_trx_id = trx.id();
+   const prevalidated_transaction* pre = _current_prevalidated;
+   _current_prevalidated = nullptr;
+
+   _current_trx_id = ( pre && pre->id_computed ) ? pre->id : trx.id();
    uint32_t skip = get_node_properties().skip_flags;
 
-   if( !(skip&skip_validate) ) {   /* issue #505 explains why this skip_flag is disabled */
+   if( !(skip&skip_validate) && !( pre && pre->validated ) ) {   /* issue #505 explains why this skip_flag is disabled */
       trx.validate();
    }
 
    auto& trx_idx = get_index<transaction_index>();
    const chain_id_type& chain_id = get_chain_id();
-   auto trx_id = trx.id();
+   auto trx_id = _current_trx_id;
    // idump((trx_id)(skip&skip_transaction_dupe_check));
    FC_ASSERT( (skip & skip_transaction_dupe_check) ||
               trx_idx.indices().get<by_trx_id>().find(trx_id) == trx_idx.indices().get<by_trx_id>().end(),
@@ -2170,12 +2518,12 @@ void database::_apply_transaction(const signed_transaction& trx)
 
    if( !(skip & (skip_transaction_signatures | skip_authority_check) ) )
    {
-      auto get_active  = [&]( const string& name ) { return authority( get< account_authority_object, by_account >( name ).active ); };
-      auto get_owner   = [&]( const string& name ) { return authority( get< account_authority_object, by_account >( name ).owner );  };
-
       try
       {
-         trx.verify_authority( chain_id, get_active, get_owner, SOPHIATX_MAX_SIG_CHECK_DEPTH );
+         flat_set< public_key_type > recovered_keys;
+         const auto& signature_keys = ( pre && pre->signatures_recovered ) ? pre->signature_keys
+                                                                           : ( recovered_keys = trx.get_signature_keys( chain_id ) );
+         authority_checker( *this, signature_keys, SOPHIATX_MAX_SIG_CHECK_DEPTH ).verify( trx );
       }
       catch( protocol::tx_missing_active_auth& e )
       {
@@ -2211,8 +2559,16 @@ void database::_apply_transaction(const signed_transaction& trx)
       create<transaction_object>([&](transaction_object& transaction) {
          transaction.trx_id = trx_id;
          transaction.expiration = trx.expiration;
-         fc::raw::pack_to_buffer( transaction.packed_trx, trx );
       });
+
+      if( _store_recent_transactions )
+      {
+         create<transaction_body_object>([&](transaction_body_object& transaction) {
+            transaction.trx_id = trx_id;
+            transaction.expiration = trx.expiration;
+            fc::raw::pack_to_buffer( transaction.packed_trx, trx );
+         });
+      }
    }
 
    notify_on_pre_apply_transaction( trx );
@@ -2237,7 +2593,10 @@ void database::apply_operation(const operation& op)
 
    notify_pre_apply_operation( note );
    process_operation_fee(op);
-   _my->_evaluator_registry.get_evaluator( op ).apply( op );
+   {
+      scoped_phase_timer timer( _block_profiler.phase( block_phase::evaluators ), _block_profiler.operation( op.which() ) );
+      _my->_evaluator_registry.get_evaluator( op ).apply( op );
+   }
    notify_post_apply_operation( note );
 }
 
@@ -2397,7 +2756,10 @@ void database::update_last_irreversible_block()
       }
    }
 
-   commit( dpo.last_irreversible_block_num );
+   {
+      scoped_phase_timer timer( _block_profiler.phase( block_phase::undo_commit ) );
+      commit( dpo.last_irreversible_block_num );
+   }
 
    if( !( get_node_properties().skip_flags & skip_block_log ) )
    {
@@ -2434,6 +2796,10 @@ void database::clear_expired_transactions()
    const auto& dedupe_index = transaction_idx.indices().get< by_expiration >();
    while( ( !dedupe_index.empty() ) && ( head_block_time() > dedupe_index.begin()->expiration ) )
       remove( *dedupe_index.begin() );
+
+   const auto& body_index = get_index< transaction_body_index >().indices().get< by_expiration >();
+   while( ( !body_index.empty() ) && ( head_block_time() > body_index.begin()->expiration ) )
+      remove( *body_index.begin() );
 }
 
 #ifdef SOPHIATX_ENABLE_SMT
@@ -2708,11 +3074,6 @@ void database::validate_invariants()const
 {
    try
    {
-      const auto& account_idx = get_index<account_index>().indices().get<by_name>();
-      asset total_supply = asset( 0, SOPHIATX_SYMBOL );
-      asset total_vesting = asset( 0, VESTS_SYMBOL );
-      share_type total_vsf_votes = share_type( 0 );
-
       const auto& gpo = get_dynamic_global_properties();
       const auto& econ = get_economic_model();
 
@@ -2721,38 +3082,65 @@ void database::validate_invariants()const
       for( auto itr = witness_idx.begin(); itr != witness_idx.end(); ++itr )
          FC_ASSERT( itr->votes <= gpo.current_supply.amount, "", ("itr",*itr) );
 
+      // totals maintained by the indexes as objects change, see audit_invariants()
+      const auto& accounts = get_index< account_index >().aggregate();
+      const auto& escrows = get_index< escrow_index >().aggregate();
+
+      FC_ASSERT( escrows.other_fee_count == 0, "found escrow pending fee that is not SPHTX" );
+
+      share_type total_supply = accounts.balance + escrows.sophiatx_balance + escrows.pending_fee;
+
+      FC_ASSERT( gpo.current_supply.amount == total_supply + accounts.vesting_shares, "", ("gpo.current_supply",gpo.current_supply)("total_supply",total_supply) );
+      FC_ASSERT( gpo.total_vesting_shares.amount == accounts.vesting_shares, "", ("gpo.total_vesting_shares",gpo.total_vesting_shares)("total_vesting",accounts.vesting_shares) );
+
+      FC_ASSERT( (gpo.current_supply.amount + econ.interest_pool_from_fees + econ.interest_pool_from_coinbase +
+                 econ.mining_pool_from_fees + econ.mining_pool_from_coinbase + econ.promotion_pool + econ.burn_pool) == SOPHIATX_TOTAL_SUPPLY, "difference is $diff", ("diff", SOPHIATX_TOTAL_SUPPLY -
+                 (gpo.current_supply.amount + econ.interest_pool_from_fees + econ.interest_pool_from_coinbase +
+                 econ.mining_pool_from_fees + econ.mining_pool_from_coinbase + econ.promotion_pool + econ.burn_pool)));
+
+   }
+   FC_CAPTURE_LOG_AND_RETHROW( (head_block_num()) );
+}
+
+void database::audit_invariants()const
+{
+   try
+   {
+      const auto& account_idx = get_index<account_index>().indices().get<by_name>();
+      asset total_balance = asset( 0, SOPHIATX_SYMBOL );
+      asset total_vesting = asset( 0, VESTS_SYMBOL );
+
       for( auto itr = account_idx.begin(); itr != account_idx.end(); ++itr )
       {
-         total_supply += itr->balance;
+         total_balance += itr->balance;
          total_vesting += itr->vesting_shares;
-         total_vsf_votes += ( itr->proxy == SOPHIATX_PROXY_TO_SELF_ACCOUNT ?
-                                 itr->witness_vote_weight() :
-                                 ( SOPHIATX_MAX_PROXY_RECURSION_DEPTH > 0 ?
-                                      itr->proxied_vsf_votes[SOPHIATX_MAX_PROXY_RECURSION_DEPTH - 1] :
-                                      itr->balance.amount ) );
       }
 
+      const auto& accounts = get_index< account_index >().aggregate();
+      FC_ASSERT( accounts.balance == total_balance.amount && accounts.vesting_shares == total_vesting.amount,
+                 "account totals do not match the accounts", ("balance",accounts.balance)("vesting_shares",accounts.vesting_shares)
+                 ("total_balance",total_balance)("total_vesting",total_vesting) );
+
       const auto& escrow_idx = get_index< escrow_index >().indices().get< by_id >();
+      asset total_escrowed = asset( 0, SOPHIATX_SYMBOL );
+      asset total_pending_fee = asset( 0, SOPHIATX_SYMBOL );
 
       for( auto itr = escrow_idx.begin(); itr != escrow_idx.end(); ++itr )
       {
-         total_supply += itr->sophiatx_balance;
+         total_escrowed += itr->sophiatx_balance;
 
          if( itr->pending_fee.symbol == SOPHIATX_SYMBOL )
-            total_supply += itr->pending_fee;
+            total_pending_fee += itr->pending_fee;
          else
             FC_ASSERT( false, "found escrow pending fee that is not SPHTX" );
       }
 
+      const auto& escrows = get_index< escrow_index >().aggregate();
+      FC_ASSERT( escrows.sophiatx_balance == total_escrowed.amount && escrows.pending_fee == total_pending_fee.amount,
+                 "escrow totals do not match the escrows", ("sophiatx_balance",escrows.sophiatx_balance)("pending_fee",escrows.pending_fee)
+                 ("total_escrowed",total_escrowed)("total_pending_fee",total_pending_fee) );
 
-      FC_ASSERT( gpo.current_supply == total_supply + asset(total_vesting.amount, SOPHIATX_SYMBOL), "", ("gpo.current_supply",gpo.current_supply)("total_supply",total_supply) );
-      FC_ASSERT( gpo.total_vesting_shares == total_vesting, "", ("gpo.total_vesting_shares",gpo.total_vesting_shares)("total_vesting",total_vesting) );
-
-      FC_ASSERT( (gpo.current_supply.amount + econ.interest_pool_from_fees + econ.interest_pool_from_coinbase +
-                 econ.mining_pool_from_fees + econ.mining_pool_from_coinbase + econ.promotion_pool + econ.burn_pool) == SOPHIATX_TOTAL_SUPPLY, "difference is $diff", ("diff", SOPHIATX_TOTAL_SUPPLY -
-                 (gpo.current_supply.amount + econ.interest_pool_from_fees + econ.interest_pool_from_coinbase +
-                 econ.mining_pool_from_fees + econ.mining_pool_from_coinbase + econ.promotion_pool + econ.burn_pool)));
-
+      validate_invariants();
    }
    FC_CAPTURE_LOG_AND_RETHROW( (head_block_num()) );
 }
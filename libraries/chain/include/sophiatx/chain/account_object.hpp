@@ -40,7 +40,7 @@ namespace sophiatx { namespace chain {
 
          share_type        holdings_considered_for_interests = 0;
          share_type        update_considered_holding(share_type inserted, uint32_t block_no){
-            uint32_t my_turn = id._id % SOPHIATX_INTEREST_BLOCKS;
+            uint32_t my_turn = interest_batch();
             uint32_t block = block_no % SOPHIATX_INTEREST_BLOCKS;
             int64_t to_my_turn;
             if ( my_turn >= block ){
@@ -52,6 +52,10 @@ namespace sophiatx { namespace chain {
             holdings_considered_for_interests += to_add;
             return to_add;
          };
+         /// block number modulo SOPHIATX_INTEREST_BLOCKS at which process_interests() pays this account
+         uint32_t          interest_batch()const { return id._id % SOPHIATX_INTEREST_BLOCKS; }
+         /// accounts with neither holdings nor balance would be paid nothing and keep nothing, they are not scheduled
+         bool              earns_interest()const { return holdings_considered_for_interests != 0 || total_balance() != 0; }
 
          time_point_sec    created;
          bool              mined = true;
@@ -180,6 +184,7 @@ namespace sophiatx { namespace chain {
    struct by_name;
    struct by_proxy;
    struct by_next_vesting_withdrawal;
+   struct by_interest_batch;
 
    /**
     * @ingroup object_index
@@ -202,6 +207,13 @@ namespace sophiatx { namespace chain {
                member< account_object, time_point_sec, &account_object::next_vesting_withdrawal >,
                member< account_object, account_name_type, &account_object::name >
             > /// composite key by_next_vesting_withdrawal
+         >,
+         ordered_unique< tag< by_interest_batch >,
+            composite_key< account_object,
+               const_mem_fun< account_object, bool, &account_object::earns_interest >,
+               const_mem_fun< account_object, uint32_t, &account_object::interest_batch >,
+               member< account_object, account_id_type, &account_object::id >
+            > /// composite key by_interest_batch
          >
       >,
       allocator< account_object >
@@ -336,6 +348,33 @@ FC_REFLECT( sophiatx::chain::account_object,
           )
 CHAINBASE_SET_INDEX_TYPE( sophiatx::chain::account_object, sophiatx::chain::account_index )
 
+namespace helpers
+{
+   /// Totals checked by database::validate_invariants() without scanning all accounts
+   template<>
+   class index_aggregate_provider< sophiatx::chain::account_object >
+   {
+   public:
+      struct aggregate_type
+      {
+         sophiatx::chain::share_type balance;
+         sophiatx::chain::share_type vesting_shares;
+      };
+
+      static void add( aggregate_type& t, const sophiatx::chain::account_object& a )
+      {
+         t.balance += a.balance.amount;
+         t.vesting_shares += a.vesting_shares.amount;
+      }
+
+      static void subtract( aggregate_type& t, const sophiatx::chain::account_object& a )
+      {
+         t.balance -= a.balance.amount;
+         t.vesting_shares -= a.vesting_shares.amount;
+      }
+   };
+}
+
 FC_REFLECT( sophiatx::chain::account_authority_object,
              (id)(account)(owner)(active)(last_owner_update)
 )
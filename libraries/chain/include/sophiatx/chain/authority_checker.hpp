@@ -0,0 +1,103 @@
+#pragma once
+#include <sophiatx/protocol/transaction.hpp>
+#include <sophiatx/chain/account_object.hpp>
+
+#include <boost/container/small_vector.hpp>
+
+namespace sophiatx { namespace chain {
+
+using sophiatx::protocol::signed_transaction;
+
+class database;
+
+/**
+ *  Checks the signatures of a transaction against the account authorities stored in the database.
+ *
+ *  It implements the same rules as protocol::verify_authority() and sign_state, but the owner and active
+ *  authorities are read in place from account_authority_object instead of being copied into a heap
+ *  allocated authority for every lookup.  Each account is looked up at most once per transaction, and the
+ *  signature and approval bookkeeping lives in small inline buffers sized for the common case of a single
+ *  key signing for a single account.
+ *
+ *  An instance is meant to check a single transaction and must not outlive the signature set it was
+ *  constructed with.
+ */
+class authority_checker
+{
+   public:
+      authority_checker( const database& db, const flat_set< public_key_type >& signatures,
+                         uint32_t max_recursion = SOPHIATX_MAX_SIG_CHECK_DEPTH );
+
+      /**
+       *  Throws tx_missing_active_auth, tx_missing_owner_auth, tx_missing_other_auth or tx_irrelevant_sig,
+       *  exactly like signed_transaction::verify_authority() would.
+       */
+      void verify( const signed_transaction& trx );
+
+      /** true if the active authority of the account is satisfied, or the account was already approved */
+      bool check_authority( const account_name_type& account );
+
+      /**
+       *  Checks to see if we have signatures of the active authorities of the accounts specified in the
+       *  authority or the keys specified.  Works with both authority and shared_authority.
+       */
+      template< typename AuthorityType >
+      bool check_authority( const AuthorityType& auth, uint32_t depth = 0 )
+      {
+         uint32_t total_weight = 0;
+         for( const auto& k : auth.key_auths )
+         {
+            if( signed_by( k.first ) )
+            {
+               total_weight += k.second;
+               if( total_weight >= auth.weight_threshold )
+                  return true;
+            }
+         }
+
+         for( const auto& a : auth.account_auths )
+         {
+            if( !is_approved( a.first ) )
+            {
+               if( depth == _max_recursion )
+                  continue;
+               if( check_authority( get_account_authority( a.first ).active, depth + 1 ) )
+               {
+                  _approved_by.push_back( a.first );
+                  total_weight += a.second;
+                  if( total_weight >= auth.weight_threshold )
+                     return true;
+               }
+            }
+            else
+            {
+               total_weight += a.second;
+               if( total_weight >= auth.weight_threshold )
+                  return true;
+            }
+         }
+         return total_weight >= auth.weight_threshold;
+      }
+
+      /** true if any of the provided signatures was not needed by the checks made so far */
+      bool has_unused_signatures()const;
+
+   private:
+      const account_authority_object& get_account_authority( const account_name_type& account );
+      bool                            signed_by( const public_key_type& key );
+      bool                            is_approved( const account_name_type& account )const;
+
+      typedef std::pair< public_key_type, bool > provided_signature;
+
+      const database&                                                     _db;
+      const flat_set< public_key_type >&                                  _signatures;
+      uint32_t                                                            _max_recursion;
+
+      /// sorted by key, the flag records whether the signature was used
+      boost::container::small_vector< provided_signature, 2 >             _provided_signatures;
+      boost::container::small_vector< account_name_type, 2 >              _approved_by;
+      /// accounts looked up so far during this check
+      boost::container::small_vector< const account_authority_object*, 2 > _accounts;
+};
+
+} } // sophiatx::chain
@@ -0,0 +1,233 @@
+#pragma once
+#include <fc/container/flat.hpp>
+#include <fc/reflect/reflect.hpp>
+#include <fc/time.hpp>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sophiatx { namespace chain {
+
+   /** Parts of database::_apply_block that are timed separately */
+   enum class block_phase : uint8_t
+   {
+      apply_block,
+      validate_header,
+      /// _apply_transaction of the block transactions, including their evaluators
+      transactions,
+      evaluators,
+      update_global_dynamic_data,
+      update_signing_witness,
+      update_last_irreversible_block,
+      /// committing the undo history of blocks that became irreversible, part of update_last_irreversible_block
+      undo_commit,
+      create_block_summary,
+      clear_expired_transactions,
+      update_witness_schedule,
+      process_interests,
+      update_median_feeds,
+      clear_null_account_balance,
+      process_funds,
+      process_vesting_withdrawals,
+      account_recovery_processing,
+      expire_escrow_ratification,
+      process_hardforks,
+      notify_applied_block,
+      notify_changed_objects,
+      record_block,
+      state_digest,
+      phase_count
+   };
+
+} } // sophiatx::chain
+
+// reflected before block_profiler, which reports phases by name
+FC_REFLECT_ENUM( sophiatx::chain::block_phase,
+                 (apply_block)(validate_header)(transactions)(evaluators)(update_global_dynamic_data)
+                 (update_signing_witness)(update_last_irreversible_block)(undo_commit)(create_block_summary)
+                 (clear_expired_transactions)(update_witness_schedule)(process_interests)(update_median_feeds)
+                 (clear_null_account_balance)(process_funds)(process_vesting_withdrawals)
+                 (account_recovery_processing)(expire_escrow_ratification)(process_hardforks)
+                 (notify_applied_block)(notify_changed_objects)(record_block)(state_digest)(phase_count) )
+
+namespace sophiatx { namespace chain {
+
+   /** Accumulated wall time of one phase or operation type, in microseconds */
+   struct phase_timing
+   {
+      uint64_t count = 0;
+      uint64_t total_us = 0;
+      uint64_t max_us = 0;
+   };
+
+   struct block_profile
+   {
+      bool                                      enabled = false;
+      uint64_t                                  blocks = 0;
+      fc::flat_map< std::string, phase_timing > phases;
+      /// time spent in the evaluator of each operation type
+      fc::flat_map< std::string, phase_timing > operations;
+      /// time spent in the signal handlers of each plugin, by plugin and signal name
+      fc::flat_map< std::string, fc::flat_map< std::string, phase_timing > > handlers;
+   };
+
+   /** Time stamp counter where available, a steady clock otherwise.  Only differences of ticks are meaningful. */
+   uint64_t profile_ticks();
+
+   struct phase_ticks
+   {
+      uint64_t count = 0;
+      uint64_t total = 0;
+      uint64_t max = 0;
+
+      void record( uint64_t ticks )
+      {
+         ++count;
+         total += ticks;
+         max = std::max( max, ticks );
+      }
+   };
+
+   /**
+    *  Collects the time of the phases of applying blocks, of each operation type and of each plugin signal handler.
+    *  Disabled it costs a branch per phase.  Only blocks being applied are measured, transactions applied to the
+    *  pending state are not.  Ticks are converted to microseconds against the wall clock time elapsed since
+    *  profiling was enabled.
+    */
+   class block_profiler
+   {
+      public:
+         void set_enabled( bool enabled )
+         {
+            if( enabled && !_enabled )
+               reset();
+            _enabled = enabled;
+         }
+
+         bool enabled()const { return _enabled; }
+
+         void reset()
+         {
+            _phases = std::vector< phase_ticks >( size_t( block_phase::phase_count ) );
+            _operations.clear();
+            _handlers.assign( _handler_names.size(), phase_ticks() );
+            _start_ticks = profile_ticks();
+            _start_time = fc::time_point::now();
+         }
+
+         /// measure until end_block(), if profiling is enabled
+         void begin_block() { _active = _enabled; }
+         void end_block() { _active = false; }
+
+         phase_ticks* phase( block_phase p )
+         {
+            return _active ? &_phases[ size_t( p ) ] : nullptr;
+         }
+
+         phase_ticks* operation( int64_t which )
+         {
+            if( !_active )
+               return nullptr;
+            if( _operations.size() <= size_t( which ) )
+               _operations.resize( which + 1 );
+            return &_operations[ which ];
+         }
+
+         /// registers a plugin signal handler, returns the id to pass to handler()
+         size_t add_handler( const std::string& plugin_name, const std::string& signal_name )
+         {
+            _handler_names.emplace_back( plugin_name, signal_name );
+            _handlers.resize( _handler_names.size() );
+            return _handler_names.size() - 1;
+         }
+
+         phase_ticks* handler( size_t id )
+         {
+            return _active ? &_handlers[ id ] : nullptr;
+         }
+
+         /// operation_names[i] is the name of the operation with tag i
+         block_profile report( const std::vector< std::string >& operation_names )const
+         {
+            block_profile result;
+            result.enabled = _enabled;
+            if( _phases.empty() )
+               return result;
+
+            const uint64_t elapsed_us = std::max< int64_t >( ( fc::time_point::now() - _start_time ).count(), 1 );
+            const double ticks_per_us = std::max( double( profile_ticks() - _start_ticks ) / elapsed_us, 1e-9 );
+            auto to_timing = [ticks_per_us]( const phase_ticks& t )
+            {
+               phase_timing timing;
+               timing.count = t.count;
+               timing.total_us = uint64_t( t.total / ticks_per_us );
+               timing.max_us = uint64_t( t.max / ticks_per_us );
+               return timing;
+            };
+
+            result.blocks = _phases[ size_t( block_phase::apply_block ) ].count;
+            for( size_t p = 0; p < _phases.size(); ++p )
+               result.phases[ fc::reflector< block_phase >::to_string( block_phase( p ) ) ] = to_timing( _phases[p] );
+            for( size_t op = 0; op < _operations.size() && op < operation_names.size(); ++op )
+               if( _operations[op].count )
+                  result.operations[ operation_names[op] ] = to_timing( _operations[op] );
+            for( size_t h = 0; h < _handlers.size(); ++h )
+            {
+               if( !_handlers[h].count )
+                  continue;
+               // a plugin connecting several handlers to one signal is reported once
+               phase_timing timing = to_timing( _handlers[h] );
+               phase_timing& total = result.handlers[ _handler_names[h].first ][ _handler_names[h].second ];
+               total.count += timing.count;
+               total.total_us += timing.total_us;
+               total.max_us = std::max( total.max_us, timing.max_us );
+            }
+            return result;
+         }
+
+      private:
+         bool                       _enabled = false;
+         bool                       _active = false;
+         std::vector< phase_ticks > _phases;
+         std::vector< phase_ticks > _operations;
+         std::vector< phase_ticks > _handlers;
+         std::vector< std::pair< std::string, std::string > > _handler_names;
+         uint64_t                   _start_ticks = 0;
+         fc::time_point             _start_time;
+   };
+
+   /** Records the ticks until it goes out of scope into each of the given timings that is not null */
+   class scoped_phase_timer
+   {
+      public:
+         explicit scoped_phase_timer( phase_ticks* timing, phase_ticks* detail = nullptr )
+            : _timing( timing ), _detail( detail )
+         {
+            if( _timing || _detail )
+               _start = profile_ticks();
+         }
+
+         ~scoped_phase_timer()
+         {
+            if( _timing || _detail )
+            {
+               uint64_t ticks = profile_ticks() - _start;
+               if( _timing )
+                  _timing->record( ticks );
+               if( _detail )
+                  _detail->record( ticks );
+            }
+         }
+
+      private:
+         phase_ticks*   _timing;
+         phase_ticks*   _detail;
+         uint64_t       _start = 0;
+   };
+
+} } // sophiatx::chain
+
+FC_REFLECT( sophiatx::chain::phase_timing, (count)(total_us)(max_us) )
+FC_REFLECT( sophiatx::chain::block_profile, (enabled)(blocks)(phases)(operations)(handlers) )
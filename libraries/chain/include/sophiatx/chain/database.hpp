@@ -10,6 +10,10 @@
 #include <sophiatx/chain/operation_notification.hpp>
 #include <sophiatx/chain/util/signal.hpp>
 #include <sophiatx/chain/economics.hpp>
+#include <sophiatx/chain/pending_transaction_pool.hpp>
+#include <sophiatx/chain/transaction_prevalidator.hpp>
+#include <sophiatx/chain/block_profile.hpp>
+#include <sophiatx/chain/state_digest.hpp>
 
 #include <sophiatx/protocol/protocol.hpp>
 #include <sophiatx/protocol/hardfork.hpp>
@@ -19,6 +23,8 @@
 
 #include <fc/log/logger.hpp>
 
+#include <deque>
+#include <functional>
 #include <map>
 
 namespace sophiatx { namespace chain {
@@ -85,6 +91,9 @@ namespace sophiatx { namespace chain {
             // The following fields are only used on reindexing
             uint32_t stop_replay_at = 0;
             TBenchmark benchmark = TBenchmark(0, []( uint32_t, const abstract_index_cntr_t& ){});
+            /// JSON lines written every replay_report_interval blocks, see replay_reporter
+            fc::path replay_report;
+            uint32_t replay_report_interval = 0;
          };
 
          /**
@@ -186,7 +195,8 @@ namespace sophiatx { namespace chain {
          signed_block _generate_block(
             const fc::time_point_sec when,
             const account_name_type& witness_owner,
-            const fc::ecc::private_key& block_signing_private_key
+            const fc::ecc::private_key& block_signing_private_key,
+            bool reuse_pending_state = true
             );
 
          void pop_block();
@@ -240,6 +250,23 @@ namespace sophiatx { namespace chain {
           */
          fc::signal<void(const signed_transaction&)>     on_applied_transaction;
 
+         typedef std::function< void( const operation_notification& ) >   apply_operation_handler_t;
+         typedef std::function< void( const signed_block& ) >             applied_block_handler_t;
+         typedef std::function< void( const signed_transaction& ) >       apply_transaction_handler_t;
+
+         /**
+          *  Connect a plugin to pre_apply_operation, post_apply_operation, applied_block or
+          *  on_pre_apply_transaction.  The handler is timed under the plugin name by the block profiler and
+          *  checked against the plugin handler budget.  A negative group connects at the back of the signal.
+          */
+         boost::signals2::connection add_pre_apply_operation_handler( const apply_operation_handler_t& func, const std::string& plugin_name, int32_t group = -1 );
+         boost::signals2::connection add_post_apply_operation_handler( const apply_operation_handler_t& func, const std::string& plugin_name, int32_t group = -1 );
+         boost::signals2::connection add_applied_block_handler( const applied_block_handler_t& func, const std::string& plugin_name, int32_t group = -1 );
+         boost::signals2::connection add_pre_apply_transaction_handler( const apply_transaction_handler_t& func, const std::string& plugin_name, int32_t group = -1 );
+
+         /** Log a warning whenever a plugin signal handler runs longer than budget.  0 disables it. */
+         void set_plugin_handler_budget( fc::microseconds budget ) { _plugin_handler_budget = budget; }
+
          /**
           *  Emitted After a block has been applied and committed.  The callback
           *  should not yield and should execute quickly.
@@ -371,7 +398,41 @@ namespace sophiatx { namespace chain {
          /** when popping a block, the transactions that were removed get cached here so they
           * can be reapplied at the proper time */
          std::deque< signed_transaction >       _popped_tx;
-         vector< signed_transaction >           _pending_tx;
+         pending_transaction_pool               _pending_tx;
+
+         const pending_transaction_pool& get_pending_transactions()const { return _pending_tx; }
+         /** limits of 0 are unlimited, see pending_transaction_pool */
+         void set_pending_transaction_limits( uint32_t max_transactions, uint32_t max_transactions_per_account );
+
+         /**
+          *  Keep the body of transactions included in blocks until they expire, so get_recent_transaction()
+          *  can serve them after they left the pending pool.  Off by default, only the id and expiration
+          *  needed for duplicate detection are stored.
+          */
+         void set_store_recent_transactions( bool store );
+
+         /** number of threads checking block transactions before they are applied, 0 disables it */
+         void set_prevalidation_threads( uint32_t threads );
+
+         /** Time the phases of applying blocks, each operation type and plugin handler, see block_profiler.  Off by default. */
+         void set_block_profiling( bool enabled ) { _block_profiler.set_enabled( enabled ); }
+         block_profile get_block_profile()const;
+         void reset_block_profile() { _block_profiler.reset(); }
+
+         /**
+          *  Maintain a digest of the consensus indexes and keep the state digest of the last `blocks` applied
+          *  blocks.  0 disables it.  Takes effect when the database is opened, which recomputes the digests.
+          */
+         void set_state_digest_history( uint32_t blocks ) { _state_digest_history = blocks; }
+         uint32_t get_state_digest_history()const { return _state_digest_history; }
+
+         /** Include the index in the state digest, done by add_core_index() */
+         void add_state_digest_index( uint16_t type_id ) { _state_digest_type_ids.insert( type_id ); }
+
+         /** digest of the current state, including pending transactions */
+         state_digest compute_state_digest()const;
+         /** digest of the state right after the block was applied, if it is among the last blocks kept */
+         optional< state_digest > find_state_digest( uint32_t block_num )const;
 
       void retally_witness_votes();
 
@@ -381,7 +442,15 @@ namespace sophiatx { namespace chain {
             with id N, applies all hardforks with id <= N */
          void set_hardfork( uint32_t hardfork, bool process_now = true );
 
+         /**
+          *  Checks the supply invariants against the totals the account and escrow indexes maintain, without
+          *  scanning them.  Runs after every block.
+          */
          void validate_invariants()const;
+         /** Recomputes the totals by scanning all accounts and escrows, then validates the invariants */
+         void audit_invariants()const;
+         /** run audit_invariants() every `blocks` blocks, 0 only audits on open with do_validate_invariants */
+         void set_invariant_audit_interval( uint32_t blocks );
          /**
           * @}
           */
@@ -419,6 +488,8 @@ namespace sophiatx { namespace chain {
 
          asset process_operation_fee( const operation& op);
          account_name_type get_fee_payer(const operation& op);
+         /// total fee the operations of trx pay, in SPHTX
+         share_type get_transaction_fee( const signed_transaction& trx )const;
          optional<account_name_type> get_sponsor(const account_name_type& who) const;
 
          time_point_sec get_genesis_time()const;
@@ -430,6 +501,28 @@ namespace sophiatx { namespace chain {
 
       private:
          optional< chainbase::database::session > _pending_tx_session;
+         /// true while _pending_tx_session holds exactly the changes made by applying _pending_tx in arrival order
+         bool                                     _pending_tx_state_reusable = false;
+         /// union of the skip flags the transactions in _pending_tx_session were applied with
+         uint32_t                                 _pending_tx_skip_flags = 0;
+         /// evicted from _pending_tx while their changes and dedup entries are still in _pending_tx_session
+         flat_set< transaction_id_type >          _evicted_pending_tx;
+         bool                                     _store_recent_transactions = false;
+         uint32_t                                 _invariant_audit_interval = 0;
+         transaction_prevalidator                 _prevalidator;
+         /// prevalidation results of the block transaction being applied, if any
+         const prevalidated_transaction*          _current_prevalidated = nullptr;
+         block_profiler                           _block_profiler;
+         fc::microseconds                         _plugin_handler_budget;
+         uint32_t                                 _state_digest_history = 0;
+         flat_set< uint16_t >                     _state_digest_type_ids;
+         std::deque< state_digest >               _state_digests;
+
+         void enable_state_digest();
+
+         template< typename Signal, typename Handler >
+         boost::signals2::connection connect_plugin_handler( Signal& signal, const Handler& func, const std::string& plugin_name,
+            const char* signal_name, int32_t group );
 
          void apply_block( const signed_block& next_block, uint32_t skip = skip_nothing );
          void apply_transaction( const signed_transaction& trx, uint32_t skip = skip_nothing );
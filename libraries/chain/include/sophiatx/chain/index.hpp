@@ -12,6 +12,14 @@ void _add_index_impl( database& db )
 
 template< typename MultiIndexType >
 void add_core_index( database& db )
+{
+   _add_index_impl< MultiIndexType >(db);
+   db.add_state_digest_index( MultiIndexType::value_type::type_id );
+}
+
+/// A core index whose contents depend on node configuration or plugins, it is left out of the state digest
+template< typename MultiIndexType >
+void add_local_core_index( database& db )
 {
    _add_index_impl< MultiIndexType >(db);
 }
@@ -0,0 +1,131 @@
+#pragma once
+#include <sophiatx/protocol/transaction.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+
+namespace sophiatx { namespace chain {
+
+   using sophiatx::protocol::signed_transaction;
+   using sophiatx::protocol::transaction_id_type;
+   using sophiatx::protocol::account_name_type;
+   using sophiatx::protocol::share_type;
+
+   struct pending_transaction
+   {
+      signed_transaction   trx;
+      transaction_id_type  id;
+      /// arrival order, which is the order the pending state was built in
+      uint64_t             sequence = 0;
+      fc::time_point_sec   expiration;
+      /// fee payer of the first operation, after sponsorship
+      account_name_type    fee_payer;
+      /// total fee in SPHTX
+      share_type           fee = 0;
+      uint32_t             packed_size = 0;
+      uint64_t             fee_per_kilobyte = 0;
+   };
+
+   /**
+    *  The transactions pushed to the database that are not in a block yet, indexed by arrival order, id,
+    *  expiration, fee payer and fee per byte.
+    *
+    *  The pool enforces an optional limit on the number of transactions, evicting the transaction paying the
+    *  lowest fee per byte when a better paying one arrives, and an optional limit on the number of transactions
+    *  paid for by a single account.  A limit of 0 means unlimited.
+    */
+   class pending_transaction_pool
+   {
+      public:
+         struct statistics
+         {
+            uint32_t size = 0;
+            uint64_t total_packed_size = 0;
+            uint32_t max_transactions = 0;
+            uint32_t max_transactions_per_account = 0;
+            uint64_t inserted = 0;
+            uint64_t evicted = 0;
+            uint64_t expired = 0;
+            uint64_t rejected = 0;
+         };
+
+         struct by_sequence;
+         struct by_id;
+         struct by_expiration;
+         struct by_fee_payer;
+         struct by_priority;
+
+         typedef boost::multi_index_container<
+            pending_transaction,
+            boost::multi_index::indexed_by<
+               boost::multi_index::ordered_unique< boost::multi_index::tag< by_sequence >,
+                  boost::multi_index::member< pending_transaction, uint64_t, &pending_transaction::sequence > >,
+               boost::multi_index::hashed_unique< boost::multi_index::tag< by_id >,
+                  boost::multi_index::member< pending_transaction, transaction_id_type, &pending_transaction::id >, std::hash< fc::ripemd160 > >,
+               boost::multi_index::ordered_non_unique< boost::multi_index::tag< by_expiration >,
+                  boost::multi_index::member< pending_transaction, fc::time_point_sec, &pending_transaction::expiration > >,
+               boost::multi_index::ordered_unique< boost::multi_index::tag< by_fee_payer >,
+                  boost::multi_index::composite_key< pending_transaction,
+                     boost::multi_index::member< pending_transaction, account_name_type, &pending_transaction::fee_payer >,
+                     boost::multi_index::member< pending_transaction, uint64_t, &pending_transaction::sequence >
+                  >
+               >,
+               boost::multi_index::ordered_unique< boost::multi_index::tag< by_priority >,
+                  boost::multi_index::composite_key< pending_transaction,
+                     boost::multi_index::member< pending_transaction, uint64_t, &pending_transaction::fee_per_kilobyte >,
+                     boost::multi_index::member< pending_transaction, uint64_t, &pending_transaction::sequence >
+                  >,
+                  boost::multi_index::composite_key_compare< std::greater< uint64_t >, std::less< uint64_t > >
+               >
+            >
+         > index_type;
+
+         void set_limits( uint32_t max_transactions, uint32_t max_transactions_per_account );
+
+         /**
+          *  Checks that a transaction paid for by fee_payer may enter the pool and throws if it may not.
+          *
+          *  @return the transaction to evict once the new one is inserted, or nullptr if there is room for it
+          */
+         const pending_transaction* check_admission( const account_name_type& fee_payer, share_type fee, uint32_t packed_size );
+
+         const pending_transaction& insert( const signed_transaction& trx, const transaction_id_type& id,
+                                            const account_name_type& fee_payer, share_type fee, uint32_t packed_size );
+         void erase( const pending_transaction& tx );
+
+         /** removes transactions that expire before now, returns the number removed */
+         uint32_t remove_expired( fc::time_point_sec now );
+
+         /** empties the pool, returning its transactions in arrival order */
+         std::vector< signed_transaction > release();
+         void clear();
+
+         const pending_transaction* find( const transaction_id_type& id )const;
+         uint32_t count_for_fee_payer( const account_name_type& fee_payer )const;
+
+         template< typename IndexTag >
+         const typename index_type::template index< IndexTag >::type& get()const { return _transactions.template get< IndexTag >(); }
+
+         size_t     size()const  { return _transactions.size(); }
+         bool       empty()const { return _transactions.empty(); }
+         statistics get_statistics()const;
+
+         static uint64_t compute_fee_per_kilobyte( share_type fee, uint32_t packed_size );
+
+      private:
+         index_type _transactions;
+         uint64_t   _next_sequence = 0;
+         uint64_t   _total_packed_size = 0;
+         uint32_t   _max_transactions = 0;
+         uint32_t   _max_transactions_per_account = 0;
+         statistics _statistics;
+   };
+
+} } // sophiatx::chain
+
+FC_REFLECT( sophiatx::chain::pending_transaction, (trx)(id)(sequence)(expiration)(fee_payer)(fee)(packed_size)(fee_per_kilobyte) )
+FC_REFLECT( sophiatx::chain::pending_transaction_pool::statistics,
+            (size)(total_packed_size)(max_transactions)(max_transactions_per_account)(inserted)(evicted)(expired)(rejected) )
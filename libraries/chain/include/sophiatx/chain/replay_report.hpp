@@ -0,0 +1,80 @@
+#pragma once
+#include <fc/filesystem.hpp>
+#include <fc/reflect/reflect.hpp>
+#include <fc/time.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace sophiatx { namespace chain {
+
+   class database;
+
+   /** Objects and shared memory held by one index when a replay report line was written */
+   struct replay_index_statistics
+   {
+      std::string name;
+      uint64_t    count = 0;
+      uint64_t    bytes = 0;
+      /// bytes added since the previous line
+      int64_t     growth = 0;
+   };
+
+   /** One line of the replay report, covering the blocks applied since the previous line */
+   struct replay_report_line
+   {
+      uint32_t                                  block_num = 0;
+      /// since the replay started
+      uint64_t                                  elapsed_ms = 0;
+      uint32_t                                  blocks = 0;
+      uint64_t                                  operations = 0;
+      double                                    blocks_per_sec = 0;
+      double                                    operations_per_sec = 0;
+      uint64_t                                  block_log_read_us = 0;
+      uint64_t                                  apply_us = 0;
+      uint64_t                                  undo_commit_us = 0;
+      uint64_t                                  free_memory_mb = 0;
+      std::vector< replay_index_statistics >    indices;
+   };
+
+   /**
+    *  Writes a JSON line with the replay throughput and the size of every index each `interval` blocks of
+    *  database::reindex.  Undo and commit time is taken from the block profiler, which is enabled for the
+    *  duration of the replay if it was not already.
+    */
+   class replay_reporter
+   {
+      public:
+         /// an empty file disables the report
+         replay_reporter( database& db, const fc::path& file, uint32_t interval );
+         ~replay_reporter();
+
+         bool enabled()const { return _out.is_open(); }
+
+         void record_read( const fc::microseconds& elapsed ) { _line.block_log_read_us += elapsed.count(); }
+         void record_apply( uint32_t block_num, uint32_t operations, const fc::microseconds& elapsed );
+
+         /// writes the line of the blocks applied since the last one, if any
+         void flush( uint32_t block_num );
+
+      private:
+         uint64_t undo_commit_total_us()const;
+
+         database&               _db;
+         std::ofstream           _out;
+         uint32_t                _interval = 0;
+         bool                    _enabled_profiling = false;
+         fc::time_point          _start;
+         fc::time_point          _line_start;
+         uint64_t                _last_undo_commit_us = 0;
+         std::vector< uint64_t > _last_index_bytes;
+         replay_report_line      _line;
+   };
+
+} } // sophiatx::chain
+
+FC_REFLECT( sophiatx::chain::replay_index_statistics, (name)(count)(bytes)(growth) )
+FC_REFLECT( sophiatx::chain::replay_report_line,
+            (block_num)(elapsed_ms)(blocks)(operations)(blocks_per_sec)(operations_per_sec)
+            (block_log_read_us)(apply_us)(undo_commit_us)(free_memory_mb)(indices) )
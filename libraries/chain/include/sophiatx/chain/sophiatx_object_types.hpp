@@ -57,6 +57,7 @@ enum object_type
    application_object_type,
    account_fee_sponsor_object_type,
    application_buying_object_type,
+   transaction_body_object_type,
 #ifdef SOPHIATX_ENABLE_SMT
    // SMT objects
    smt_token_object_type,
@@ -70,6 +71,7 @@ class account_object;
 class account_authority_object;
 class witness_object;
 class transaction_object;
+class transaction_body_object;
 class block_summary_object;
 class witness_schedule_object;
 class witness_vote_object;
@@ -117,6 +119,7 @@ typedef oid< custom_content_object                  > custom_content_id_type;
 typedef oid< application_object                     > application_id_type;
 typedef oid< account_fee_sponsor_object             > account_fee_sponsor_id_type;
 typedef oid< application_buying_object              > application_buying_id_type;
+typedef oid< transaction_body_object                > transaction_body_object_id_type;
 
 #ifdef SOPHIATX_ENABLE_SMT
 typedef oid< smt_token_object                       > smt_token_id_type;
@@ -195,6 +198,7 @@ FC_REFLECT_ENUM( sophiatx::chain::object_type,
                  (application_object_type)
                  (account_fee_sponsor_object_type)
                  (application_buying_object_type)
+                 (transaction_body_object_type)
                )
 
 FC_REFLECT_TYPENAME( sophiatx::chain::shared_string )
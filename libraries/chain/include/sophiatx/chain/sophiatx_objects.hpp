@@ -124,3 +124,38 @@ FC_REFLECT( sophiatx::chain::escrow_object,
              (to_approved)(agent_approved)(disputed) )
 CHAINBASE_SET_INDEX_TYPE( sophiatx::chain::escrow_object, sophiatx::chain::escrow_index )
 
+namespace helpers
+{
+   /// Totals checked by database::validate_invariants() without scanning all escrows
+   template<>
+   class index_aggregate_provider< sophiatx::chain::escrow_object >
+   {
+   public:
+      struct aggregate_type
+      {
+         sophiatx::chain::share_type sophiatx_balance;
+         sophiatx::chain::share_type pending_fee;
+         /// escrows with a fee in another asset, there should be none
+         int64_t                     other_fee_count = 0;
+      };
+
+      static void add( aggregate_type& t, const sophiatx::chain::escrow_object& e )
+      {
+         t.sophiatx_balance += e.sophiatx_balance.amount;
+         if( e.pending_fee.symbol == SOPHIATX_SYMBOL )
+            t.pending_fee += e.pending_fee.amount;
+         else
+            ++t.other_fee_count;
+      }
+
+      static void subtract( aggregate_type& t, const sophiatx::chain::escrow_object& e )
+      {
+         t.sophiatx_balance -= e.sophiatx_balance.amount;
+         if( e.pending_fee.symbol == SOPHIATX_SYMBOL )
+            t.pending_fee -= e.pending_fee.amount;
+         else
+            --t.other_fee_count;
+      }
+   };
+}
+
@@ -0,0 +1,152 @@
+#pragma once
+#include <sophiatx/chain/sophiatx_object_types.hpp>
+
+#include <fc/crypto/sha256.hpp>
+#include <fc/io/raw.hpp>
+
+#include <boost/interprocess/containers/vector.hpp>
+
+#include <type_traits>
+
+namespace sophiatx { namespace chain {
+
+   /** Digest of the objects of one index, as maintained by chainbase */
+   struct index_digest
+   {
+      uint16_t    type_id = 0;
+      uint64_t    size = 0;
+      uint64_t    digest = 0;
+   };
+
+   /**
+    *  Digest of the consensus state after a block was applied.  Two nodes that applied the same blocks have the
+    *  same digest, if they don't, the index digests tell which objects diverged.
+    */
+   struct state_digest
+   {
+      uint32_t                    block_num = 0;
+      block_id_type               block_id;
+      fc::sha256                  digest;
+      std::vector< index_digest > indices;
+   };
+
+   namespace detail {
+
+      typedef fc::sha256::encoder digest_encoder;
+
+      /*
+       * Objects are digested member by member.  Members that are reflected structs are visited the same way, so
+       * structs holding interprocess containers are digested like the containers, everything else is packed.
+       */
+      template< typename T >
+      void digest_append( digest_encoder& enc, const T& v );
+
+      template< typename T, typename... A >
+      void digest_append( digest_encoder& enc, const bip::vector< T, A... >& v );
+
+      template< typename T, typename... A >
+      void digest_append( digest_encoder& enc, const bip::deque< T, A... >& v );
+
+      template< typename K, typename V, typename... A >
+      void digest_append( digest_encoder& enc, const bip::flat_map< K, V, A... >& v );
+
+      inline void digest_append( digest_encoder& enc, const shared_string& s )
+      {
+         fc::raw::pack( enc, fc::unsigned_int( s.size() ) );
+         enc.write( s.data(), s.size() );
+      }
+
+      template< typename T >
+      struct digest_member_visitor
+      {
+         digest_member_visitor( digest_encoder& e, const T& o ) : enc( e ), obj( o ) {}
+
+         template< typename Member, class Class, Member (Class::*member) >
+         void operator()( const char* )const
+         {
+            digest_append( enc, obj.*member );
+         }
+
+         digest_encoder&   enc;
+         const T&          obj;
+      };
+
+      template< typename T >
+      struct is_digested_by_member : std::integral_constant< bool,
+         fc::reflector< T >::is_defined::value != 0 && !std::is_enum< T >::value > {};
+
+      template< typename T >
+      void digest_append_impl( digest_encoder& enc, const T& v, std::true_type )
+      {
+         fc::reflector< T >::visit( digest_member_visitor< T >( enc, v ) );
+      }
+
+      template< typename T >
+      void digest_append_impl( digest_encoder& enc, const T& v, std::false_type )
+      {
+         fc::raw::pack( enc, v );
+      }
+
+      template< typename T >
+      void digest_append( digest_encoder& enc, const T& v )
+      {
+         digest_append_impl( enc, v, std::integral_constant< bool, is_digested_by_member< T >::value >() );
+      }
+
+      template< typename Container >
+      void digest_append_sequence( digest_encoder& enc, const Container& c )
+      {
+         fc::raw::pack( enc, fc::unsigned_int( c.size() ) );
+         for( const auto& item : c )
+            digest_append( enc, item );
+      }
+
+      template< typename T, typename... A >
+      void digest_append( digest_encoder& enc, const bip::vector< T, A... >& v )
+      {
+         digest_append_sequence( enc, v );
+      }
+
+      template< typename T, typename... A >
+      void digest_append( digest_encoder& enc, const bip::deque< T, A... >& v )
+      {
+         digest_append_sequence( enc, v );
+      }
+
+      template< typename K, typename V, typename... A >
+      void digest_append( digest_encoder& enc, const bip::flat_map< K, V, A... >& v )
+      {
+         fc::raw::pack( enc, fc::unsigned_int( v.size() ) );
+         for( const auto& item : v )
+         {
+            digest_append( enc, item.first );
+            digest_append( enc, item.second );
+         }
+      }
+
+      template< typename T >
+      uint64_t object_digest( const T& obj )
+      {
+         digest_encoder enc;
+         digest_append( enc, obj );
+         return enc.result()._hash[0];
+      }
+
+   } // detail
+
+} } // sophiatx::chain
+
+namespace helpers
+{
+   /// Every reflected object can be digested, chainbase only maintains the digest of indexes it is enabled for
+   template< typename ValueType >
+   class object_digest_provider< ValueType, typename std::enable_if< fc::reflector< ValueType >::is_defined::value != 0 >::type >
+   {
+   public:
+      static const bool enabled = true;
+      static uint64_t digest( const ValueType& obj ) { return sophiatx::chain::detail::object_digest( obj ); }
+   };
+}
+
+FC_REFLECT( sophiatx::chain::index_digest, (type_id)(size)(digest) )
+FC_REFLECT( sophiatx::chain::state_digest, (block_num)(block_id)(digest)(indices) )
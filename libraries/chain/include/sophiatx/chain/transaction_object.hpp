@@ -14,6 +14,9 @@ namespace sophiatx { namespace chain {
     * The purpose of this object is to enable the detection of duplicate transactions. When a transaction is included
     * in a block a transaction_object is added. At the end of block processing all transaction_objects that have
     * expired can be removed from the index.
+    *
+    * Only the id and expiration are kept, the transaction itself is stored in a transaction_body_object when the
+    * node is configured to serve recent transactions.
     */
    class transaction_object : public object< transaction_object_type, transaction_object >
    {
@@ -22,16 +25,12 @@ namespace sophiatx { namespace chain {
       public:
          template< typename Constructor, typename Allocator >
          transaction_object( Constructor&& c, allocator< Allocator > a )
-            : packed_trx( a )
          {
             c( *this );
          }
 
          id_type              id;
 
-         typedef buffer_type t_packed_trx;
-
-         t_packed_trx         packed_trx;
          transaction_id_type  trx_id;
          time_point_sec       expiration;
    };
@@ -48,19 +47,58 @@ namespace sophiatx { namespace chain {
       allocator< transaction_object >
    > transaction_index;
 
+   /**
+    * The packed body of a transaction included in a recent block, kept until the transaction expires so that
+    * database::get_recent_transaction() can serve it.  Only maintained when enabled with
+    * database::set_store_recent_transactions().
+    */
+   class transaction_body_object : public object< transaction_body_object_type, transaction_body_object >
+   {
+      transaction_body_object() = delete;
+
+      public:
+         template< typename Constructor, typename Allocator >
+         transaction_body_object( Constructor&& c, allocator< Allocator > a )
+            : packed_trx( a )
+         {
+            c( *this );
+         }
+
+         id_type              id;
+
+         typedef buffer_type t_packed_trx;
+
+         t_packed_trx         packed_trx;
+         transaction_id_type  trx_id;
+         time_point_sec       expiration;
+   };
+
+   typedef multi_index_container<
+      transaction_body_object,
+      indexed_by<
+         ordered_unique< tag< by_id >, member< transaction_body_object, transaction_body_object_id_type, &transaction_body_object::id > >,
+         hashed_unique< tag< by_trx_id >, BOOST_MULTI_INDEX_MEMBER(transaction_body_object, transaction_id_type, trx_id), std::hash<transaction_id_type> >,
+         ordered_non_unique< tag< by_expiration >, member<transaction_body_object, time_point_sec, &transaction_body_object::expiration > >
+      >,
+      allocator< transaction_body_object >
+   > transaction_body_index;
+
 } } // sophiatx::chain
 
-FC_REFLECT( sophiatx::chain::transaction_object, (id)(packed_trx)(trx_id)(expiration) )
+FC_REFLECT( sophiatx::chain::transaction_object, (id)(trx_id)(expiration) )
 CHAINBASE_SET_INDEX_TYPE( sophiatx::chain::transaction_object, sophiatx::chain::transaction_index )
 
+FC_REFLECT( sophiatx::chain::transaction_body_object, (id)(packed_trx)(trx_id)(expiration) )
+CHAINBASE_SET_INDEX_TYPE( sophiatx::chain::transaction_body_object, sophiatx::chain::transaction_body_index )
+
 namespace helpers
 {
    template <>
-   class index_statistic_provider<sophiatx::chain::transaction_index>
+   class index_statistic_provider<sophiatx::chain::transaction_body_index>
    {
    public:
-      typedef sophiatx::chain::transaction_index IndexType;
-      typedef typename sophiatx::chain::transaction_object::t_packed_trx t_packed_trx;
+      typedef sophiatx::chain::transaction_body_index IndexType;
+      typedef typename sophiatx::chain::transaction_body_object::t_packed_trx t_packed_trx;
 
       index_statistic_info gather_statistics(const IndexType& index, bool onlyStaticInfo) const
       {
@@ -0,0 +1,58 @@
+#pragma once
+#include <sophiatx/protocol/transaction.hpp>
+
+#include <fc/thread/thread.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace sophiatx { namespace chain {
+
+   using sophiatx::protocol::signed_transaction;
+   using sophiatx::protocol::transaction_id_type;
+   using sophiatx::protocol::public_key_type;
+   using sophiatx::protocol::chain_id_type;
+
+   /**
+    *  Results of the state independent checks of a block transaction.  A flag is only set if the
+    *  corresponding step succeeded, a failed step is simply repeated when the transaction is applied so
+    *  that it fails with the same error, in the same order, as without prevalidation.
+    */
+   struct prevalidated_transaction
+   {
+      transaction_id_type           id;
+      flat_set< public_key_type >   signature_keys;
+      bool                          id_computed = false;
+      bool                          validated = false;
+      bool                          signatures_recovered = false;
+   };
+
+   /**
+    *  Runs signed_transaction::validate(), id computation and signature recovery for all transactions of a
+    *  block on a set of worker threads before the block is applied.  None of this reads the database, so it
+    *  can run while the applying thread holds the write lock.
+    *
+    *  Threads are started lazily.  With a size of zero prevalidation is disabled.
+    */
+   class transaction_prevalidator
+   {
+      public:
+         explicit transaction_prevalidator( uint32_t number_of_threads = 0 );
+         ~transaction_prevalidator();
+
+         void     resize( uint32_t number_of_threads );
+         uint32_t size()const { return _desired_size; }
+
+         std::vector< prevalidated_transaction > prevalidate( const std::vector< signed_transaction >& transactions,
+                                                              const chain_id_type& chain_id,
+                                                              bool validate, bool recover_signatures );
+
+      private:
+         void start_threads();
+         void quit();
+
+         std::vector< std::unique_ptr< fc::thread > > _threads;
+         uint32_t                                     _desired_size = 0;
+   };
+
+} } // sophiatx::chain
@@ -0,0 +1,120 @@
+#include <sophiatx/chain/pending_transaction_pool.hpp>
+
+#include <fc/exception/exception.hpp>
+
+namespace sophiatx { namespace chain {
+
+void pending_transaction_pool::set_limits( uint32_t max_transactions, uint32_t max_transactions_per_account )
+{
+   _max_transactions = max_transactions;
+   _max_transactions_per_account = max_transactions_per_account;
+}
+
+const pending_transaction* pending_transaction_pool::check_admission( const account_name_type& fee_payer, share_type fee, uint32_t packed_size )
+{
+   if( _max_transactions_per_account != 0 && count_for_fee_payer( fee_payer ) >= _max_transactions_per_account )
+   {
+      ++_statistics.rejected;
+      FC_ASSERT( false, "Account ${a} already pays for ${n} pending transactions", ("a", fee_payer)("n", _max_transactions_per_account) );
+   }
+
+   if( _max_transactions == 0 || _transactions.size() < _max_transactions )
+      return nullptr;
+
+   const pending_transaction& lowest = *_transactions.get< by_priority >().rbegin();
+   if( compute_fee_per_kilobyte( fee, packed_size ) <= lowest.fee_per_kilobyte )
+   {
+      ++_statistics.rejected;
+      FC_ASSERT( false, "Pending transaction pool is full and the transaction does not pay more than ${f} per kilobyte",
+                 ("f", lowest.fee_per_kilobyte) );
+   }
+   return &lowest;
+}
+
+const pending_transaction& pending_transaction_pool::insert( const signed_transaction& trx, const transaction_id_type& id,
+                                                             const account_name_type& fee_payer, share_type fee, uint32_t packed_size )
+{
+   pending_transaction tx;
+   tx.trx = trx;
+   tx.id = id;
+   tx.sequence = _next_sequence++;
+   tx.expiration = trx.expiration;
+   tx.fee_payer = fee_payer;
+   tx.fee = fee;
+   tx.packed_size = packed_size;
+   tx.fee_per_kilobyte = compute_fee_per_kilobyte( fee, packed_size );
+
+   auto result = _transactions.insert( std::move( tx ) );
+   FC_ASSERT( result.second, "Transaction ${id} is already pending", ("id", id) );
+
+   _total_packed_size += packed_size;
+   ++_statistics.inserted;
+   return *result.first;
+}
+
+void pending_transaction_pool::erase( const pending_transaction& tx )
+{
+   _total_packed_size -= tx.packed_size;
+   ++_statistics.evicted;
+   _transactions.erase( _transactions.iterator_to( tx ) );
+}
+
+uint32_t pending_transaction_pool::remove_expired( fc::time_point_sec now )
+{
+   auto& expiration_idx = _transactions.get< by_expiration >();
+   auto end = expiration_idx.lower_bound( now );
+   uint32_t removed = 0;
+   for( auto itr = expiration_idx.begin(); itr != end; ++itr, ++removed )
+      _total_packed_size -= itr->packed_size;
+   expiration_idx.erase( expiration_idx.begin(), end );
+   _statistics.expired += removed;
+   return removed;
+}
+
+std::vector< signed_transaction > pending_transaction_pool::release()
+{
+   std::vector< signed_transaction > result;
+   result.reserve( _transactions.size() );
+   for( const auto& tx : _transactions.get< by_sequence >() )
+      result.push_back( std::move( const_cast< pending_transaction& >( tx ).trx ) );
+   clear();
+   return result;
+}
+
+void pending_transaction_pool::clear()
+{
+   _transactions.clear();
+   _total_packed_size = 0;
+}
+
+const pending_transaction* pending_transaction_pool::find( const transaction_id_type& id )const
+{
+   const auto& id_idx = _transactions.get< by_id >();
+   auto itr = id_idx.find( id );
+   return itr == id_idx.end() ? nullptr : &*itr;
+}
+
+uint32_t pending_transaction_pool::count_for_fee_payer( const account_name_type& fee_payer )const
+{
+   auto range = _transactions.get< by_fee_payer >().equal_range( boost::make_tuple( fee_payer ) );
+   return uint32_t( std::distance( range.first, range.second ) );
+}
+
+pending_transaction_pool::statistics pending_transaction_pool::get_statistics()const
+{
+   statistics result = _statistics;
+   result.size = _transactions.size();
+   result.total_packed_size = _total_packed_size;
+   result.max_transactions = _max_transactions;
+   result.max_transactions_per_account = _max_transactions_per_account;
+   return result;
+}
+
+uint64_t pending_transaction_pool::compute_fee_per_kilobyte( share_type fee, uint32_t packed_size )
+{
+   if( fee.value <= 0 || packed_size == 0 )
+      return 0;
+   return uint64_t( fee.value ) * 1024 / packed_size;
+}
+
+} } // sophiatx::chain
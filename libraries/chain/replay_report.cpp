@@ -0,0 +1,93 @@
+#include <sophiatx/chain/replay_report.hpp>
+#include <sophiatx/chain/database.hpp>
+
+#include <fc/io/json.hpp>
+
+namespace sophiatx { namespace chain {
+
+replay_reporter::replay_reporter( database& db, const fc::path& file, uint32_t interval )
+   : _db( db ), _interval( interval )
+{
+   if( file == fc::path() || _interval == 0 )
+      return;
+
+   _out.open( file.string(), std::ios::out | std::ios::trunc );
+   FC_ASSERT( _out.is_open(), "Cannot open replay report ${f}", ("f", file) );
+
+   if( !_db.get_block_profile().enabled )
+   {
+      _db.set_block_profiling( true );
+      _enabled_profiling = true;
+   }
+   _last_undo_commit_us = undo_commit_total_us();
+   _start = _line_start = fc::time_point::now();
+}
+
+replay_reporter::~replay_reporter()
+{
+   if( _enabled_profiling )
+      _db.set_block_profiling( false );
+}
+
+void replay_reporter::record_apply( uint32_t block_num, uint32_t operations, const fc::microseconds& elapsed )
+{
+   if( !enabled() )
+      return;
+
+   ++_line.blocks;
+   _line.operations += operations;
+   _line.apply_us += elapsed.count();
+
+   if( block_num % _interval == 0 )
+      flush( block_num );
+}
+
+void replay_reporter::flush( uint32_t block_num )
+{
+   if( !enabled() || _line.blocks == 0 )
+      return;
+
+   const fc::time_point now = fc::time_point::now();
+   const double line_sec = std::max< int64_t >( ( now - _line_start ).count(), 1 ) / 1000000.0;
+
+   _line.block_num = block_num;
+   _line.elapsed_ms = ( now - _start ).count() / 1000;
+   _line.blocks_per_sec = _line.blocks / line_sec;
+   _line.operations_per_sec = _line.operations / line_sec;
+   _line.free_memory_mb = _db.get_free_memory() / ( 1024 * 1024 );
+
+   const uint64_t undo_commit_us = undo_commit_total_us();
+   // ticks are converted with the calibration at the time of the report, which may drift slightly
+   _line.undo_commit_us = undo_commit_us > _last_undo_commit_us ? undo_commit_us - _last_undo_commit_us : 0;
+   _last_undo_commit_us = undo_commit_us;
+
+   const auto& indices = _db.get_abstract_index_cntr();
+   _last_index_bytes.resize( indices.size() );
+   for( size_t i = 0; i < indices.size(); ++i )
+   {
+      auto info = indices[i]->get_statistics( true );
+      replay_index_statistics stats;
+      stats.name = std::move( info._value_type_name );
+      stats.count = info._item_count;
+      stats.bytes = info._item_count * info._item_sizeof + info._item_additional_allocation + info._additional_container_allocation;
+      stats.growth = int64_t( stats.bytes ) - int64_t( _last_index_bytes[i] );
+      _last_index_bytes[i] = stats.bytes;
+      _line.indices.push_back( std::move( stats ) );
+   }
+
+   _out << fc::json::to_string( _line ) << '\n';
+   _out.flush();
+
+   _line = replay_report_line();
+   // writing the line is not charged to the next one
+   _line_start = fc::time_point::now();
+}
+
+uint64_t replay_reporter::undo_commit_total_us()const
+{
+   const auto profile = _db.get_block_profile();
+   auto itr = profile.phases.find( "undo_commit" );
+   return itr == profile.phases.end() ? 0 : itr->second.total_us;
+}
+
+} } // sophiatx::chain
@@ -0,0 +1,98 @@
+#include <sophiatx/chain/transaction_prevalidator.hpp>
+
+#include <fc/log/logger.hpp>
+
+namespace sophiatx { namespace chain {
+
+transaction_prevalidator::transaction_prevalidator( uint32_t number_of_threads )
+   : _desired_size( number_of_threads )
+{
+}
+
+transaction_prevalidator::~transaction_prevalidator()
+{
+   quit();
+}
+
+void transaction_prevalidator::resize( uint32_t number_of_threads )
+{
+   if( number_of_threads == _desired_size )
+      return;
+   quit();
+   _desired_size = number_of_threads;
+}
+
+std::vector< prevalidated_transaction > transaction_prevalidator::prevalidate( const std::vector< signed_transaction >& transactions,
+                                                                               const chain_id_type& chain_id,
+                                                                               bool validate, bool recover_signatures )
+{
+   std::vector< prevalidated_transaction > result( transactions.size() );
+   if( _desired_size == 0 || transactions.empty() )
+      return result;
+
+   start_threads();
+
+   auto check = [&]( size_t first )
+   {
+      for( size_t i = first; i < transactions.size(); i += _threads.size() )
+      {
+         const signed_transaction& trx = transactions[i];
+         prevalidated_transaction& pre = result[i];
+         try
+         {
+            pre.id = trx.id();
+            pre.id_computed = true;
+            if( validate )
+            {
+               trx.validate();
+               pre.validated = true;
+            }
+            if( recover_signatures )
+            {
+               pre.signature_keys = trx.get_signature_keys( chain_id );
+               pre.signatures_recovered = true;
+            }
+         }
+         catch( const fc::exception& )
+         {
+            // repeated, and reported, when the transaction is applied
+         }
+      }
+   };
+
+   std::vector< fc::future< void > > done;
+   done.reserve( _threads.size() );
+   for( size_t t = 0; t < _threads.size(); ++t )
+      done.push_back( _threads[t]->async( [&check, t]() { check( t ); }, "prevalidate" ) );
+   for( auto& f : done )
+      f.wait();
+
+   return result;
+}
+
+void transaction_prevalidator::start_threads()
+{
+   while( _threads.size() < _desired_size )
+   {
+      _threads.emplace_back( new fc::thread( "prevalidate-" + std::to_string( _threads.size() ) ) );
+      ilog( "Started transaction prevalidation thread ${n} of ${total}", ("n", _threads.size())("total", _desired_size) );
+   }
+}
+
+void transaction_prevalidator::quit()
+{
+   for( const auto& thread : _threads )
+   {
+      try
+      {
+         thread->quit();
+      }
+      catch( const fc::exception& e )
+      {
+         wlog( "Exception thrown while shutting down transaction prevalidation thread, ignoring: ${e}", ("e", e) );
+      }
+   }
+   _threads.clear();
+}
+
+} } // sophiatx::chain
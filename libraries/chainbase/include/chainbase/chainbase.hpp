@@ -76,6 +76,33 @@ namespace helpers
          return info;
       }
    };
+
+   /**
+    *  Specialize to maintain a digest of the objects stored in an index.  digest() must be a deterministic
+    *  function of the object contents, the digest of an index is the sum of the digests of its objects so
+    *  it can be updated as objects are created, modified and removed.
+    */
+   template <class ValueType, class Enable = void>
+   class object_digest_provider
+   {
+   public:
+      static const bool enabled = false;
+      static uint64_t digest(const ValueType&) { return 0; }
+   };
+
+   /**
+    *  Specialize to maintain totals over the objects stored in an index.  add() and subtract() update the totals
+    *  with the contribution of one object.  The totals are kept in shared memory and restored on undo, so
+    *  aggregate_type must be trivially copyable.
+    */
+   template <class ValueType, class Enable = void>
+   class index_aggregate_provider
+   {
+   public:
+      struct aggregate_type {};
+      static void add(aggregate_type&, const ValueType&) {}
+      static void subtract(aggregate_type&, const ValueType&) {}
+   };
 } /// namespace helpers
 
 namespace chainbase {
@@ -166,6 +193,7 @@ namespace chainbase {
    {
       public:
          typedef typename value_type::id_type                      id_type;
+         typedef typename helpers::index_aggregate_provider< value_type >::aggregate_type aggregate_type;
          typedef allocator< std::pair<const id_type, value_type> > id_value_allocator_type;
          typedef allocator< id_type >                              id_allocator_type;
 
@@ -182,6 +210,8 @@ namespace chainbase {
          id_value_type_map            removed_values;
          id_type_set                  new_ids;
          id_type                      old_next_id = 0;
+         uint64_t                     old_digest = 0;
+         aggregate_type               old_aggregate;
          int64_t                      revision = 0;
    };
 
@@ -227,6 +257,9 @@ namespace chainbase {
          typedef typename index_type::value_type                       value_type;
          typedef bip::allocator< generic_index, segment_manager_type > allocator_type;
          typedef undo_state< value_type >                              undo_state_type;
+         typedef helpers::object_digest_provider< value_type >         digest_provider_type;
+         typedef helpers::index_aggregate_provider< value_type >       aggregate_provider_type;
+         typedef typename aggregate_provider_type::aggregate_type      aggregate_type;
 
          generic_index( allocator<value_type> a )
          :_stack(a),_indices( a ),_size_of_value_type( sizeof(typename MultiIndexType::node_type) ),_size_of_this(sizeof(*this)){}
@@ -265,6 +298,7 @@ namespace chainbase {
             on_modify( obj );
             auto ok = _indices.modify( _indices.iterator_to( obj ), m );
             if( !ok ) BOOST_THROW_EXCEPTION( std::logic_error( "Could not modify object, most likely a uniqueness constraint was violated" ) );
+            on_modified( obj );
          }
 
          void remove( const value_type& obj ) {
@@ -333,6 +367,8 @@ namespace chainbase {
          {
             _stack.emplace_back( _indices.get_allocator() );
             _stack.back().old_next_id = _next_id;
+            _stack.back().old_digest = _digest;
+            _stack.back().old_aggregate = _aggregate;
             _stack.back().revision = ++_revision;
             return session( *this, _revision );
          }
@@ -367,6 +403,8 @@ namespace chainbase {
                bool ok = _indices.emplace( std::move( item.second ) ).second;
                if( !ok ) BOOST_THROW_EXCEPTION( std::logic_error( "Could not restore object, most likely a uniqueness constraint was violated" ) );
             }
+            if( _digest_enabled ) _digest = head.old_digest;
+            _aggregate = head.old_aggregate;
 
             _stack.pop_back();
             --_revision;
@@ -506,10 +544,35 @@ namespace chainbase {
             _revision = revision;
          }
 
+         /**
+          *  Starts or stops maintaining the digest of the index.  Starting recomputes it from all objects, which
+          *  is only possible without undo history because the undo states keep the digest they have to restore.
+          */
+         void set_digest_enabled( bool enable )
+         {
+            enable = enable && digest_provider_type::enabled;
+            if( enable == _digest_enabled ) return;
+            if( enable && _stack.size() != 0 ) BOOST_THROW_EXCEPTION( std::logic_error("cannot enable digest while there is an existing undo stack") );
+
+            _digest = 0;
+            if( enable )
+               for( const auto& v : _indices )
+                  _digest += digest_provider_type::digest( v );
+            _digest_enabled = enable;
+         }
+
+         bool     digest_enabled()const { return _digest_enabled; }
+         uint64_t digest()const { return _digest; }
+
+         /// totals over all objects, see helpers::index_aggregate_provider
+         const aggregate_type& aggregate()const { return _aggregate; }
+
       private:
          bool enabled()const { return _stack.size(); }
 
          void on_modify( const value_type& v ) {
+            if( _digest_enabled ) _digest -= digest_provider_type::digest( v );
+            aggregate_provider_type::subtract( _aggregate, v );
             if( !enabled() ) return;
 
             auto& head = _stack.back();
@@ -524,7 +587,14 @@ namespace chainbase {
             head.old_values.emplace( std::pair< typename value_type::id_type, const value_type& >( v.id, v ) );
          }
 
+         void on_modified( const value_type& v ) {
+            if( _digest_enabled ) _digest += digest_provider_type::digest( v );
+            aggregate_provider_type::add( _aggregate, v );
+         }
+
          void on_remove( const value_type& v ) {
+            if( _digest_enabled ) _digest -= digest_provider_type::digest( v );
+            aggregate_provider_type::subtract( _aggregate, v );
             if( !enabled() ) return;
 
             auto& head = _stack.back();
@@ -547,6 +617,8 @@ namespace chainbase {
          }
 
          void on_create( const value_type& v ) {
+            if( _digest_enabled ) _digest += digest_provider_type::digest( v );
+            aggregate_provider_type::add( _aggregate, v );
             if( !enabled() ) return;
             auto& head = _stack.back();
 
@@ -566,6 +638,11 @@ namespace chainbase {
          index_type                      _indices;
          uint32_t                        _size_of_value_type = 0;
          uint32_t                        _size_of_this = 0;
+
+         /// sum of the digests of all objects, wrapping on overflow
+         uint64_t                        _digest = 0;
+         bool                            _digest_enabled = false;
+         aggregate_type                  _aggregate;
    };
 
    class abstract_session {
@@ -617,6 +694,11 @@ namespace chainbase {
          virtual void    undo_all()const = 0;
          virtual uint32_t type_id()const  = 0;
 
+         virtual bool     has_digest()const = 0;
+         virtual void     set_digest_enabled( bool enable )const = 0;
+         virtual bool     digest_enabled()const = 0;
+         virtual uint64_t digest()const = 0;
+
          virtual statistic_info get_statistics(bool onlyStaticInfo) const = 0;
          virtual size_t size() const = 0;
 
@@ -647,6 +729,11 @@ namespace chainbase {
          virtual void     undo_all() const override {_base.undo_all(); }
          virtual uint32_t type_id()const override { return BaseIndex::value_type::type_id; }
 
+         virtual bool     has_digest()const override { return BaseIndex::digest_provider_type::enabled; }
+         virtual void     set_digest_enabled( bool enable )const override { _base.set_digest_enabled( enable ); }
+         virtual bool     digest_enabled()const override { return _base.digest_enabled(); }
+         virtual uint64_t digest()const override { return _base.digest(); }
+
          virtual statistic_info get_statistics(bool onlyStaticInfo) const override final
          {
             typedef typename BaseIndex::index_type index_type;
@@ -38,6 +38,38 @@ typedef multi_index_container<
 
 CHAINBASE_SET_INDEX_TYPE( book, book_index )
 
+namespace helpers {
+   template<>
+   class object_digest_provider< book >
+   {
+   public:
+      static const bool enabled = true;
+      static uint64_t digest( const book& b ) { return std::hash< int64_t >()( b.id._id * 1000003 + b.a * 1009 + b.b ); }
+   };
+}
+
+namespace helpers {
+   template<>
+   class index_aggregate_provider< book >
+   {
+   public:
+      struct aggregate_type
+      {
+         int64_t count = 0;
+         int64_t sum_a = 0;
+      };
+      static void add( aggregate_type& t, const book& b ) { ++t.count; t.sum_a += b.a; }
+      static void subtract( aggregate_type& t, const book& b ) { --t.count; t.sum_a -= b.a; }
+   };
+}
+
+uint64_t recompute_digest( chainbase::generic_index< book_index >& idx )
+{
+   idx.set_digest_enabled( false );
+   idx.set_digest_enabled( true );
+   return idx.digest();
+}
+
 
 BOOST_AUTO_TEST_CASE( open_and_create ) {
    boost::filesystem::path temp = boost::filesystem::unique_path();
@@ -136,4 +168,113 @@ BOOST_AUTO_TEST_CASE( open_and_create ) {
    }
 }
 
+BOOST_AUTO_TEST_CASE( index_digest ) {
+   boost::filesystem::path temp = boost::filesystem::unique_path();
+   try {
+      chainbase::database db;
+      db.open( temp, 0, 1024*1024*8 );
+      db.add_index< book_index >();
+      auto& idx = db.get_mutable_index< book_index >();
+
+      const auto& book1 = db.create<book>( []( book& b ) { b.a = 1; b.b = 2; } );
+      BOOST_REQUIRE_EQUAL( idx.digest(), 0u ); /// not maintained until enabled
+
+      idx.set_digest_enabled( true );
+      BOOST_REQUIRE( idx.digest_enabled() );
+      const uint64_t one_book = idx.digest();
+      BOOST_REQUIRE( one_book != 0 );
+
+      const auto& book2 = db.create<book>( []( book& b ) { b.a = 3; b.b = 4; } );
+      db.modify( book1, []( book& b ) { b.a = 5; } );
+      uint64_t current = idx.digest();
+      BOOST_REQUIRE_EQUAL( current, recompute_digest( idx ) );
+
+      db.remove( book2 );
+      db.modify( book1, []( book& b ) { b.a = 1; } );
+      BOOST_REQUIRE_EQUAL( idx.digest(), one_book ); /// same contents, same digest
+
+      {
+         auto session = db.start_undo_session();
+         db.modify( book1, []( book& b ) { b.b = 7; } );
+         db.create<book>( []( book& b ) { b.a = 8; b.b = 9; } );
+         BOOST_REQUIRE( idx.digest() != one_book );
+      }
+      BOOST_REQUIRE_EQUAL( idx.digest(), one_book );
+
+      {
+         auto session = db.start_undo_session();
+         db.create<book>( []( book& b ) { b.a = 8; b.b = 9; } );
+         session.push();
+      }
+      current = idx.digest() - helpers::object_digest_provider< book >::digest( book1 );
+      {
+         auto session = db.start_undo_session();
+         db.remove( book1 );
+         session.squash();
+      }
+      BOOST_REQUIRE_EQUAL( idx.digest(), current );
+      db.undo();
+      BOOST_REQUIRE_EQUAL( idx.digest(), one_book );
+
+      {
+         auto session = db.start_undo_session();
+         BOOST_CHECK_THROW( recompute_digest( idx ), std::logic_error ); /// cannot be recomputed with undo history
+      }
+
+      idx.set_digest_enabled( false );
+      BOOST_REQUIRE_EQUAL( idx.digest(), 0u );
+      bfs::remove_all( temp );
+   } catch ( ... ) {
+      bfs::remove_all( temp );
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( index_aggregate ) {
+   boost::filesystem::path temp = boost::filesystem::unique_path();
+   try {
+      chainbase::database db;
+      db.open( temp, 0, 1024*1024*8 );
+      db.add_index< book_index >();
+      const auto& idx = db.get_index< book_index >();
+
+      const auto& book1 = db.create<book>( []( book& b ) { b.a = 1; } );
+      const auto& book2 = db.create<book>( []( book& b ) { b.a = 2; } );
+      const auto book2_id = book2.id;
+      BOOST_REQUIRE_EQUAL( idx.aggregate().count, 2 );
+      BOOST_REQUIRE_EQUAL( idx.aggregate().sum_a, 3 );
+
+      {
+         auto session = db.start_undo_session();
+         db.modify( book1, []( book& b ) { b.a = 10; } );
+         db.remove( book2 );
+         db.create<book>( []( book& b ) { b.a = 100; } );
+         BOOST_REQUIRE_EQUAL( idx.aggregate().count, 2 );
+         BOOST_REQUIRE_EQUAL( idx.aggregate().sum_a, 110 );
+      }
+      BOOST_REQUIRE_EQUAL( idx.aggregate().count, 2 );
+      BOOST_REQUIRE_EQUAL( idx.aggregate().sum_a, 3 );
+
+      {
+         auto session = db.start_undo_session();
+         db.modify( book1, []( book& b ) { b.a = 5; } );
+         session.push();
+      }
+      {
+         auto session = db.start_undo_session();
+         db.remove( db.get( book2_id ) ); /// book2 was restored by the undo above
+         session.squash();
+      }
+      BOOST_REQUIRE_EQUAL( idx.aggregate().count, 1 );
+      BOOST_REQUIRE_EQUAL( idx.aggregate().sum_a, 5 );
+      db.undo();
+      BOOST_REQUIRE_EQUAL( idx.aggregate().count, 2 );
+      BOOST_REQUIRE_EQUAL( idx.aggregate().sum_a, 3 );
+      bfs::remove_all( temp );
+   } catch ( ... ) {
+      bfs::remove_all( temp );
+      throw;
+   }
+}
+
 // BOOST_AUTO_TEST_SUITE_END()
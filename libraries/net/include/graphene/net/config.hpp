@@ -55,8 +55,25 @@
 #define GRAPHENE_NET_DEFAULT_DESIRED_CONNECTIONS             20
 #define GRAPHENE_NET_DEFAULT_MAX_CONNECTIONS                 200
 
+/**
+ * Number of threads that perform socket I/O, stcp encryption and message framing
+ * for peer connections.  Set to 0 to do everything on the p2p thread.
+ */
+#define GRAPHENE_NET_DEFAULT_IO_THREADS                      4
+
+/**
+ * Number of messages a connection's io thread may read ahead of the p2p thread before it stops
+ * reading from the socket
+ */
+#define GRAPHENE_NET_MAX_QUEUED_RECEIVED_MESSAGES            64
+
 #define GRAPHENE_NET_MAXIMUM_QUEUED_MESSAGES_IN_BYTES        (1024 * 1024)
 
+/**
+ * Number of entries a peer's send queue starts with, it doubles whenever it fills up
+ */
+#define GRAPHENE_NET_INITIAL_SEND_QUEUE_CAPACITY             64
+
 /**
  * When we receive a message from the network, we advertise it to
  * our peers and save a copy in a cache were we will find it if
@@ -104,6 +121,18 @@
 
 #define GRAPHENE_NET_MAX_TRX_PER_SECOND                      1000
 
+/**
+ * Transactions we have accepted or rejected are remembered in a rolling bloom filter so
+ * inventory advertisements for them can be dropped without scanning every peer's inventory.
+ * The filter remembers at least this many of the most recent transactions...
+ */
+#define GRAPHENE_NET_SEEN_TRANSACTION_FILTER_SIZE            (GRAPHENE_NET_MAX_INVENTORY_SIZE_IN_MINUTES * GRAPHENE_NET_MAX_TRX_PER_SECOND * 60)
+/**
+ * ...and wrongly claims to have seen a new transaction with this probability, in which case
+ * we don't fetch it from the peer that advertised it.  Blocks never go through the filter.
+ */
+#define GRAPHENE_NET_SEEN_TRANSACTION_FILTER_FALSE_POSITIVE_RATE 0.000001
+
 #define GRAPHENE_NET_MAX_NUMBER_OF_BLOCKS_TO_HANDLE_AT_ONE_TIME 200
 #define GRAPHENE_NET_MAX_NUMBER_OF_BLOCKS_TO_PREFETCH           (10 * GRAPHENE_NET_MAX_NUMBER_OF_BLOCKS_TO_HANDLE_AT_ONE_TIME)
 
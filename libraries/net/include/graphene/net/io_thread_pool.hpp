@@ -0,0 +1,39 @@
+#pragma once
+
+#include <fc/thread/thread.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace graphene { namespace net {
+
+  /**
+   *  A set of fc::threads that peer connections are assigned to round-robin.  Each connection
+   *  performs its socket reads and writes, stcp encryption and message framing on its assigned
+   *  thread and only hands complete messages back to the node's thread.
+   *
+   *  Threads are started lazily, the first time a connection asks for one.  With a size of zero
+   *  the pool is disabled and connections do all of their work on the thread that created them.
+   */
+  class io_thread_pool
+  {
+     public:
+       explicit io_thread_pool( uint32_t number_of_threads = 0 );
+       ~io_thread_pool();
+
+       /** takes effect for connections created after the call, existing connections keep their thread */
+       void        resize( uint32_t number_of_threads );
+       uint32_t    size() const { return _desired_size; }
+
+       /** returns the thread the next connection should run on, or nullptr if the pool is disabled */
+       fc::thread* get_thread();
+
+       void        quit();
+
+     private:
+       std::vector< std::unique_ptr< fc::thread > > _threads;
+       uint32_t                                     _desired_size = 0;
+       uint32_t                                     _next_thread = 0;
+  };
+
+} } // graphene::net
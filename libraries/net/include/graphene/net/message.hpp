@@ -27,8 +27,11 @@
 #include <fc/network/ip.hpp>
 #include <fc/io/raw.hpp>
 #include <fc/crypto/ripemd160.hpp>
+#include <fc/optional.hpp>
 #include <fc/reflect/variant.hpp>
 
+#include <memory>
+
 namespace graphene { namespace net {
 
   /**
@@ -53,13 +56,20 @@ namespace graphene { namespace net {
   {
      std::vector<char> data;
 
+     /**
+      *  Set on the io thread of the connection that received this message, so the p2p thread
+      *  doesn't hash or unpack it again.  decoded holds a T with T::type == msg_type.
+      */
+     fc::optional<message_hash_type> decoded_id;
+     std::shared_ptr<const void>     decoded;
+
      message(){}
 
      message( message&& m )
-     :message_header(m),data( std::move(m.data) ){}
+     :message_header(m),data( std::move(m.data) ),decoded_id( std::move(m.decoded_id) ),decoded( std::move(m.decoded) ){}
 
      message( const message& m )
-     :message_header(m),data( m.data ){}
+     :message_header(m),data( m.data ),decoded_id( m.decoded_id ),decoded( m.decoded ){}
 
      /**
       *  Assumes that T::type specifies the message type
@@ -74,6 +84,8 @@ namespace graphene { namespace net {
 
      fc::uint160_t id()const
      {
+        if( decoded_id )
+           return *decoded_id;
         return fc::ripemd160::hash( data.data(), (uint32_t)data.size() );
      }
 
@@ -86,6 +98,8 @@ namespace graphene { namespace net {
      {
          try {
           FC_ASSERT( msg_type == T::type );
+          if( decoded )
+             return *std::static_pointer_cast<const T>( decoded );
           T tmp;
           if( data.size() )
           {
@@ -106,10 +120,21 @@ namespace graphene { namespace net {
               ("msg_type", msg_type)
               );
      }
-  };
-
 
+     /** unpacks the payload as a T and remembers it along with the message id, see decoded */
+     template<typename T>
+     void decode()
+     {
+        decoded_id = id();
+        decoded = std::make_shared<const T>( as<T>() );
+     }
+  };
 
+  /**
+   *  Messages that are sent to many peers (blocks and transactions we relay) are shared between
+   *  the message cache and every peer's send queue instead of being copied for each of them.
+   */
+  typedef std::shared_ptr<const message> shared_message_ptr;
 
 } } // graphene::net
 
@@ -23,6 +23,7 @@
  */
 #pragma once
 #include <fc/network/tcp_socket.hpp>
+#include <fc/thread/thread.hpp>
 #include <graphene/net/message.hpp>
 
 namespace graphene { namespace net {
@@ -35,15 +36,25 @@ namespace graphene { namespace net {
   class message_oriented_connection_delegate 
   {
   public:
+    /** called on the io thread before the message is queued for on_message, must not touch any state */
+    virtual void decode_message(message& received_message) {}
     virtual void on_message(message_oriented_connection* originating_connection, const message& received_message) = 0;
     virtual void on_connection_closed(message_oriented_connection* originating_connection) = 0;
   };
 
-  /** uses a secure socket to create a connection that reads and writes a stream of `fc::net::message` objects */
+  /**
+   *  uses a secure socket to create a connection that reads and writes a stream of `fc::net::message` objects
+   *
+   *  If an io_thread is given, the socket reads/writes, stcp encryption and message decoding are done
+   *  there and the delegate is still called on the thread that constructed the connection.  Received
+   *  messages are queued for that thread in order, the io thread only stops reading while
+   *  GRAPHENE_NET_MAX_QUEUED_RECEIVED_MESSAGES are waiting.
+   */
   class message_oriented_connection
   {
      public:
-       message_oriented_connection(message_oriented_connection_delegate* delegate = nullptr);
+       message_oriented_connection(message_oriented_connection_delegate* delegate = nullptr,
+                                   fc::thread* io_thread = nullptr);
        ~message_oriented_connection();
        fc::tcp_socket& get_socket();
 
@@ -52,6 +63,8 @@ namespace graphene { namespace net {
        void connect_to(const fc::ip::endpoint& remote_endpoint);
 
        void send_message(const message& message_to_send);
+       /** sends a message that may be queued for other peers as well, without copying it */
+       void send_message(const shared_message_ptr& message_to_send);
        void close_connection();
        void destroy_connection();
 
@@ -184,6 +184,44 @@ namespace graphene { namespace net {
       fc::variant_object info;
    };
 
+   /**
+    *  Per-peer counters, meant for finding the peers that slow down block and
+    *  transaction propagation.  Latencies are in microseconds.
+    */
+   struct peer_telemetry
+   {
+      fc::ip::endpoint host;
+      node_id_t        node_id;
+      std::string      user_agent;
+      bool             inbound = false;
+      fc::time_point   connection_time;
+
+      uint64_t         bytes_sent = 0;
+      uint64_t         bytes_received = 0;
+      uint32_t         queued_messages = 0;
+      uint64_t         queued_bytes = 0;
+      uint32_t         items_requested = 0; ///< requested from the peer and not yet received
+
+      int64_t          round_trip_delay = 0;
+      int64_t          clock_offset = 0;
+
+      uint64_t         blocks_sent = 0;
+      uint64_t         transactions_sent = 0;
+      uint64_t         blocks_received = 0;
+      uint64_t         transactions_received = 0;
+
+      uint64_t         requested_items_received = 0;
+      int64_t          mean_item_fetch_latency = 0;
+      int64_t          max_item_fetch_latency = 0;
+   };
+
+   struct network_telemetry
+   {
+      std::vector<peer_telemetry> peers;
+      /** per node_delegate method call times, see node::get_call_statistics() */
+      fc::variant_object          delegate_calls;
+   };
+
    /**
     *  @class node
     *  @brief provides application independent P2P broadcast and data synchronization
@@ -295,6 +333,8 @@ namespace graphene { namespace net {
         std::vector<potential_peer_record> get_potential_peers() const;
 
         fc::variant_object get_call_statistics() const;
+
+        network_telemetry get_network_telemetry() const;
       private:
         std::unique_ptr<detail::node_impl, detail::node_impl_deleter> my;
    };
@@ -329,3 +369,9 @@ namespace graphene { namespace net {
 
 FC_REFLECT(graphene::net::message_propagation_data, (received_time)(validated_time)(originating_peer));
 FC_REFLECT( graphene::net::peer_status, (version)(host)(info) );
+FC_REFLECT(graphene::net::peer_telemetry, (host)(node_id)(user_agent)(inbound)(connection_time)
+                                          (bytes_sent)(bytes_received)(queued_messages)(queued_bytes)(items_requested)
+                                          (round_trip_delay)(clock_offset)
+                                          (blocks_sent)(transactions_sent)(blocks_received)(transactions_received)
+                                          (requested_items_received)(mean_item_fetch_latency)(max_item_fetch_latency))
+FC_REFLECT(graphene::net::network_telemetry, (peers)(delegate_calls))
@@ -40,7 +40,7 @@
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 
-#include <queue>
+#include <boost/circular_buffer.hpp>
 #include <boost/container/deque.hpp>
 #include <fc/thread/future.hpp>
 
@@ -68,7 +68,7 @@ namespace graphene { namespace net
       virtual void on_message(peer_connection* originating_peer,
                               const message& received_message) = 0;
       virtual void on_connection_closed(peer_connection* originating_peer) = 0;
-      virtual message get_message_for_item(const item_id& item) = 0;
+      virtual shared_message_ptr get_message_for_item(const item_id& item) = 0;
     };
 
     class peer_connection;
@@ -110,8 +110,8 @@ namespace graphene { namespace net
       fc::optional<fc::ip::endpoint> _remote_endpoint;
       message_oriented_connection    _message_connection;
 
-      /* a base class for messages on the queue, to hide the fact that some
-       * messages are complete messages and some are only hashes of messages.
+      /* an entry on the send queue.  Some entries are complete messages and some are only hashes
+       * of messages that are looked up when they reach the front of the queue.
        */
       struct queued_message
       {
@@ -119,55 +119,38 @@ namespace graphene { namespace net
         fc::time_point transmission_start_time;
         fc::time_point transmission_finish_time;
 
-        queued_message(fc::time_point enqueue_time = fc::time_point::now()) :
-          enqueue_time(enqueue_time)
-        {}
-
-        virtual message get_message(peer_connection_delegate* node) = 0;
-        /** returns roughly the number of bytes of memory the message is consuming while
-         * it is sitting on the queue
+        /* for a 'real' queued message, the message itself.  It is shared, not copied, so broadcasting
+         * one block or transaction to many peers keeps a single copy of it in memory
          */
-        virtual size_t get_size_in_queue() = 0;
-        virtual ~queued_message() {}
-      };
+        shared_message_ptr message_to_send;
+        size_t             message_send_time_field_offset = (size_t)-1;
 
-      /* when you queue up a 'real_queued_message', a full copy of the message is
-       * stored on the heap until it is sent
-       */
-      struct real_queued_message : queued_message
-      {
-        message        message_to_send;
-        size_t         message_send_time_field_offset;
+        /* for a 'virtual' queued message, we just queue up the hash of the item we want to send.
+         * When it reaches the top of the queue, we make a callback to the node to generate the message.
+         */
+        item_id            item_to_send;
 
-        real_queued_message(message message_to_send,
-                            size_t message_send_time_field_offset = (size_t)-1) :
+        queued_message() {}
+        queued_message(shared_message_ptr message_to_send, size_t message_send_time_field_offset = (size_t)-1) :
+          enqueue_time(fc::time_point::now()),
           message_to_send(std::move(message_to_send)),
           message_send_time_field_offset(message_send_time_field_offset)
         {}
-
-        message get_message(peer_connection_delegate* node) override;
-        size_t get_size_in_queue() override;
-      };
-
-      /* when you queue up a 'virtual_queued_message', we just queue up the hash of the
-       * item we want to send.  When it reaches the top of the queue, we make a callback
-       * to the node to generate the message.
-       */
-      struct virtual_queued_message : queued_message
-      {
-        item_id item_to_send;
-
-        virtual_queued_message(item_id item_to_send) :
+        queued_message(item_id item_to_send) :
+          enqueue_time(fc::time_point::now()),
           item_to_send(std::move(item_to_send))
         {}
 
-        message get_message(peer_connection_delegate* node) override;
-        size_t get_size_in_queue() override;
+        shared_message_ptr get_message(peer_connection_delegate* node);
+        /** returns roughly the number of bytes of memory the message is consuming while
+         * it is sitting on the queue
+         */
+        size_t get_size_in_queue() const;
       };
 
-
       size_t _total_queued_messages_size = 0;
-      std::queue<std::unique_ptr<queued_message>, std::list<std::unique_ptr<queued_message> > > _queued_messages;
+      /// entries are stored contiguously and the buffer grows (doubling) when it fills up
+      boost::circular_buffer<queued_message> _queued_messages;
       fc::future<void> _send_queued_messages_done;
     public:
       fc::time_point connection_initiation_time;
@@ -263,6 +246,17 @@ namespace graphene { namespace net
 
       uint32_t last_known_fork_block_number = 0;
 
+      /// telemetry, reported through node::get_network_telemetry()
+      /// @{
+      uint64_t blocks_sent = 0;
+      uint64_t transactions_sent = 0;
+      uint64_t blocks_received = 0;
+      uint64_t transactions_received = 0;
+      uint64_t requested_items_received = 0; /// items we fetched from this peer during normal operation
+      fc::microseconds total_item_fetch_latency; /// time from our request to the item's arrival, summed over requested_items_received
+      fc::microseconds max_item_fetch_latency;
+      /// @}
+
       fc::future<void> accept_or_connect_task_done;
 
       firewall_check_state_data *firewall_check_state = nullptr;
@@ -273,21 +267,25 @@ namespace graphene { namespace net
 #endif
       bool _currently_handling_message = false; // true while we're in the middle of handling a message from the remote system
     private:
-      peer_connection(peer_connection_delegate* delegate);
+      peer_connection(peer_connection_delegate* delegate, fc::thread* io_thread);
       void destroy();
     public:
-      static peer_connection_ptr make_shared(peer_connection_delegate* delegate); // use this instead of the constructor
+      /** use this instead of the constructor.  If io_thread is given, socket I/O and encryption for this
+       * connection run there while messages are still handled on the calling thread */
+      static peer_connection_ptr make_shared(peer_connection_delegate* delegate, fc::thread* io_thread = nullptr);
       virtual ~peer_connection();
 
       fc::tcp_socket& get_socket();
       void accept_connection();
       void connect_to(const fc::ip::endpoint& remote_endpoint, fc::optional<fc::ip::endpoint> local_endpoint = fc::optional<fc::ip::endpoint>());
 
+      void decode_message(message& received_message) override;
       void on_message(message_oriented_connection* originating_connection, const message& received_message) override;
       void on_connection_closed(message_oriented_connection* originating_connection) override;
 
-      void send_queueable_message(std::unique_ptr<queued_message>&& message_to_send);
+      void send_queueable_message(queued_message&& message_to_send);
       void send_message(const message& message_to_send, size_t message_send_time_field_offset = (size_t)-1);
+      void send_message(shared_message_ptr message_to_send);
       void send_item(const item_id& item_to_send);
       void close_connection();
       void destroy_connection();
@@ -298,6 +296,10 @@ namespace graphene { namespace net
       fc::time_point get_last_message_sent_time() const;
       fc::time_point get_last_message_received_time() const;
 
+      size_t get_queued_message_count() const;
+      size_t get_total_queued_messages_size() const;
+      void record_item_fetch_latency(const fc::time_point& request_time);
+
       fc::optional<fc::ip::endpoint> get_remote_endpoint();
       fc::ip::endpoint get_local_endpoint();
       void set_remote_endpoint(fc::optional<fc::ip::endpoint> new_remote_endpoint);
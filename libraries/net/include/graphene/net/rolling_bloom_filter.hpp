@@ -0,0 +1,63 @@
+#pragma once
+
+#include <fc/crypto/ripemd160.hpp>
+#include <fc/reflect/reflect.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace graphene { namespace net {
+
+  /**
+   *  Approximate set of the most recently inserted hashes, used to answer "have we already seen this
+   *  item" without touching the exact (and much larger) inventory containers.
+   *
+   *  The filter is split into two generations of `items_per_generation` entries each.  Once the current
+   *  generation is full the older one is wiped and reused, so the filter always remembers at least the
+   *  last `items_per_generation` inserts and never grows.  Lookups can return false positives (with
+   *  roughly the probability given to the constructor) but never false negatives for items inside that
+   *  window.
+   *
+   *  The hashes we store are already cryptographic digests, so the bit positions are taken straight
+   *  from their words (mixed with a per-instance salt) instead of hashing them again.
+   */
+  class rolling_bloom_filter
+  {
+     public:
+       struct statistics
+       {
+         uint64_t lookups = 0;
+         uint64_t hits = 0;
+         uint64_t inserts = 0;
+         uint64_t generations_rotated = 0;
+       };
+
+       rolling_bloom_filter( uint32_t items_per_generation, double false_positive_rate );
+
+       void insert( const fc::ripemd160& hash );
+       bool contains( const fc::ripemd160& hash );
+       void clear();
+
+       const statistics& get_statistics() const { return _statistics; }
+       size_t            get_memory_usage() const;
+
+     private:
+       void compute_bit_positions( const fc::ripemd160& hash, std::vector< uint32_t >& positions ) const;
+       bool test_generation( const std::vector< uint64_t >& bits, const std::vector< uint32_t >& positions ) const;
+
+       uint32_t                 _items_per_generation;
+       uint32_t                 _hash_count;
+       uint32_t                 _bits_per_generation;
+       uint64_t                 _salt;
+
+       std::vector< uint64_t >  _generations[2];
+       uint32_t                 _current_generation = 0;
+       uint32_t                 _items_in_current_generation = 0;
+
+       std::vector< uint32_t >  _positions; // scratch buffer, avoids an allocation per lookup
+       statistics               _statistics;
+  };
+
+} } // graphene::net
+
+FC_REFLECT( graphene::net::rolling_bloom_filter::statistics, (lookups)(hits)(inserts)(generations_rotated) )
@@ -0,0 +1,60 @@
+#include <graphene/net/io_thread_pool.hpp>
+
+#include <fc/log/logger.hpp>
+
+#ifdef DEFAULT_LOGGER
+# undef DEFAULT_LOGGER
+#endif
+#define DEFAULT_LOGGER "p2p"
+
+namespace graphene { namespace net {
+
+  io_thread_pool::io_thread_pool( uint32_t number_of_threads ) :
+    _desired_size( number_of_threads )
+  {
+  }
+
+  io_thread_pool::~io_thread_pool()
+  {
+    quit();
+  }
+
+  void io_thread_pool::resize( uint32_t number_of_threads )
+  {
+    _desired_size = number_of_threads;
+  }
+
+  fc::thread* io_thread_pool::get_thread()
+  {
+    if( _desired_size == 0 )
+      return nullptr;
+
+    // threads are never torn down while the pool is alive, because connections created before a
+    // resize() may still be running on them
+    if( _threads.size() < _desired_size )
+    {
+      _threads.emplace_back( new fc::thread( "p2p-io-" + std::to_string( _threads.size() ) ) );
+      ilog( "started p2p io thread ${n} of ${total}", ("n", _threads.size())("total", _desired_size) );
+      return _threads.back().get();
+    }
+
+    return _threads[ _next_thread++ % _desired_size ].get();
+  }
+
+  void io_thread_pool::quit()
+  {
+    for( const auto& thread : _threads )
+    {
+      try
+      {
+        thread->quit();
+      }
+      catch( const fc::exception& e )
+      {
+        wlog( "Exception thrown while shutting down p2p io thread, ignoring: ${e}", ("e", e) );
+      }
+    }
+    _threads.clear();
+  }
+
+} } // graphene::net
@@ -32,7 +32,11 @@
 #include <graphene/net/stcp_socket.hpp>
 #include <graphene/net/config.hpp>
 
+#include <algorithm>
 #include <atomic>
+#include <deque>
+#include <list>
+#include <mutex>
 
 #ifdef DEFAULT_LOGGER
 # undef DEFAULT_LOGGER
@@ -55,20 +59,53 @@ namespace graphene { namespace net {
       message_oriented_connection_delegate *_delegate;
       stcp_socket _sock;
       fc::future<void> _read_loop_done;
-      uint64_t _bytes_received;
-      uint64_t _bytes_sent;
+      std::atomic<uint64_t> _bytes_received;
+      std::atomic<uint64_t> _bytes_sent;
 
       fc::time_point _connected_time;
-      fc::time_point _last_message_received_time;
-      fc::time_point _last_message_sent_time;
+      std::atomic<int64_t> _last_message_received_time;
+      std::atomic<int64_t> _last_message_sent_time;
 
       bool _send_message_in_progress;
-#ifndef NDEBUG
+
+      /// the thread that created us, the delegate is always called on this thread
       fc::thread* _thread;
-#endif
+      /// the thread doing our socket reads/writes and encryption, may be the same as _thread
+      fc::thread* _io_thread;
+      /// messages read by the io thread that wait to be handled on the delegate's thread.  Shared with
+      /// the drain task, which may still be scheduled after we are destroyed
+      struct delivery_queue
+      {
+        std::mutex                             lock;
+        /// the delegate's thread, the drain task runs there
+        fc::thread*                            thread = nullptr;
+        /// the connection the messages are delivered for, only valid while enabled
+        message_oriented_connection_impl*      connection = nullptr;
+        /// in arrival order, an empty pointer stands for the connection being closed
+        std::deque<std::shared_ptr<message> >  messages;
+        /// set while a drain task is scheduled or running on the delegate's thread
+        bool                                   draining = false;
+        /// cleared when the connection is destroyed, so queued messages are dropped instead of
+        /// touching a dead connection
+        bool                                   enabled = true;
+        /// set on the delegate's thread after handling a message failed, the messages read after it
+        /// are dropped but the connection closed notification is still delivered
+        bool                                   discard_messages = false;
+        /// set by the drain task when the io thread is waiting for the queue to shrink
+        fc::promise<void>::ptr                 space_available;
+      };
+      std::shared_ptr<delivery_queue> _delivery_queue;
+      /// io thread tasks whose caller was canceled before they finished, waited for on destruction
+      std::list<fc::future<void> > _abandoned_io_tasks;
 
       void read_loop();
       void start_read_loop();
+      void deliver_message(message&& received_message);
+      void deliver_connection_closed();
+      void enqueue_for_delivery(std::shared_ptr<message>&& entry);
+      static void drain_delivery_queue(const std::shared_ptr<delivery_queue>& queue);
+      template<typename Functor>
+      void run_on_io_thread(Functor&& f, const char* description);
     public:
       fc::tcp_socket& get_socket();
       void accept();
@@ -76,10 +113,11 @@ namespace graphene { namespace net {
       void bind(const fc::ip::endpoint& local_endpoint);
 
       message_oriented_connection_impl(message_oriented_connection* self,
-                                       message_oriented_connection_delegate* delegate = nullptr);
+                                       message_oriented_connection_delegate* delegate = nullptr,
+                                       fc::thread* io_thread = nullptr);
       ~message_oriented_connection_impl();
 
-      void send_message(const message& message_to_send);
+      void send_message(const shared_message_ptr& message_to_send);
       void close_connection();
       void destroy_connection();
 
@@ -93,16 +131,21 @@ namespace graphene { namespace net {
     };
 
     message_oriented_connection_impl::message_oriented_connection_impl(message_oriented_connection* self,
-                                                                       message_oriented_connection_delegate* delegate)
+                                                                       message_oriented_connection_delegate* delegate,
+                                                                       fc::thread* io_thread)
     : _self(self),
       _delegate(delegate),
       _bytes_received(0),
       _bytes_sent(0),
-      _send_message_in_progress(false)
-#ifndef NDEBUG
-      ,_thread(&fc::thread::current())
-#endif
+      _last_message_received_time(0),
+      _last_message_sent_time(0),
+      _send_message_in_progress(false),
+      _thread(&fc::thread::current()),
+      _io_thread(io_thread ? io_thread : &fc::thread::current()),
+      _delivery_queue(std::make_shared<delivery_queue>())
     {
+      _delivery_queue->thread = _thread;
+      _delivery_queue->connection = this;
     }
     message_oriented_connection_impl::~message_oriented_connection_impl()
     {
@@ -116,20 +159,48 @@ namespace graphene { namespace net {
       return _sock.get_socket();
     }
 
-    void message_oriented_connection_impl::accept()
+    template<typename Functor>
+    void message_oriented_connection_impl::run_on_io_thread(Functor&& f, const char* description)
+    {
+      if (_io_thread->is_current())
+      {
+        f();
+        return;
+      }
+
+      fc::future<void> io_task = _io_thread->async(std::forward<Functor>(f), description);
+      try
+      {
+        io_task.wait();
+      }
+      catch (const fc::canceled_exception&)
+      {
+        // the task still references us, don't let destroy_connection() finish before it does
+        _abandoned_io_tasks.push_back(io_task);
+        throw;
+      }
+    }
+
+    void message_oriented_connection_impl::start_read_loop()
     {
       VERIFY_CORRECT_THREAD();
-      _sock.accept();
       assert(!_read_loop_done.valid()); // check to be sure we never launch two read loops
-      _read_loop_done = fc::async([=](){ read_loop(); }, "message read_loop");
+      _connected_time = fc::time_point::now();
+      _read_loop_done = _io_thread->async([=](){ read_loop(); }, "message read_loop");
+    }
+
+    void message_oriented_connection_impl::accept()
+    {
+      VERIFY_CORRECT_THREAD();
+      run_on_io_thread([this](){ _sock.accept(); }, "stcp accept"); // key exchange
+      start_read_loop();
     }
 
     void message_oriented_connection_impl::connect_to(const fc::ip::endpoint& remote_endpoint)
     {
       VERIFY_CORRECT_THREAD();
-      _sock.connect_to(remote_endpoint);
-      assert(!_read_loop_done.valid()); // check to be sure we never launch two read loops
-      _read_loop_done = fc::async([=](){ read_loop(); }, "message read_loop");
+      run_on_io_thread([this, remote_endpoint](){ _sock.connect_to(remote_endpoint); }, "stcp connect_to");
+      start_read_loop();
     }
 
     void message_oriented_connection_impl::bind(const fc::ip::endpoint& local_endpoint)
@@ -138,15 +209,134 @@ namespace graphene { namespace net {
       _sock.bind(local_endpoint);
     }
 
+    void message_oriented_connection_impl::deliver_message(message&& received_message)
+    {
+      assert(_io_thread->is_current());
+      _delegate->decode_message(received_message);
+      if (_thread == _io_thread)
+      {
+        _delegate->on_message(_self, received_message);
+        return;
+      }
+      enqueue_for_delivery(std::make_shared<message>(std::move(received_message)));
+    }
+
+    void message_oriented_connection_impl::deliver_connection_closed()
+    {
+      assert(_io_thread->is_current());
+      if (_thread == _io_thread)
+      {
+        _delegate->on_connection_closed(_self);
+        return;
+      }
+      // queued behind the messages we already read, so the delegate sees them first
+      enqueue_for_delivery(std::shared_ptr<message>());
+    }
+
+    void message_oriented_connection_impl::enqueue_for_delivery(std::shared_ptr<message>&& entry)
+    {
+      assert(_io_thread->is_current());
+      std::shared_ptr<delivery_queue> queue(_delivery_queue);
+      fc::promise<void>::ptr wait_for_space;
+      bool schedule_drain = false;
+      {
+        std::lock_guard<std::mutex> guard(queue->lock);
+        queue->messages.push_back(std::move(entry));
+        if (!queue->draining)
+        {
+          queue->draining = true;
+          schedule_drain = true;
+        }
+        if (queue->messages.size() >= GRAPHENE_NET_MAX_QUEUED_RECEIVED_MESSAGES)
+        {
+          queue->space_available = fc::promise<void>::ptr(new fc::promise<void>("graphene::net::delivery_queue_space_available"));
+          wait_for_space = queue->space_available;
+        }
+      }
+
+      // messages from one peer are handled one at a time and in order by a single drain task,
+      // we don't wait for them unless the p2p thread has fallen too far behind
+      if (schedule_drain)
+        _thread->async([queue](){ drain_delivery_queue(queue); }, "deliver p2p messages");
+      if (wait_for_space)
+        wait_for_space->wait();
+    }
+
+    void message_oriented_connection_impl::drain_delivery_queue(const std::shared_ptr<delivery_queue>& queue)
+    {
+      // the connection may be destroyed before this task runs or while the delegate handles a message, so
+      // it is only looked up through the queue while the queue is enabled
+      assert(queue->thread->is_current());
+      while (true)
+      {
+        std::shared_ptr<message> entry;
+        fc::promise<void>::ptr space_available;
+        message_oriented_connection_impl* connection;
+        {
+          std::lock_guard<std::mutex> guard(queue->lock);
+          if (queue->messages.empty())
+          {
+            queue->draining = false;
+            return;
+          }
+          entry = std::move(queue->messages.front());
+          queue->messages.pop_front();
+          if (queue->space_available && queue->messages.size() < GRAPHENE_NET_MAX_QUEUED_RECEIVED_MESSAGES / 2)
+            space_available = std::move(queue->space_available);
+          connection = queue->enabled ? queue->connection : nullptr;
+        }
+        if (space_available)
+          space_available->set_value();
+        if (!connection)
+          continue; // keep emptying the queue so a waiting io thread is released
+
+        if (!entry)
+        {
+          connection->_delegate->on_connection_closed(connection->_self);
+          continue;
+        }
+        if (queue->discard_messages)
+          continue;
+        try
+        {
+          connection->_delegate->on_message(connection->_self, *entry);
+        }
+        catch (const fc::canceled_exception&)
+        {
+          throw;
+        }
+        catch (const fc::exception& e)
+        {
+          // the read loop used to disconnect when handling a message failed.  The io thread no
+          // longer waits for the result, so close the socket to end the read loop instead and
+          // drop what it has already queued
+          wlog("message transmission failed ${er}", ("er", e.to_detail_string()));
+          queue->discard_messages = true;
+          {
+            std::lock_guard<std::mutex> guard(queue->lock);
+            connection = queue->enabled ? queue->connection : nullptr;
+          }
+          if (!connection)
+            continue; // destroyed while the message was being handled
+          try
+          {
+            connection->close_connection();
+          }
+          catch (const fc::exception& close_error)
+          {
+            wlog("error closing connection after a failed message: ${e}", ("e", close_error.to_detail_string()));
+          }
+        }
+      }
+    }
+
     void message_oriented_connection_impl::read_loop()
     {
-      VERIFY_CORRECT_THREAD();
+      assert(_io_thread->is_current());
       const int BUFFER_SIZE = 16;
       const int LEFTOVER = BUFFER_SIZE - sizeof(message_header);
       static_assert(BUFFER_SIZE >= sizeof(message_header), "insufficient buffer");
 
-      _connected_time = fc::time_point::now();
-
       fc::oexception exception_to_rethrow;
       bool call_on_connection_closed = false;
 
@@ -172,12 +362,12 @@ namespace graphene { namespace net {
           }
           m.data.resize(m.size); // truncate off the padding bytes
 
-          _last_message_received_time = fc::time_point::now();
+          _last_message_received_time = fc::time_point::now().time_since_epoch().count();
 
           try
           {
             // message handling errors are warnings...
-            _delegate->on_message(_self, m);
+            deliver_message(std::move(m));
           }
           /// Dedicated catches needed to distinguish from general fc::exception
           catch ( const fc::canceled_exception& e ) { throw e; }
@@ -220,13 +410,13 @@ namespace graphene { namespace net {
       }
 
       if (call_on_connection_closed)
-        _delegate->on_connection_closed(_self);
+        deliver_connection_closed();
 
       if (exception_to_rethrow)
         throw *exception_to_rethrow;
     }
 
-    void message_oriented_connection_impl::send_message(const message& message_to_send)
+    void message_oriented_connection_impl::send_message(const shared_message_ptr& message_to_send)
     {
       VERIFY_CORRECT_THREAD();
 #if 0 // this gets too verbose
@@ -255,30 +445,56 @@ namespace graphene { namespace net {
 
       try
       {
-        size_t size_of_message_and_header = sizeof(message_header) + message_to_send.size;
-        if( message_to_send.size > MAX_MESSAGE_SIZE )
+        size_t size_of_message_and_header = sizeof(message_header) + message_to_send->size;
+        if( message_to_send->size > MAX_MESSAGE_SIZE )
            elog("Trying to send a message larger than MAX_MESSAGE_SIZE. This probably won't work...");
         //pad the message we send to a multiple of 16 bytes
         size_t size_with_padding = 16 * ((size_of_message_and_header + 15) / 16);
-        std::unique_ptr<char[]> padded_message(new char[size_with_padding]);
-
-        memcpy(padded_message.get(), (char*)&message_to_send, sizeof(message_header));
-        memcpy(padded_message.get() + sizeof(message_header), message_to_send.data.data(), message_to_send.size );
-        char* paddingSpace = padded_message.get() + sizeof(message_header) + message_to_send.size;
-        size_t toClean = size_with_padding - size_of_message_and_header;
-        memset(paddingSpace, 0, toClean);
 
-        _sock.write(padded_message.get(), size_with_padding);
-        _sock.flush();
+        // encryption and the socket write happen on the io thread.  The message is captured by value
+        // so it stays alive even if our caller is canceled while waiting
+        run_on_io_thread([this, message_to_send](){
+          // the wire format is the header followed by the data, padded to a multiple of 16 bytes.
+          // Instead of assembling a padded copy of the whole message, write the first block (header plus
+          // the start of the data) and the padded last block from the stack and the aligned middle part
+          // straight out of the (possibly shared) message
+          const size_t block_size = 16;
+          const size_t data_in_first_block = block_size - sizeof(message_header);
+          static_assert(block_size >= sizeof(message_header), "insufficient buffer");
+
+          char first_block[block_size];
+          memset(first_block, 0, block_size);
+          memcpy(first_block, (const char*)message_to_send.get(), sizeof(message_header));
+          size_t bytes_in_first_block = std::min<size_t>(message_to_send->size, data_in_first_block);
+          memcpy(first_block + sizeof(message_header), message_to_send->data.data(), bytes_in_first_block);
+          _sock.write(first_block, block_size);
+
+          if (message_to_send->size > data_in_first_block)
+          {
+            const char* remaining_data = message_to_send->data.data() + data_in_first_block;
+            size_t remaining_bytes = message_to_send->size - data_in_first_block;
+            size_t aligned_bytes = remaining_bytes - remaining_bytes % block_size;
+            if (aligned_bytes)
+              _sock.write(remaining_data, aligned_bytes);
+            if (remaining_bytes > aligned_bytes)
+            {
+              char last_block[block_size];
+              memset(last_block, 0, block_size);
+              memcpy(last_block, remaining_data + aligned_bytes, remaining_bytes - aligned_bytes);
+              _sock.write(last_block, block_size);
+            }
+          }
+          _sock.flush();
+        }, "message_oriented_connection send_message");
         _bytes_sent += size_with_padding;
-        _last_message_sent_time = fc::time_point::now();
+        _last_message_sent_time = fc::time_point::now().time_since_epoch().count();
       } FC_RETHROW_EXCEPTIONS( warn, "unable to send message" );
     }
 
     void message_oriented_connection_impl::close_connection()
     {
       VERIFY_CORRECT_THREAD();
-      _sock.close();
+      run_on_io_thread([this](){ _sock.close(); }, "stcp close");
     }
 
     void message_oriented_connection_impl::destroy_connection()
@@ -295,6 +511,11 @@ namespace graphene { namespace net {
              "The task calling send_message() should have been canceled already");
       assert(!_send_message_in_progress);
 
+      {
+        std::lock_guard<std::mutex> guard(_delivery_queue->lock);
+        _delivery_queue->enabled = false;
+        _delivery_queue->connection = nullptr;
+      }
       try
       {
         _read_loop_done.cancel_and_wait(__FUNCTION__);
@@ -307,6 +528,18 @@ namespace graphene { namespace net {
       {
         wlog( "Exception thrown while canceling message_oriented_connection's read_loop, ignoring" );
       }
+
+      for (fc::future<void>& io_task : _abandoned_io_tasks)
+      {
+        try
+        {
+          io_task.wait();
+        }
+        catch (...)
+        {
+        }
+      }
+      _abandoned_io_tasks.clear();
     }
 
     uint64_t message_oriented_connection_impl::get_total_bytes_sent() const
@@ -324,13 +557,13 @@ namespace graphene { namespace net {
     fc::time_point message_oriented_connection_impl::get_last_message_sent_time() const
     {
       VERIFY_CORRECT_THREAD();
-      return _last_message_sent_time;
+      return fc::time_point(fc::microseconds(_last_message_sent_time));
     }
 
     fc::time_point message_oriented_connection_impl::get_last_message_received_time() const
     {
       VERIFY_CORRECT_THREAD();
-      return _last_message_received_time;
+      return fc::time_point(fc::microseconds(_last_message_received_time));
     }
 
     fc::sha512 message_oriented_connection_impl::get_shared_secret() const
@@ -342,8 +575,9 @@ namespace graphene { namespace net {
   } // end namespace graphene::net::detail
 
 
-  message_oriented_connection::message_oriented_connection(message_oriented_connection_delegate* delegate) :
-    my(new detail::message_oriented_connection_impl(this, delegate))
+  message_oriented_connection::message_oriented_connection(message_oriented_connection_delegate* delegate,
+                                                           fc::thread* io_thread) :
+    my(new detail::message_oriented_connection_impl(this, delegate, io_thread))
   {
   }
 
@@ -372,6 +606,11 @@ namespace graphene { namespace net {
   }
 
   void message_oriented_connection::send_message(const message& message_to_send)
+  {
+    my->send_message(std::make_shared<message>(message_to_send));
+  }
+
+  void message_oriented_connection::send_message(const shared_message_ptr& message_to_send)
   {
     my->send_message(message_to_send);
   }
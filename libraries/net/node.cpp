@@ -30,6 +30,7 @@
 #include <iostream>
 #include <algorithm>
 #include <tuple>
+#include <array>
 #include <boost/tuple/tuple.hpp>
 #include <boost/circular_buffer.hpp>
 
@@ -76,6 +77,8 @@
 #include <graphene/net/peer_database.hpp>
 #include <graphene/net/peer_connection.hpp>
 #include <graphene/net/stcp_socket.hpp>
+#include <graphene/net/io_thread_pool.hpp>
+#include <graphene/net/rolling_bloom_filter.hpp>
 #include <graphene/net/config.hpp>
 #include <graphene/net/exceptions.hpp>
 
@@ -134,16 +137,16 @@ namespace graphene { namespace net {
       struct block_clock_index{};
       struct message_info
       {
-        message_hash_type message_hash;
-        message           message_body;
-        uint32_t          block_clock_when_received;
+        message_hash_type  message_hash;
+        shared_message_ptr message_body;
+        uint32_t           block_clock_when_received;
 
         // for network performance stats
         message_propagation_data propagation_data;
         fc::uint160_t     message_contents_hash; // hash of whatever the message contains (if it's a transaction, this is the transaction id, if it's a block, it's the block_id)
 
         message_info( const message_hash_type& message_hash,
-                      const message&           message_body,
+                      const shared_message_ptr& message_body,
                       uint32_t                 block_clock_when_received,
                       const message_propagation_data& propagation_data,
                       fc::uint160_t            message_contents_hash ) :
@@ -175,7 +178,7 @@ namespace graphene { namespace net {
       void block_accepted();
       void cache_message( const message& message_to_cache, const message_hash_type& hash_of_message_to_cache,
                         const message_propagation_data& propagation_data, const fc::uint160_t& message_content_hash );
-      message get_message( const message_hash_type& hash_of_message_to_lookup );
+      shared_message_ptr get_message( const message_hash_type& hash_of_message_to_lookup );
       message_propagation_data get_message_propagation_data( const fc::uint160_t& hash_of_message_contents_to_lookup ) const;
       size_t size() const { return _message_cache.size(); }
     };
@@ -194,13 +197,13 @@ namespace graphene { namespace net {
                                                      const fc::uint160_t& message_content_hash )
     {
       _message_cache.insert( message_info(hash_of_message_to_cache,
-                                         message_to_cache,
+                                         std::make_shared<message>(message_to_cache),
                                          block_clock,
                                          propagation_data,
                                          message_content_hash ) );
     }
 
-    message blockchain_tied_message_cache::get_message( const message_hash_type& hash_of_message_to_lookup )
+    shared_message_ptr blockchain_tied_message_cache::get_message( const message_hash_type& hash_of_message_to_lookup )
     {
       message_cache_container::index<message_hash_index>::type::const_iterator iter =
          _message_cache.get<message_hash_index>().find(hash_of_message_to_lookup );
@@ -256,6 +259,8 @@ namespace graphene { namespace net {
                                                                                        boost::accumulators::tag::max,
                                                                                        boost::accumulators::tag::sum,
                                                                                        boost::accumulators::tag::count> > call_stats_accumulator;
+      /// number of calls whose execution time fell below each of call_latency_bucket_limits, the last bucket counts the rest
+      typedef std::array<uint64_t, 6> call_latency_histogram;
 #define NODE_DELEGATE_METHOD_NAMES (has_item) \
                                    (handle_message) \
                                    (handle_block) \
@@ -276,7 +281,8 @@ namespace graphene { namespace net {
 #define DECLARE_ACCUMULATOR(r, data, method_name) \
       mutable call_stats_accumulator BOOST_PP_CAT(_, BOOST_PP_CAT(method_name, _execution_accumulator)); \
       mutable call_stats_accumulator BOOST_PP_CAT(_, BOOST_PP_CAT(method_name, _delay_before_accumulator)); \
-      mutable call_stats_accumulator BOOST_PP_CAT(_, BOOST_PP_CAT(method_name, _delay_after_accumulator));
+      mutable call_stats_accumulator BOOST_PP_CAT(_, BOOST_PP_CAT(method_name, _delay_after_accumulator)); \
+      mutable call_latency_histogram BOOST_PP_CAT(_, BOOST_PP_CAT(method_name, _execution_histogram)) = {};
       BOOST_PP_SEQ_FOR_EACH(DECLARE_ACCUMULATOR, unused, NODE_DELEGATE_METHOD_NAMES)
 #undef DECLARE_ACCUMULATOR
 
@@ -290,6 +296,7 @@ namespace graphene { namespace net {
         call_stats_accumulator* _execution_accumulator;
         call_stats_accumulator* _delay_before_accumulator;
         call_stats_accumulator* _delay_after_accumulator;
+        call_latency_histogram* _execution_histogram;
       public:
         class actual_execution_measurement_helper
         {
@@ -308,12 +315,14 @@ namespace graphene { namespace net {
         call_statistics_collector(const char* method_name,
                                   call_stats_accumulator* execution_accumulator,
                                   call_stats_accumulator* delay_before_accumulator,
-                                  call_stats_accumulator* delay_after_accumulator) :
+                                  call_stats_accumulator* delay_after_accumulator,
+                                  call_latency_histogram* execution_histogram) :
           _call_requested_time(fc::time_point::now()),
           _method_name(method_name),
           _execution_accumulator(execution_accumulator),
           _delay_before_accumulator(delay_before_accumulator),
-          _delay_after_accumulator(delay_after_accumulator)
+          _delay_after_accumulator(delay_after_accumulator),
+          _execution_histogram(execution_histogram)
         {}
         ~call_statistics_collector()
         {
@@ -325,6 +334,7 @@ namespace graphene { namespace net {
           (*_execution_accumulator)(actual_execution_time.count());
           (*_delay_before_accumulator)(delay_before.count());
           (*_delay_after_accumulator)(delay_after.count());
+          ++(*_execution_histogram)[get_latency_bucket(actual_execution_time)];
           if (total_duration > fc::milliseconds(500))
           {
             ilog("Call to method node_delegate::${method} took ${total_duration}us, longer than our target maximum of 500ms",
@@ -349,6 +359,8 @@ namespace graphene { namespace net {
     public:
       statistics_gathering_node_delegate_wrapper(node_delegate* delegate, fc::thread* thread_for_delegate_calls);
 
+      static size_t get_latency_bucket(const fc::microseconds& execution_time);
+
       fc::variant_object get_call_statistics();
 
       sophiatx::protocol::chain_id_type get_chain_id() const override;
@@ -381,9 +393,12 @@ namespace graphene { namespace net {
       std::shared_ptr<fc::thread> _thread;
 #endif // P2P_IN_DEDICATED_THREAD
       std::unique_ptr<statistics_gathering_node_delegate_wrapper> _delegate;
+      /// threads doing socket I/O and encryption for our peers.  Declared before the connection
+      /// lists so it outlives every peer_connection that might still be using one of its threads
+      io_thread_pool _io_thread_pool;
 
 #define NODE_CONFIGURATION_FILENAME      "node_config.json"
-#define POTENTIAL_PEER_DATABASE_FILENAME "peers.json"
+#define POTENTIAL_PEER_DATABASE_FILENAME "peers.dat"
       fc::path             _node_configuration_directory;
       node_configuration   _node_configuration;
 
@@ -440,6 +455,7 @@ namespace graphene { namespace net {
       unsigned _items_to_fetch_sequence_counter;
       items_to_fetch_set_type _items_to_fetch; /// list of items we know another peer has and we want
       peer_connection::timestamped_items_set_type _recently_failed_items; /// list of transactions we've recently pushed and had rejected by the delegate
+      rolling_bloom_filter _seen_transactions_filter; /// transactions we've recently accepted or rejected, checked before the exact containers above
       // @}
 
       /// used by the task that advertises inventory during normal operation
@@ -704,7 +720,8 @@ namespace graphene { namespace net {
       void                       clear_peer_database();
       void                       set_total_bandwidth_limit( uint32_t upload_bytes_per_second, uint32_t download_bytes_per_second );
       fc::variant_object         get_call_statistics() const;
-      message                    get_message_for_item(const item_id& item) override;
+      network_telemetry          get_network_telemetry() const;
+      shared_message_ptr         get_message_for_item(const item_id& item) override;
 
       fc::variant_object         network_get_info() const;
       fc::variant_object         network_get_usage_stats() const;
@@ -747,12 +764,14 @@ namespace graphene { namespace net {
       _thread(std::make_shared<fc::thread>("p2p")),
 #endif // P2P_IN_DEDICATED_THREAD
       _delegate(nullptr),
+      _io_thread_pool(GRAPHENE_NET_DEFAULT_IO_THREADS),
       _is_firewalled(firewalled_state::unknown),
       _potential_peer_database_updated(false),
       _sync_items_to_fetch_updated(false),
       _suspend_fetching_sync_blocks(false),
       _items_to_fetch_updated(false),
       _items_to_fetch_sequence_counter(0),
+      _seen_transactions_filter(GRAPHENE_NET_SEEN_TRANSACTION_FILTER_SIZE, GRAPHENE_NET_SEEN_TRANSACTION_FILTER_FALSE_POSITIVE_RATE),
       _recent_block_interval_in_seconds(SOPHIATX_BLOCK_INTERVAL),
       _user_agent_string(user_agent),
       _most_recent_blocks_accepted(GRAPHENE_NET_DEFAULT_MAX_CONNECTIONS),
@@ -2697,7 +2716,7 @@ namespace graphene { namespace net {
       }
     }
 
-    message node_impl::get_message_for_item(const item_id& item)
+    shared_message_ptr node_impl::get_message_for_item(const item_id& item)
     {
       try
       {
@@ -2707,11 +2726,11 @@ namespace graphene { namespace net {
       {}
       try
       {
-        return _delegate->get_item(item);
+        return std::make_shared<message>(_delegate->get_item(item));
       }
       catch (fc::key_not_found_exception&)
       {}
-      return item_not_available_message(item);
+      return std::make_shared<message>(item_not_available_message(item));
     }
 
     void node_impl::on_fetch_items_message(peer_connection* originating_peer, const fetch_items_message& fetch_items_message_received)
@@ -2722,17 +2741,17 @@ namespace graphene { namespace net {
            ("type", fetch_items_message_received.item_type)
            ("endpoint", originating_peer->get_remote_endpoint()));
 
-      fc::optional<message> last_block_message_sent;
+      shared_message_ptr last_block_message_sent;
 
-      std::list<message> reply_messages;
+      std::list<shared_message_ptr> reply_messages;
       for (const item_hash_t& item_hash : fetch_items_message_received.items_to_fetch)
       {
         try
         {
-          message requested_message = _message_cache.get_message(item_hash);
+          shared_message_ptr requested_message = _message_cache.get_message(item_hash);
           dlog("received item request for item ${id} from peer ${endpoint}, returning the item from my message cache",
                ("endpoint", originating_peer->get_remote_endpoint())
-               ("id", requested_message.id()));
+               ("id", item_hash));
           reply_messages.push_back(requested_message);
           if (fetch_items_message_received.item_type == block_message_type)
             last_block_message_sent = requested_message;
@@ -2746,10 +2765,10 @@ namespace graphene { namespace net {
         item_id item_to_fetch(fetch_items_message_received.item_type, item_hash);
         try
         {
-          message requested_message = _delegate->get_item(item_to_fetch);
+          shared_message_ptr requested_message = std::make_shared<message>(_delegate->get_item(item_to_fetch));
           dlog("received item request from peer ${endpoint}, returning the item from delegate with id ${id} size ${size}",
-               ("id", requested_message.id())
-               ("size", requested_message.size)
+               ("id", item_hash)
+               ("size", requested_message->size)
                ("endpoint", originating_peer->get_remote_endpoint()));
           reply_messages.push_back(requested_message);
           if (fetch_items_message_received.item_type == block_message_type)
@@ -2758,7 +2777,7 @@ namespace graphene { namespace net {
         }
         catch (fc::key_not_found_exception&)
         {
-          reply_messages.push_back(item_not_available_message(item_to_fetch));
+          reply_messages.push_back(std::make_shared<message>(item_not_available_message(item_to_fetch)));
           dlog("received item request from peer ${endpoint} but we don't have it",
                ("endpoint", originating_peer->get_remote_endpoint()));
         }
@@ -2772,12 +2791,19 @@ namespace graphene { namespace net {
         originating_peer->last_block_time_delegate_has_seen = _delegate->get_block_time(block.block_id);
       }
 
-      for (const message& reply : reply_messages)
+      for (const shared_message_ptr& reply : reply_messages)
       {
-        if (reply.msg_type == block_message_type)
-          originating_peer->send_item(item_id(block_message_type, reply.as<graphene::net::block_message>().block_id));
+        if (reply->msg_type == block_message_type)
+        {
+          originating_peer->send_item(item_id(block_message_type, reply->as<graphene::net::block_message>().block_id));
+          ++originating_peer->blocks_sent;
+        }
         else
+        {
           originating_peer->send_message(reply);
+          if (reply->msg_type == trx_message_type)
+            ++originating_peer->transactions_sent;
+        }
       }
     }
 
@@ -2832,6 +2858,12 @@ namespace graphene { namespace net {
           continue;
         item_id advertised_item_id(item_ids_inventory_message_received.item_type, item_hash);
 
+        // during transaction floods most advertisements are for transactions we already have; the filter
+        // answers that without scanning the inventory of every active peer below
+        if (advertised_item_id.item_type == graphene::net::trx_message_type &&
+            _seen_transactions_filter.contains(item_hash))
+          continue;
+
         if (_new_inventory.find(advertised_item_id) != _new_inventory.end())
           // we've processed this item but haven't advertised it to our peers yet, don't fetch it again
           continue;
@@ -3529,7 +3561,9 @@ namespace graphene { namespace net {
       auto item_iter = originating_peer->items_requested_from_peer.find(item_id(graphene::net::block_message_type, message_hash));
       if (item_iter != originating_peer->items_requested_from_peer.end())
       {
+        originating_peer->record_item_fetch_latency(item_iter->second);
         originating_peer->items_requested_from_peer.erase(item_iter);
+        ++originating_peer->blocks_received;
         process_block_during_normal_operation(originating_peer, block_message_to_process, message_hash);
         if (originating_peer->idle())
           trigger_fetch_items_loop();
@@ -3542,6 +3576,7 @@ namespace graphene { namespace net {
         if (sync_item_iter != originating_peer->sync_items_requested_from_peer.end())
         {
           originating_peer->sync_items_requested_from_peer.erase(sync_item_iter);
+          ++originating_peer->blocks_received;
           // if exceptions are throw here after removing the sync item from the list (above),
           // it could leave our sync in a stalled state.  Wrap a try/catch around the rest
           // of the function so we can log if this ever happens.
@@ -3695,7 +3730,7 @@ namespace graphene { namespace net {
         {
           // we're not connected to them, so we need to set up a connection to them
           // to test.
-          peer_connection_ptr peer_for_testing(peer_connection::make_shared(this));
+          peer_connection_ptr peer_for_testing(peer_connection::make_shared(this, _io_thread_pool.get_thread()));
           peer_for_testing->firewall_check_state = new firewall_check_state_data;
           peer_for_testing->firewall_check_state->endpoint_to_test = check_firewall_message_received.endpoint_to_check;
           peer_for_testing->firewall_check_state->expected_node_id = check_firewall_message_received.node_id;
@@ -3879,7 +3914,10 @@ namespace graphene { namespace net {
       }
       else
       {
+        originating_peer->record_item_fetch_latency( iter->second );
         originating_peer->items_requested_from_peer.erase( iter );
+        if (message_to_process.msg_type == trx_message_type)
+          ++originating_peer->transactions_received;
         if (originating_peer->idle())
           trigger_fetch_items_loop();
 
@@ -3906,6 +3944,8 @@ namespace graphene { namespace net {
           wlog( "client rejected message sent by peer ${peer}, ${e}", ("peer", originating_peer->get_remote_endpoint() )("e", e) );
           // record it so we don't try to fetch this item again
           _recently_failed_items.insert(peer_connection::timestamped_item_id(item_id(message_to_process.msg_type, message_hash ), fc::time_point::now()));
+          if (message_to_process.msg_type == trx_message_type)
+            _seen_transactions_filter.insert(message_hash);
           return;
         }
 
@@ -4251,7 +4291,7 @@ namespace graphene { namespace net {
       VERIFY_CORRECT_THREAD();
       while ( !_accept_loop_complete.canceled() )
       {
-        peer_connection_ptr new_peer(peer_connection::make_shared(this));
+        peer_connection_ptr new_peer(peer_connection::make_shared(this, _io_thread_pool.get_thread()));
 
         try
         {
@@ -4676,7 +4716,7 @@ namespace graphene { namespace net {
                            ("endpoint", remote_endpoint));
 
       dlog("node_impl::connect_to_endpoint(${endpoint})", ("endpoint", remote_endpoint));
-      peer_connection_ptr new_peer(peer_connection::make_shared(this));
+      peer_connection_ptr new_peer(peer_connection::make_shared(this, _io_thread_pool.get_thread()));
       new_peer->set_remote_endpoint(remote_endpoint);
       initiate_connect_to(new_peer);
     }
@@ -4772,6 +4812,8 @@ namespace graphene { namespace net {
       ilog( "node._items_to_fetch size: ${size}", ("size", _items_to_fetch.size() ) );
       ilog( "node._new_inventory size: ${size}", ("size", _new_inventory.size() ) );
       ilog( "node._message_cache size: ${size}", ("size", _message_cache.size() ) );
+      ilog( "node._seen_transactions_filter: ${bytes} bytes, ${stats}",
+            ("bytes", _seen_transactions_filter.get_memory_usage())("stats", _seen_transactions_filter.get_statistics()) );
       for( const peer_connection_ptr& peer : _active_connections )
       {
         ilog( "  peer ${endpoint}", ("endpoint", peer->get_remote_endpoint() ) );
@@ -4963,6 +5005,8 @@ namespace graphene { namespace net {
 
       _message_cache.cache_message( item_to_broadcast, hash_of_item_to_broadcast, propagation_data, hash_of_message_contents );
       _new_inventory.insert( item_id(item_to_broadcast.msg_type, hash_of_item_to_broadcast ) );
+      if( item_to_broadcast.msg_type == graphene::net::trx_message_type )
+        _seen_transactions_filter.insert( hash_of_item_to_broadcast );
       trigger_advertise_inventory_loop();
     }
 
@@ -5023,6 +5067,12 @@ namespace graphene { namespace net {
             );
       }
 
+      if( _node_configuration.io_thread_count != _io_thread_pool.size() )
+      {
+         ilog( "Using ${n} p2p io threads for new connections", ("n", _node_configuration.io_thread_count) );
+         _io_thread_pool.resize( _node_configuration.io_thread_count );
+      }
+
       while (_active_connections.size() > _node_configuration.maximum_number_of_connections)
         disconnect_from_peer(_active_connections.begin()->get(),
                              "I have too many connections open");
@@ -5086,6 +5136,49 @@ namespace graphene { namespace net {
       return _delegate->get_call_statistics();
     }
 
+    network_telemetry node_impl::get_network_telemetry() const
+    {
+      VERIFY_CORRECT_THREAD();
+      network_telemetry telemetry;
+      telemetry.peers.reserve(_active_connections.size());
+      for (const peer_connection_ptr& peer : _active_connections)
+      {
+        ASSERT_TASK_NOT_PREEMPTED(); // don't yield while iterating over _active_connections
+
+        peer_telemetry peer_data;
+        fc::optional<fc::ip::endpoint> endpoint = peer->get_remote_endpoint();
+        if (endpoint)
+          peer_data.host = *endpoint;
+        peer_data.node_id = peer->node_id;
+        peer_data.user_agent = peer->user_agent;
+        peer_data.inbound = peer->direction == peer_connection_direction::inbound;
+        peer_data.connection_time = peer->get_connection_time();
+
+        peer_data.bytes_sent = peer->get_total_bytes_sent();
+        peer_data.bytes_received = peer->get_total_bytes_received();
+        peer_data.queued_messages = (uint32_t)peer->get_queued_message_count();
+        peer_data.queued_bytes = peer->get_total_queued_messages_size();
+        peer_data.items_requested = (uint32_t)(peer->items_requested_from_peer.size() + peer->sync_items_requested_from_peer.size());
+
+        peer_data.round_trip_delay = peer->round_trip_delay.count();
+        peer_data.clock_offset = peer->clock_offset.count();
+
+        peer_data.blocks_sent = peer->blocks_sent;
+        peer_data.transactions_sent = peer->transactions_sent;
+        peer_data.blocks_received = peer->blocks_received;
+        peer_data.transactions_received = peer->transactions_received;
+
+        peer_data.requested_items_received = peer->requested_items_received;
+        if (peer->requested_items_received)
+          peer_data.mean_item_fetch_latency = peer->total_item_fetch_latency.count() / (int64_t)peer->requested_items_received;
+        peer_data.max_item_fetch_latency = peer->max_item_fetch_latency.count();
+
+        telemetry.peers.push_back(std::move(peer_data));
+      }
+      telemetry.delegate_calls = _delegate->get_call_statistics();
+      return telemetry;
+    }
+
     fc::variant_object node_impl::network_get_info() const
     {
       VERIFY_CORRECT_THREAD();
@@ -5094,6 +5187,7 @@ namespace graphene { namespace net {
       info["node_public_key"] = _node_public_key;
       info["node_id"] = _node_id;
       info["firewalled"] = _is_firewalled;
+      info["seen_transactions_filter"] = _seen_transactions_filter.get_statistics();
       return info;
     }
     fc::variant_object node_impl::network_get_usage_stats() const
@@ -5218,6 +5312,11 @@ namespace graphene { namespace net {
     INVOKE_IN_IMPL(get_connected_peers);
   }
 
+  network_telemetry node::get_network_telemetry() const
+  {
+    INVOKE_IN_IMPL(get_network_telemetry);
+  }
+
   uint32_t node::get_connection_count() const
   {
     INVOKE_IN_IMPL(get_connection_count);
@@ -5377,12 +5476,22 @@ namespace graphene { namespace net {
     {}
 #undef INITIALIZE_ACCUMULATOR
 
+    // upper bounds (exclusive, in microseconds) of all but the last call_latency_histogram bucket
+    static const int64_t call_latency_bucket_limits[] = { 100, 1000, 10000, 100000, 1000000 };
+
+    size_t statistics_gathering_node_delegate_wrapper::get_latency_bucket(const fc::microseconds& execution_time)
+    {
+      return std::upper_bound(std::begin(call_latency_bucket_limits), std::end(call_latency_bucket_limits),
+                              execution_time.count()) - std::begin(call_latency_bucket_limits);
+    }
+
     fc::variant_object statistics_gathering_node_delegate_wrapper::get_call_statistics()
     {
       fc::mutable_variant_object statistics;
       std::ostringstream note;
       note << "All times are in microseconds, mean is the average of the last " << ROLLING_WINDOW_SIZE << " call times";
       statistics["_note"] = note.str();
+      statistics["_histogram_bucket_limits"] = std::vector<int64_t>(std::begin(call_latency_bucket_limits), std::end(call_latency_bucket_limits));
 
 #define ADD_STATISTICS_FOR_METHOD(r, data, method_name) \
       fc::mutable_variant_object BOOST_PP_CAT(method_name, _stats); \
@@ -5399,6 +5508,8 @@ namespace graphene { namespace net {
       BOOST_PP_CAT(method_name, _stats)["delay_after_max"] = boost::accumulators::max(BOOST_PP_CAT(_, BOOST_PP_CAT(method_name, _delay_after_accumulator))); \
       BOOST_PP_CAT(method_name, _stats)["delay_after_sum"] = boost::accumulators::sum(BOOST_PP_CAT(_, BOOST_PP_CAT(method_name, _delay_after_accumulator))); \
       BOOST_PP_CAT(method_name, _stats)["count"] = boost::accumulators::count(BOOST_PP_CAT(_, BOOST_PP_CAT(method_name, _execution_accumulator))); \
+      BOOST_PP_CAT(method_name, _stats)["histogram"] = std::vector<uint64_t>(BOOST_PP_CAT(_, BOOST_PP_CAT(method_name, _execution_histogram)).begin(), \
+                                                                            BOOST_PP_CAT(_, BOOST_PP_CAT(method_name, _execution_histogram)).end()); \
       statistics[BOOST_PP_STRINGIZE(method_name)] = BOOST_PP_CAT(method_name, _stats);
 
       BOOST_PP_SEQ_FOR_EACH(ADD_STATISTICS_FOR_METHOD, unused, NODE_DELEGATE_METHOD_NAMES)
@@ -5418,7 +5529,8 @@ namespace graphene { namespace net {
          call_statistics_collector statistics_collector(#method_name, \
             &_ ## method_name ## _execution_accumulator, \
             &_ ## method_name ## _delay_before_accumulator, \
-            &_ ## method_name ## _delay_after_accumulator); \
+            &_ ## method_name ## _delay_after_accumulator, \
+            &_ ## method_name ## _execution_histogram); \
         call_statistics_collector::actual_execution_measurement_helper helper(statistics_collector); \
         return _node_delegate->method_name(__VA_ARGS__); \
       } \
@@ -5427,7 +5539,8 @@ namespace graphene { namespace net {
          call_statistics_collector statistics_collector(#method_name, \
             &_ ## method_name ## _execution_accumulator, \
             &_ ## method_name ## _delay_before_accumulator, \
-            &_ ## method_name ## _delay_after_accumulator); \
+            &_ ## method_name ## _delay_after_accumulator, \
+            &_ ## method_name ## _execution_histogram); \
           call_statistics_collector::actual_execution_measurement_helper helper(statistics_collector); \
           return _node_delegate->method_name(__VA_ARGS__); \
         }, "invoke " BOOST_STRINGIZE(method_name)).wait(); \
@@ -5448,34 +5561,16 @@ namespace graphene { namespace net {
       throw; \
     }
 #else
+// the delegate is called directly on the p2p thread, so only the execution time is measured
 #define INVOKE_AND_COLLECT_STATISTICS( method_name, ... ) \
    FC_UNUSED( _thread ) \
+   call_statistics_collector statistics_collector(#method_name, \
+      &_ ## method_name ## _execution_accumulator, \
+      &_ ## method_name ## _delay_before_accumulator, \
+      &_ ## method_name ## _delay_after_accumulator, \
+      &_ ## method_name ## _execution_histogram); \
+   call_statistics_collector::actual_execution_measurement_helper helper(statistics_collector); \
    return _node_delegate->method_name(__VA_ARGS__);
-/*
-#  define INVOKE_AND_COLLECT_STATISTICS(method_name, ...) \
-    call_statistics_collector statistics_collector(#method_name, \
-                                                   &_ ## method_name ## _execution_accumulator, \
-                                                   &_ ## method_name ## _delay_before_accumulator, \
-                                                   &_ ## method_name ## _delay_after_accumulator); \
-    if ( _thread->is_current()) \
-    { \
-      call_statistics_collector statistics_collector(#method_name, \
-         &_ ## method_name ## _execution_accumulator, \
-         &_ ## method_name ## _delay_before_accumulator, \
-         &_ ## method_name ## _delay_after_accumulator); \
-      call_statistics_collector::actual_execution_measurement_helper helper(statistics_collector); \
-      return _node_delegate->method_name(__VA_ARGS__); \
-    } \
-    else \
-      return _thread->async([&](){ \
-         call_statistics_collector statistics_collector(#method_name, \
-            &_ ## method_name ## _execution_accumulator, \
-            &_ ## method_name ## _delay_before_accumulator, \
-            &_ ## method_name ## _delay_after_accumulator); \
-        call_statistics_collector::actual_execution_measurement_helper helper(statistics_collector); \
-        return _node_delegate->method_name(__VA_ARGS__); \
-      }, "invoke " BOOST_STRINGIZE(method_name)).wait()
-*/
 #endif
 
     sophiatx::protocol::chain_id_type statistics_gathering_node_delegate_wrapper::get_chain_id() const
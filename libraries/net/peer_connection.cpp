@@ -43,37 +43,36 @@
 
 namespace graphene { namespace net
   {
-    message peer_connection::real_queued_message::get_message(peer_connection_delegate*)
+    shared_message_ptr peer_connection::queued_message::get_message(peer_connection_delegate* node)
     {
+      if (!message_to_send)
+        return node->get_message_for_item(item_to_send);
+
       if (message_send_time_field_offset != (size_t)-1)
       {
         // patch the current time into the message.  Since this operates on the packed version of the structure,
-        // it won't work for anything after a variable-length field
+        // it won't work for anything after a variable-length field.  Messages with a time field are never
+        // shared between peers, but patch a private copy anyway so the queued original stays untouched
+        std::shared_ptr<message> patched_message(std::make_shared<message>(*message_to_send));
         std::vector<char> packed_current_time = fc::raw::pack_to_vector(fc::time_point::now());
-        assert(message_send_time_field_offset + packed_current_time.size() <= message_to_send.data.size());
-        memcpy(message_to_send.data.data() + message_send_time_field_offset,
+        assert(message_send_time_field_offset + packed_current_time.size() <= patched_message->data.size());
+        memcpy(patched_message->data.data() + message_send_time_field_offset,
                packed_current_time.data(), packed_current_time.size());
+        return patched_message;
       }
       return message_to_send;
     }
-    size_t peer_connection::real_queued_message::get_size_in_queue()
-    {
-      return message_to_send.data.size();
-    }
-    message peer_connection::virtual_queued_message::get_message(peer_connection_delegate* node)
-    {
-      return node->get_message_for_item(item_to_send);
-    }
 
-    size_t peer_connection::virtual_queued_message::get_size_in_queue()
+    size_t peer_connection::queued_message::get_size_in_queue() const
     {
-      return sizeof(item_id);
+      return message_to_send ? message_to_send->data.size() : sizeof(item_id);
     }
 
-    peer_connection::peer_connection(peer_connection_delegate* delegate) :
+    peer_connection::peer_connection(peer_connection_delegate* delegate, fc::thread* io_thread) :
       _node(delegate),
-      _message_connection(this),
+      _message_connection(this, io_thread),
       _total_queued_messages_size(0),
+      _queued_messages(GRAPHENE_NET_INITIAL_SEND_QUEUE_CAPACITY),
       direction(peer_connection_direction::unknown),
       is_firewalled(firewalled_state::unknown),
       our_state(our_connection_state::disconnected),
@@ -96,7 +95,7 @@ namespace graphene { namespace net
     {
     }
 
-    peer_connection_ptr peer_connection::make_shared(peer_connection_delegate* delegate)
+    peer_connection_ptr peer_connection::make_shared(peer_connection_delegate* delegate, fc::thread* io_thread)
     {
       // The lifetime of peer_connection objects is managed by shared_ptrs in node.  The peer_connection
       // is responsible for notifying the node when it should be deleted, and the process of deleting it
@@ -106,7 +105,7 @@ namespace graphene { namespace net
       // current task yields.  In the (not uncommon) case where it is the task executing
       // connect_to or read_loop, this allows the task to finish before the destructor is forced
       // to cancel it.
-      return peer_connection_ptr(new peer_connection(delegate));
+      return peer_connection_ptr(new peer_connection(delegate, io_thread));
       //, [](peer_connection* peer_to_delete){ fc::async([peer_to_delete](){delete peer_to_delete;}); });
     }
 
@@ -264,6 +263,23 @@ namespace graphene { namespace net
       }
     } // connect_to()
 
+    void peer_connection::decode_message( message& received_message )
+    {
+      // blocks and transactions are the only messages big or frequent enough to be worth unpacking
+      // off the p2p thread, everything else is handled from the raw message as before
+      try
+      {
+        if( received_message.msg_type == core_message_type_enum::block_message_type )
+          received_message.decode<block_message>();
+        else if( received_message.msg_type == core_message_type_enum::trx_message_type )
+          received_message.decode<trx_message>();
+      }
+      catch( const fc::exception& )
+      {
+        // leave it undecoded, the node reports the malformed message when it unpacks it itself
+      }
+    }
+
     void peer_connection::on_message( message_oriented_connection* originating_connection, const message& received_message )
     {
       VERIFY_CORRECT_THREAD();
@@ -293,8 +309,11 @@ namespace graphene { namespace net
 #endif
       while (!_queued_messages.empty())
       {
-        _queued_messages.front()->transmission_start_time = fc::time_point::now();
-        message message_to_send = _queued_messages.front()->get_message(_node);
+        _queued_messages.front().transmission_start_time = fc::time_point::now();
+        // work on a copy of the entry: generating or sending the message may yield, and the queue's
+        // storage is reallocated if other tasks enqueue enough messages meanwhile
+        queued_message message_being_sent(_queued_messages.front());
+        shared_message_ptr message_to_send = message_being_sent.get_message(_node);
         try
         {
           //dlog("peer_connection::send_queued_messages_task() calling message_oriented_connection::send_message() "
@@ -330,18 +349,20 @@ namespace graphene { namespace net
         {
           elog("message_oriented_exception::send_message() threw an unhandled exception");
         }
-        _queued_messages.front()->transmission_finish_time = fc::time_point::now();
-        _total_queued_messages_size -= _queued_messages.front()->get_size_in_queue();
-        _queued_messages.pop();
+        _queued_messages.front().transmission_finish_time = fc::time_point::now();
+        _total_queued_messages_size -= _queued_messages.front().get_size_in_queue();
+        _queued_messages.pop_front();
       }
       //dlog("leaving peer_connection::send_queued_messages_task() due to queue exhaustion");
     }
 
-    void peer_connection::send_queueable_message(std::unique_ptr<queued_message>&& message_to_send)
+    void peer_connection::send_queueable_message(queued_message&& message_to_send)
     {
       VERIFY_CORRECT_THREAD();
-      _total_queued_messages_size += message_to_send->get_size_in_queue();
-      _queued_messages.emplace(std::move(message_to_send));
+      _total_queued_messages_size += message_to_send.get_size_in_queue();
+      if (_queued_messages.full())
+        _queued_messages.set_capacity(std::max<size_t>(2 * _queued_messages.capacity(), GRAPHENE_NET_INITIAL_SEND_QUEUE_CAPACITY));
+      _queued_messages.push_back(std::move(message_to_send));
       if (_total_queued_messages_size > GRAPHENE_NET_MAXIMUM_QUEUED_MESSAGES_IN_BYTES)
       {
         elog("send queue exceeded maximum size of ${max} bytes (current size ${current} bytes)",
@@ -374,8 +395,13 @@ namespace graphene { namespace net
       VERIFY_CORRECT_THREAD();
       //dlog("peer_connection::send_message() enqueueing message of type ${type} for peer ${endpoint}",
       //     ("type", message_to_send.msg_type)("endpoint", get_remote_endpoint()));
-      std::unique_ptr<queued_message> message_to_enqueue(new real_queued_message(message_to_send, message_send_time_field_offset));
-      send_queueable_message(std::move(message_to_enqueue));
+      send_queueable_message(queued_message(std::make_shared<message>(message_to_send), message_send_time_field_offset));
+    }
+
+    void peer_connection::send_message(shared_message_ptr message_to_send)
+    {
+      VERIFY_CORRECT_THREAD();
+      send_queueable_message(queued_message(std::move(message_to_send)));
     }
 
     void peer_connection::send_item(const item_id& item_to_send)
@@ -383,8 +409,7 @@ namespace graphene { namespace net
       VERIFY_CORRECT_THREAD();
       //dlog("peer_connection::send_item() enqueueing message of type ${type} for peer ${endpoint}",
       //     ("type", item_to_send.item_type)("endpoint", get_remote_endpoint()));
-      std::unique_ptr<queued_message> message_to_enqueue(new virtual_queued_message(item_to_send));
-      send_queueable_message(std::move(message_to_enqueue));
+      send_queueable_message(queued_message(item_to_send));
     }
 
     void peer_connection::close_connection()
@@ -427,6 +452,28 @@ namespace graphene { namespace net
       return _message_connection.get_last_message_received_time();
     }
 
+    size_t peer_connection::get_queued_message_count() const
+    {
+      VERIFY_CORRECT_THREAD();
+      return _queued_messages.size();
+    }
+
+    size_t peer_connection::get_total_queued_messages_size() const
+    {
+      VERIFY_CORRECT_THREAD();
+      return _total_queued_messages_size;
+    }
+
+    void peer_connection::record_item_fetch_latency(const fc::time_point& request_time)
+    {
+      VERIFY_CORRECT_THREAD();
+      fc::microseconds latency = fc::time_point::now() - request_time;
+      ++requested_items_received;
+      total_item_fetch_latency += latency;
+      if (latency > max_item_fetch_latency)
+        max_item_fetch_latency = latency;
+    }
+
     fc::optional<fc::ip::endpoint> peer_connection::get_remote_endpoint()
     {
       VERIFY_CORRECT_THREAD();
@@ -36,6 +36,11 @@
 #include <graphene/net/peer_database.hpp>
 #include <graphene/net/config.hpp>
 
+#include <fstream>
+
+#define PEER_DATABASE_LOG_READ  (std::ios::in | std::ios::binary)
+#define PEER_DATABASE_LOG_WRITE (std::ios::out | std::ios::binary | std::ios::app)
+
 namespace graphene { namespace net {
   namespace detail
   {
@@ -57,9 +62,32 @@ namespace graphene { namespace net {
                                                                            &potential_peer_record::endpoint>, 
                                                                     std::hash<fc::ip::endpoint> > > > potential_peer_set;
 
+      /**
+       * The database file is a log of fc::raw packed changes: a header followed by entries of
+       * [ entry_type | payload size | payload ].  Every change is appended and flushed as it happens,
+       * so a crash loses nothing and opening just replays the log.  When the log holds many more entries
+       * than there are peers, it is rewritten as one `put` per peer.
+       */
+      enum log_entry_type : uint8_t
+      {
+        put_entry   = 0, // payload is a potential_peer_record
+        erase_entry = 1, // payload is an fc::ip::endpoint
+        clear_entry = 2  // no payload
+      };
+      static const uint32_t log_magic   = 0x52454550; // "PEER"
+      static const uint32_t log_version = 1;
+
     private:
       potential_peer_set     _potential_peer_set;
       fc::path _peer_database_filename;
+      std::fstream _log_stream;
+      uint64_t _log_entry_count = 0;
+
+      void replay_log();
+      void import_json_database(const fc::path& json_filename);
+      void append_log_entry(log_entry_type type, const std::vector<char>& payload);
+      void compact_log();
+      void prune();
 
     public:
       void open(const fc::path& databaseFilename);
@@ -90,60 +118,238 @@ namespace graphene { namespace net {
     void peer_database_impl::open(const fc::path& peer_database_filename)
     {
       _peer_database_filename = peer_database_filename;
-      if (fc::exists(_peer_database_filename))
+      _potential_peer_set.clear();
+      _log_entry_count = 0;
+
+      fc::path json_filename(_peer_database_filename);
+      json_filename.replace_extension(".json");
+
+      try
+      {
+        fc::path peer_database_filename_dir = _peer_database_filename.parent_path();
+        if (!fc::exists(peer_database_filename_dir))
+          fc::create_directories(peer_database_filename_dir);
+
+        if (fc::exists(_peer_database_filename))
+          replay_log();
+        else if (json_filename != _peer_database_filename && fc::exists(json_filename))
+          import_json_database(json_filename);
+      }
+      catch (const fc::exception& e)
+      {
+        elog("error opening peer database file ${peer_database_filename}, starting with a clean database: ${e}",
+             ("peer_database_filename", _peer_database_filename)("e", e.to_detail_string()));
+        _potential_peer_set.clear();
+      }
+
+      prune();
+      try
       {
-        try
+        // start from a compact log, this also creates the file (with its header) if it didn't exist
+        compact_log();
+      }
+      catch (const fc::exception& e)
+      {
+        // keep running with the peers we loaded, they just won't be saved
+        elog("error writing peer database file ${peer_database_filename}: ${e}",
+             ("peer_database_filename", _peer_database_filename)("e", e.to_detail_string()));
+      }
+    }
+
+    void peer_database_impl::replay_log()
+    {
+      std::fstream log_stream(_peer_database_filename.generic_string().c_str(), PEER_DATABASE_LOG_READ);
+      uint32_t magic = 0;
+      uint32_t version = 0;
+      log_stream.read((char*)&magic, sizeof(magic));
+      log_stream.read((char*)&version, sizeof(version));
+      FC_ASSERT(log_stream && magic == log_magic && version == log_version,
+                "${f} is not a peer database", ("f", _peer_database_filename));
+
+      std::vector<char> payload;
+      while (true)
+      {
+        uint8_t type;
+        uint32_t payload_size;
+        log_stream.read((char*)&type, sizeof(type));
+        log_stream.read((char*)&payload_size, sizeof(payload_size));
+        if (!log_stream || payload_size > MAX_MESSAGE_SIZE)
+          break;
+        payload.resize(payload_size);
+        log_stream.read(payload.data(), payload_size);
+        if (!log_stream)
         {
-          std::vector<potential_peer_record> peer_records = fc::json::from_file(_peer_database_filename).as<std::vector<potential_peer_record> >();
-          std::copy(peer_records.begin(), peer_records.end(), std::inserter(_potential_peer_set, _potential_peer_set.end()));
+          // the last entry was only partially written, we crashed while appending it
+          wlog("ignoring truncated entry at the end of peer database ${f}", ("f", _peer_database_filename));
+          break;
+        }
 
-          if (_potential_peer_set.size() > GRAPHENE_NET_MAX_PEERDB_SIZE)
-          {
-            // prune database to a reasonable size
-            auto iter = _potential_peer_set.begin();
-            std::advance(iter, GRAPHENE_NET_MAX_PEERDB_SIZE);
-            _potential_peer_set.erase(iter, _potential_peer_set.end());
-          }
+        switch (type)
+        {
+        case put_entry:
+        {
+          potential_peer_record record = fc::raw::unpack<potential_peer_record>(payload);
+          auto iter = _potential_peer_set.get<endpoint_index>().find(record.endpoint);
+          if (iter != _potential_peer_set.get<endpoint_index>().end())
+            _potential_peer_set.get<endpoint_index>().replace(iter, record);
+          else
+            _potential_peer_set.get<endpoint_index>().insert(record);
+          break;
+        }
+        case erase_entry:
+          _potential_peer_set.get<endpoint_index>().erase(fc::raw::unpack<fc::ip::endpoint>(payload));
+          break;
+        case clear_entry:
+          _potential_peer_set.clear();
+          break;
+        default:
+          FC_THROW("unknown entry type ${type} in peer database ${f}", ("type", type)("f", _peer_database_filename));
+        }
+        ++_log_entry_count;
+      }
+      dlog("loaded ${n} peers from ${entries} entries in ${f}",
+           ("n", _potential_peer_set.size())("entries", _log_entry_count)("f", _peer_database_filename));
+    }
+
+    void peer_database_impl::import_json_database(const fc::path& json_filename)
+    {
+      ilog("converting peer database ${json} to ${f}", ("json", json_filename)("f", _peer_database_filename));
+      std::vector<potential_peer_record> peer_records = fc::json::from_file(json_filename).as<std::vector<potential_peer_record> >();
+      std::copy(peer_records.begin(), peer_records.end(), std::inserter(_potential_peer_set, _potential_peer_set.end()));
+    }
+
+    void peer_database_impl::prune()
+    {
+      if (_potential_peer_set.size() > GRAPHENE_NET_MAX_PEERDB_SIZE)
+      {
+        // prune database to a reasonable size
+        auto iter = _potential_peer_set.begin();
+        std::advance(iter, GRAPHENE_NET_MAX_PEERDB_SIZE);
+        _potential_peer_set.erase(iter, _potential_peer_set.end());
+      }
+    }
+
+    void peer_database_impl::compact_log()
+    {
+      if (_peer_database_filename.string().empty())
+        return;
+
+      if (_log_stream.is_open())
+        _log_stream.close();
+
+      fc::path temporary_filename(_peer_database_filename);
+      temporary_filename.replace_extension(".tmp");
+      try
+      {
+        std::fstream compacted_stream(temporary_filename.generic_string().c_str(),
+                                      std::ios::out | std::ios::binary | std::ios::trunc);
+        const uint32_t magic = log_magic;
+        const uint32_t version = log_version;
+        compacted_stream.write((const char*)&magic, sizeof(magic));
+        compacted_stream.write((const char*)&version, sizeof(version));
+        for (const potential_peer_record& record : _potential_peer_set)
+        {
+          std::vector<char> payload = fc::raw::pack_to_vector(record);
+          uint8_t type = put_entry;
+          uint32_t payload_size = (uint32_t)payload.size();
+          compacted_stream.write((const char*)&type, sizeof(type));
+          compacted_stream.write((const char*)&payload_size, sizeof(payload_size));
+          compacted_stream.write(payload.data(), payload.size());
         }
-        catch (const fc::exception& e)
+        compacted_stream.flush();
+        FC_ASSERT(compacted_stream.good(), "error writing peer database ${f}", ("f", temporary_filename));
+        compacted_stream.close();
+        fc::rename(temporary_filename, _peer_database_filename);
+      }
+      catch (const fc::exception&)
+      {
+        // keep appending to the log we had, if there is one
+        if (fc::exists(_peer_database_filename))
+          _log_stream.open(_peer_database_filename.generic_string().c_str(), PEER_DATABASE_LOG_WRITE);
+        throw;
+      }
+      _log_entry_count = _potential_peer_set.size();
+
+      _log_stream.open(_peer_database_filename.generic_string().c_str(), PEER_DATABASE_LOG_WRITE);
+    }
+
+    void peer_database_impl::append_log_entry(log_entry_type type, const std::vector<char>& payload)
+    {
+      if (!_log_stream.is_open())
+        return;
+
+      try
+      {
+        // rewrite the log once most of it describes peers that were since updated or erased
+        if (_log_entry_count > 2 * _potential_peer_set.size() + GRAPHENE_NET_MAX_PEERDB_SIZE)
+        {
+          compact_log();
+          return;
+        }
+
+        uint32_t payload_size = (uint32_t)payload.size();
+        _log_stream.write((const char*)&type, sizeof(type));
+        _log_stream.write((const char*)&payload_size, sizeof(payload_size));
+        _log_stream.write(payload.data(), payload.size());
+        _log_stream.flush();
+        if (!_log_stream.good())
         {
-          elog("error opening peer database file ${peer_database_filename}, starting with a clean database", 
+          // the entry may be partially written, replace the log by one written from the peers we have
+          elog("error writing to peer database ${peer_database_filename}, rewriting it",
                ("peer_database_filename", _peer_database_filename));
+          _log_stream.close();
+          try
+          {
+            compact_log();
+          }
+          catch (const fc::exception&)
+          {
+            // don't append after what may be a partial entry, close() tries to save the peers again
+            _log_stream.close();
+            throw;
+          }
+          return;
         }
+        ++_log_entry_count;
+      }
+      catch (const fc::exception& e)
+      {
+        elog("error writing to peer database ${peer_database_filename}: ${e}",
+             ("peer_database_filename", _peer_database_filename)("e", e.to_detail_string()));
       }
     }
 
     void peer_database_impl::close()
     {
-      std::vector<potential_peer_record> peer_records;
-      peer_records.reserve(_potential_peer_set.size());
-      std::copy(_potential_peer_set.begin(), _potential_peer_set.end(), std::back_inserter(peer_records));
-
       try
       {
-        fc::path peer_database_filename_dir = _peer_database_filename.parent_path();
-        if (!fc::exists(peer_database_filename_dir))
-          fc::create_directories(peer_database_filename_dir);
-        fc::json::save_to_file(peer_records, _peer_database_filename);
+        prune();
+        compact_log();
       }
       catch (const fc::exception& e)
       {
-        elog("error saving peer database to file ${peer_database_filename}", 
+        elog("error saving peer database to file ${peer_database_filename}",
              ("peer_database_filename", _peer_database_filename));
       }
+      if (_log_stream.is_open())
+        _log_stream.close();
       _potential_peer_set.clear();
     }
 
     void peer_database_impl::clear()
     {
       _potential_peer_set.clear();
+      append_log_entry(clear_entry, std::vector<char>());
     }
 
     void peer_database_impl::erase(const fc::ip::endpoint& endpointToErase)
     {
       auto iter = _potential_peer_set.get<endpoint_index>().find(endpointToErase);
       if (iter != _potential_peer_set.get<endpoint_index>().end())
+      {
         _potential_peer_set.get<endpoint_index>().erase(iter);
+        append_log_entry(erase_entry, fc::raw::pack_to_vector(endpointToErase));
+      }
     }
 
     void peer_database_impl::update_entry(const potential_peer_record& updatedRecord)
@@ -153,6 +359,7 @@ namespace graphene { namespace net {
         _potential_peer_set.get<endpoint_index>().modify(iter, [&updatedRecord](potential_peer_record& record) { record = updatedRecord; });
       else
         _potential_peer_set.get<endpoint_index>().insert(updatedRecord);
+      append_log_entry(put_entry, fc::raw::pack_to_vector(updatedRecord));
     }
 
     potential_peer_record peer_database_impl::lookup_or_create_entry_for_endpoint(const fc::ip::endpoint& endpointToLookup)
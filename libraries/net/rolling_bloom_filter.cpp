@@ -0,0 +1,97 @@
+#include <graphene/net/rolling_bloom_filter.hpp>
+
+#include <fc/crypto/rand.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace graphene { namespace net {
+
+  rolling_bloom_filter::rolling_bloom_filter( uint32_t items_per_generation, double false_positive_rate ) :
+    _items_per_generation( items_per_generation )
+  {
+    FC_ASSERT( items_per_generation > 0 );
+    FC_ASSERT( false_positive_rate > 0 && false_positive_rate < 1 );
+
+    // a lookup checks both generations, so each of them gets half of the false positive budget
+    const double per_generation_rate = false_positive_rate / 2;
+    const double ln2 = std::log( 2.0 );
+    const double bits_per_item = -std::log( per_generation_rate ) / ( ln2 * ln2 );
+
+    _hash_count = std::max< uint32_t >( 1, std::min< uint32_t >( 50, uint32_t( std::round( bits_per_item * ln2 ) ) ) );
+    // round up to whole 64-bit words
+    _bits_per_generation = uint32_t( ( uint64_t( std::ceil( bits_per_item * items_per_generation ) ) + 63 ) / 64 * 64 );
+
+    _generations[0].resize( _bits_per_generation / 64 );
+    _generations[1].resize( _bits_per_generation / 64 );
+    _positions.resize( _hash_count );
+
+    fc::rand_pseudo_bytes( (char*)&_salt, sizeof( _salt ) );
+  }
+
+  void rolling_bloom_filter::compute_bit_positions( const fc::ripemd160& hash, std::vector< uint32_t >& positions ) const
+  {
+    // double hashing: position i is h1 + i * h2, where h1 and h2 come from the digest itself
+    uint64_t h1, h2;
+    memcpy( &h1, hash.data(), sizeof( h1 ) );
+    memcpy( &h2, hash.data() + sizeof( h1 ), sizeof( h2 ) );
+    h1 ^= _salt;
+    h2 = ( h2 ^ ( _salt * 0x9e3779b97f4a7c15ULL ) ) | 1;
+
+    for( uint32_t i = 0; i < _hash_count; ++i )
+      positions[i] = uint32_t( ( h1 + i * h2 ) % _bits_per_generation );
+  }
+
+  bool rolling_bloom_filter::test_generation( const std::vector< uint64_t >& bits, const std::vector< uint32_t >& positions ) const
+  {
+    for( uint32_t position : positions )
+      if( !( bits[ position / 64 ] & ( uint64_t( 1 ) << ( position % 64 ) ) ) )
+        return false;
+    return true;
+  }
+
+  void rolling_bloom_filter::insert( const fc::ripemd160& hash )
+  {
+    if( _items_in_current_generation >= _items_per_generation )
+    {
+      _current_generation ^= 1;
+      std::fill( _generations[ _current_generation ].begin(), _generations[ _current_generation ].end(), 0 );
+      _items_in_current_generation = 0;
+      ++_statistics.generations_rotated;
+    }
+
+    compute_bit_positions( hash, _positions );
+    std::vector< uint64_t >& bits = _generations[ _current_generation ];
+    for( uint32_t position : _positions )
+      bits[ position / 64 ] |= uint64_t( 1 ) << ( position % 64 );
+
+    ++_items_in_current_generation;
+    ++_statistics.inserts;
+  }
+
+  bool rolling_bloom_filter::contains( const fc::ripemd160& hash )
+  {
+    ++_statistics.lookups;
+    compute_bit_positions( hash, _positions );
+    bool found = test_generation( _generations[ _current_generation ], _positions ) ||
+                 test_generation( _generations[ _current_generation ^ 1 ], _positions );
+    if( found )
+      ++_statistics.hits;
+    return found;
+  }
+
+  void rolling_bloom_filter::clear()
+  {
+    for( auto& generation : _generations )
+      std::fill( generation.begin(), generation.end(), 0 );
+    _items_in_current_generation = 0;
+  }
+
+  size_t rolling_bloom_filter::get_memory_usage() const
+  {
+    return 2 * _bits_per_generation / 8;
+  }
+
+} } // graphene::net
@@ -5,6 +5,7 @@
 #include <sophiatx/protocol/transaction.hpp>
 #include <sophiatx/protocol/block_header.hpp>
 
+#include <sophiatx/plugins/json_rpc/binary_rpc.hpp>
 #include <sophiatx/plugins/json_rpc/utility.hpp>
 
 namespace sophiatx { namespace plugins { namespace block_api {
@@ -46,3 +47,5 @@ FC_REFLECT( sophiatx::plugins::block_api::get_block_args,
 FC_REFLECT( sophiatx::plugins::block_api::get_block_return,
    (block) )
 
+JSON_RPC_BINARY_METHOD( sophiatx::plugins::block_api::get_block_args )
+
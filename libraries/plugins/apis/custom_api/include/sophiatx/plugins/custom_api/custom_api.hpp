@@ -1,4 +1,5 @@
 #pragma once
+#include <sophiatx/plugins/json_rpc/binary_rpc.hpp>
 #include <sophiatx/plugins/json_rpc/utility.hpp>
 
 #include <sophiatx/chain/custom_content_object.hpp>
@@ -87,3 +88,5 @@ FC_REFLECT( sophiatx::plugins::custom::get_received_documents_args,
 
 FC_REFLECT( sophiatx::plugins::custom::get_received_documents_return,
             (history) )
+
+JSON_RPC_BINARY_METHOD( sophiatx::plugins::custom::get_received_documents_args )
@@ -47,6 +47,9 @@ class database_api_impl
          (get_application_buyings)
          (get_promotion_pool_balance)
          (get_burned_balance)
+         (get_pending_transactions)
+         (get_state_digest)
+         (get_block_profile)
       )
 
       template< typename ResultType >
@@ -691,6 +694,44 @@ DEFINE_API_IMPL( database_api_impl, get_burned_balance )
    return asset(_db.get_economic_model().burn_pool, SOPHIATX_SYMBOL);
 }
 
+DEFINE_API_IMPL( database_api_impl, get_pending_transactions )
+{
+   FC_ASSERT( args.limit <= DATABASE_API_SINGLE_QUERY_LIMIT );
+
+   const auto& pool = _db.get_pending_transactions();
+   get_pending_transactions_return result;
+   result.statistics = pool.get_statistics();
+
+   for( const auto& tx : pool.get< chain::pending_transaction_pool::by_priority >() )
+   {
+      if( result.transactions.size() >= args.limit )
+         break;
+      if( args.fee_payer.valid() && tx.fee_payer != *args.fee_payer )
+         continue;
+      result.transactions.push_back( tx );
+   }
+
+   return result;
+}
+
+DEFINE_API_IMPL( database_api_impl, get_state_digest )
+{
+   FC_ASSERT( _db.get_state_digest_history(), "State digest is disabled, set state-digest-history to enable it" );
+
+   uint32_t block_num = args.block_num.valid() ? *args.block_num : _db.head_block_num();
+   auto result = _db.find_state_digest( block_num );
+   FC_ASSERT( result.valid(), "State digest is only kept for the last ${n} blocks applied since startup, block ${b} is not among them",
+              ("n", _db.get_state_digest_history())("b", block_num) );
+   return *result;
+}
+
+DEFINE_API_IMPL( database_api_impl, get_block_profile )
+{
+   auto result = _db.get_block_profile();
+   FC_ASSERT( result.enabled, "Block profiling is disabled, set profile-blocks to enable it" );
+   return result;
+}
+
 #ifdef SOPHIATX_ENABLE_SMT
 //////////////////////////////////////////////////////////////////////
 //                                                                  //
@@ -738,6 +779,9 @@ DEFINE_READ_APIS( database_api,
    (get_application_buyings)
    (get_promotion_pool_balance)
    (get_burned_balance)
+   (get_pending_transactions)
+   (get_state_digest)
+   (get_block_profile)
 )
 
 } } } // sophiatx::plugins::database_api
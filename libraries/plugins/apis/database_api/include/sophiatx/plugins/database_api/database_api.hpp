@@ -119,6 +119,23 @@ class database_api
           * Get amount of SPHTX burned
           */
          (get_burned_balance)
+
+         /**
+          * @brief List the transactions waiting for a block, best paying first, optionally only those paid for by one account
+          */
+         (get_pending_transactions)
+
+         /**
+          * @brief Get the digest of the consensus state after a recent block, the head block by default.
+          * Requires state-digest-history to be enabled.
+          */
+         (get_state_digest)
+
+         /**
+          * @brief Get the time spent in each phase of applying blocks, in each operation type and in the signal
+          * handlers of each plugin since profiling was enabled. Requires profile-blocks to be enabled.
+          */
+         (get_block_profile)
       )
 
    private:
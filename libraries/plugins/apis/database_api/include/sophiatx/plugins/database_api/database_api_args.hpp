@@ -348,6 +348,30 @@ typedef asset get_promotion_pool_balance_return;
 
 typedef void_type get_burned_balance_args;
 typedef asset get_burned_balance_return;
+
+struct get_pending_transactions_args
+{
+   fc::optional< account_name_type > fee_payer;
+   uint32_t                          limit = 1000; // DATABASE_API_SINGLE_QUERY_LIMIT
+};
+
+struct get_pending_transactions_return
+{
+   chain::pending_transaction_pool::statistics statistics;
+   /// best paying first
+   vector< chain::pending_transaction >        transactions;
+};
+
+struct get_state_digest_args
+{
+   fc::optional< uint32_t > block_num;
+};
+
+typedef chain::state_digest get_state_digest_return;
+
+typedef void_type get_block_profile_args;
+typedef chain::block_profile get_block_profile_return;
+
 #ifdef SOPHIATX_ENABLE_SMT
 typedef void_type get_smt_next_identifier_args;
 
@@ -501,6 +525,15 @@ FC_REFLECT( sophiatx::plugins::database_api::get_application_buyings_args,
 FC_REFLECT( sophiatx::plugins::database_api::get_application_buyings_return,
             (application_buyings) )
 
+FC_REFLECT( sophiatx::plugins::database_api::get_pending_transactions_args,
+            (fee_payer)(limit) )
+
+FC_REFLECT( sophiatx::plugins::database_api::get_pending_transactions_return,
+            (statistics)(transactions) )
+
+FC_REFLECT( sophiatx::plugins::database_api::get_state_digest_args,
+            (block_num) )
+
 #ifdef SOPHIATX_ENABLE_SMT
 FC_REFLECT( sophiatx::plugins::database_api::get_smt_next_identifier_return,
    (nais) )
@@ -10,6 +10,8 @@
 #include <sophiatx/chain/database.hpp>
 #include <sophiatx/chain/application_object.hpp>
 
+#include <sophiatx/plugins/block_api/block_api_objects.hpp>
+
 namespace sophiatx { namespace plugins { namespace database_api {
 
 using namespace sophiatx::chain;
@@ -266,6 +268,13 @@ struct api_signed_block_object : public signed_block
       for( const signed_transaction& tx : transactions )
          transaction_ids.push_back( tx.id() );
    }
+   /// takes the fields over from the block_api object without recomputing the ids and the signee
+   api_signed_block_object( block_api::api_signed_block_object&& block ) :
+      signed_block( std::move( static_cast< signed_block& >( block ) ) ),
+      block_id( block.block_id ),
+      signing_key( block.signing_key ),
+      transaction_ids( std::move( block.transaction_ids ) )
+   {}
    api_signed_block_object() {}
 
    block_id_type                 block_id;
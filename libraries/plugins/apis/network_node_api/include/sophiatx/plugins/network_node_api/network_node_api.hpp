@@ -0,0 +1,31 @@
+#pragma once
+#include <sophiatx/plugins/json_rpc/utility.hpp>
+
+#include <graphene/net/node.hpp>
+
+namespace sophiatx { namespace plugins { namespace network_node_api {
+
+namespace detail { class network_node_api_impl; }
+
+typedef json_rpc::void_type get_network_telemetry_args;
+typedef graphene::net::network_telemetry get_network_telemetry_return;
+
+class network_node_api
+{
+   public:
+      network_node_api();
+      ~network_node_api();
+
+      DECLARE_API(
+         /**
+          * Per-peer traffic, queue depth, round-trip and item fetch latency, blocks and transactions
+          * exchanged, and the call time histograms of the p2p node's delegate methods.
+          */
+         (get_network_telemetry)
+      )
+
+   private:
+      std::unique_ptr< detail::network_node_api_impl > my;
+};
+
+} } } // sophiatx::plugins::network_node_api
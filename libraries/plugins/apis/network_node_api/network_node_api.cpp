@@ -0,0 +1,38 @@
+#include <sophiatx/plugins/network_node_api/network_node_api_plugin.hpp>
+#include <sophiatx/plugins/network_node_api/network_node_api.hpp>
+
+namespace sophiatx { namespace plugins { namespace network_node_api {
+
+namespace detail {
+
+class network_node_api_impl
+{
+   public:
+      network_node_api_impl() : _p2p( appbase::app().get_plugin< sophiatx::plugins::p2p::p2p_plugin >() ) {}
+
+      DECLARE_API_IMPL(
+         (get_network_telemetry)
+      )
+
+      sophiatx::plugins::p2p::p2p_plugin& _p2p;
+};
+
+DEFINE_API_IMPL( network_node_api_impl, get_network_telemetry )
+{
+   return _p2p.get_network_telemetry();
+}
+
+} // detail
+
+network_node_api::network_node_api() : my( new detail::network_node_api_impl() )
+{
+   JSON_RPC_REGISTER_API( SOPHIATX_NETWORK_NODE_API_PLUGIN_NAME );
+}
+
+network_node_api::~network_node_api() {}
+
+DEFINE_LOCKLESS_APIS( network_node_api,
+   (get_network_telemetry)
+)
+
+} } } // sophiatx::plugins::network_node_api
@@ -5,6 +5,8 @@
 
 #include <sophiatx/utilities/benchmark_dumper.hpp>
 
+#include <sophiatx/protocol/signature_cache.hpp>
+
 #include <sophiatx/egenesis/egenesis.hpp>
 
 #include <fc/string.hpp>
@@ -80,7 +82,17 @@ class chain_plugin_impl
       bool                             dump_memory_details = false;
       uint32_t                         stop_replay_at = 0;
       uint32_t                         benchmark_interval = 0;
+      bfs::path                        replay_report;
+      uint32_t                         replay_report_interval = 0;
       uint32_t                         flush_interval = 0;
+      uint32_t                         max_pending_transactions = 0;
+      uint32_t                         max_pending_transactions_per_account = 0;
+      bool                             store_recent_transactions = false;
+      uint32_t                         block_prevalidation_threads = 0;
+      uint32_t                         state_digest_history = 0;
+      uint32_t                         invariant_audit_interval = 0;
+      bool                             profile_blocks = false;
+      uint32_t                         plugin_handler_budget_us = 0;
       genesis_state_type               genesis;
       flat_map<uint32_t,block_id_type> loaded_checkpoints;
 
@@ -102,6 +114,8 @@ struct write_request_visitor
    database* db;
    uint32_t  skip = 0;
    fc::optional< fc::exception >* except;
+   /// log the block profile every this many blocks, 0 never
+   uint32_t  profile_log_interval = 0;
 
    typedef bool result_type;
 
@@ -112,6 +126,9 @@ struct write_request_visitor
       try
       {
          result = db->push_block( *block, skip );
+
+         if( profile_log_interval && block->block_num() % profile_log_interval == 0 )
+            ilog( "Block profile at block ${n}: ${p}", ("n", block->block_num())("p", db->get_block_profile()) );
       }
       catch( fc::exception& e )
       {
@@ -196,6 +213,7 @@ void chain_plugin_impl::start_write_processing()
       fc::time_point_sec start = fc::time_point::now();
       write_request_visitor req_visitor;
       req_visitor.db = &db;
+      req_visitor.profile_log_interval = profile_blocks ? benchmark_interval : 0;
 
       request_promise_visitor prom_visitor;
 
@@ -296,6 +314,24 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
          ("checkpoint,c", bpo::value<vector<string>>()->composing(), "Pairs of [BLOCK_NUM,BLOCK_ID] that should be enforced as checkpoints.")
          ("flush-state-interval", bpo::value<uint32_t>(),
             "flush shared memory changes to disk every N blocks")
+         ("signature-cache-size", bpo::value<uint32_t>()->default_value(65536),
+            "Number of public keys recovered from transaction signatures to keep, so transactions seen in the mempool are not recovered again when they arrive in a block. 0 disables the cache.")
+         ("max-pending-transactions", bpo::value<uint32_t>()->default_value(50000),
+            "Maximum number of transactions waiting for a block. When full, the transaction paying the lowest fee per byte is evicted for a better paying one. 0 is unlimited.")
+         ("max-pending-transactions-per-account", bpo::value<uint32_t>()->default_value(0),
+            "Maximum number of transactions waiting for a block that a single account pays the fees of. 0 is unlimited.")
+         ("store-recent-transactions", bpo::bool_switch()->default_value(false),
+            "Keep the body of transactions included in blocks until they expire, so they can be served to peers and APIs after they left the pending pool.")
+         ("block-prevalidation-threads", bpo::value<uint32_t>()->default_value(2),
+            "Number of threads validating block transactions and recovering their signatures before the block is applied. 0 checks them on the applying thread.")
+         ("invariant-audit-interval", bpo::value<uint32_t>()->default_value(0),
+            "Every N blocks, recompute the supply totals checked after each block by scanning all accounts and escrows. 0 only does it on startup with validate-database-invariants.")
+         ("state-digest-history", bpo::value<uint32_t>()->default_value(0),
+            "Maintain a digest of the consensus state and keep it for this many recent blocks, so nodes can be compared through get_state_digest. 0 disables it.")
+         ("profile-blocks", bpo::bool_switch()->default_value(false),
+            "Time each phase of applying blocks, each operation type and each plugin signal handler. Reported by get_block_profile and logged every set-benchmark-interval blocks.")
+         ("plugin-handler-budget-us", bpo::value<uint32_t>()->default_value(0),
+            "Log a warning whenever a plugin handler of an operation, transaction or block signal runs longer than this many microseconds. 0 disables it.")
          ;
    cli.add_options()
          ("replay-blockchain", bpo::bool_switch()->default_value(false), "clear chain database and replay all blocks" )
@@ -303,6 +339,8 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
          ("stop-replay-at-block", bpo::value<uint32_t>(), "Stop and exit after reaching given block number")
          ("set-benchmark-interval", bpo::value<uint32_t>(), "Print time and memory usage every given number of blocks")
          ("dump-memory-details", bpo::bool_switch()->default_value(false), "Dump database objects memory usage info. Use set-benchmark-interval to set dump interval.")
+         ("replay-report", bpo::value<bfs::path>(), "Write replay throughput and per-index object counts and bytes to this file as JSON lines. Relative to the data dir.")
+         ("replay-report-interval", bpo::value<uint32_t>()->default_value(100000), "Number of replayed blocks covered by each line of the replay report")
          ("check-locks", bpo::bool_switch()->default_value(false), "Check correctness of chainbase locking" )
          ("validate-database-invariants", bpo::bool_switch()->default_value(false), "Validate all supply invariants check out" )
          ;
@@ -361,12 +399,28 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
    my->check_locks         = options.at( "check-locks" ).as< bool >();
    my->validate_invariants = options.at( "validate-database-invariants" ).as<bool>();
    my->dump_memory_details = options.at( "dump-memory-details" ).as<bool>();
+   if( options.count( "replay-report" ) )
+   {
+      auto report = options.at( "replay-report" ).as<bfs::path>();
+      my->replay_report = report.is_relative() ? app().data_dir() / report : report;
+   }
+   my->replay_report_interval = options.at( "replay-report-interval" ).as<uint32_t>();
    my->genesis             = initial_state();
    if( options.count( "flush-state-interval" ) )
       my->flush_interval = options.at( "flush-state-interval" ).as<uint32_t>();
    else
       my->flush_interval = 10000;
 
+   sophiatx::protocol::recovered_signature_cache::instance().set_capacity( options.at( "signature-cache-size" ).as<uint32_t>() );
+   my->max_pending_transactions = options.at( "max-pending-transactions" ).as<uint32_t>();
+   my->max_pending_transactions_per_account = options.at( "max-pending-transactions-per-account" ).as<uint32_t>();
+   my->store_recent_transactions = options.at( "store-recent-transactions" ).as<bool>();
+   my->block_prevalidation_threads = options.at( "block-prevalidation-threads" ).as<uint32_t>();
+   my->state_digest_history = options.at( "state-digest-history" ).as<uint32_t>();
+   my->invariant_audit_interval = options.at( "invariant-audit-interval" ).as<uint32_t>();
+   my->profile_blocks = options.at( "profile-blocks" ).as<bool>();
+   my->plugin_handler_budget_us = options.at( "plugin-handler-budget-us" ).as<uint32_t>();
+
    if(options.count("checkpoint"))
    {
       auto cps = options.at("checkpoint").as<vector<string>>();
@@ -394,6 +448,13 @@ void chain_plugin::plugin_startup()
    }
 
    my->db.set_flush_interval( my->flush_interval );
+   my->db.set_pending_transaction_limits( my->max_pending_transactions, my->max_pending_transactions_per_account );
+   my->db.set_store_recent_transactions( my->store_recent_transactions );
+   my->db.set_prevalidation_threads( my->block_prevalidation_threads );
+   my->db.set_state_digest_history( my->state_digest_history );
+   my->db.set_invariant_audit_interval( my->invariant_audit_interval );
+   my->db.set_block_profiling( my->profile_blocks );
+   my->db.set_plugin_handler_budget( fc::microseconds( my->plugin_handler_budget_us ) );
    my->db.add_checkpoints( my->loaded_checkpoints );
    my->db.set_require_locking( my->check_locks );
 
@@ -425,8 +486,10 @@ void chain_plugin::plugin_startup()
    db_open_args.shared_file_scale_rate = my->shared_file_scale_rate;
    db_open_args.do_validate_invariants = my->validate_invariants;
    db_open_args.stop_replay_at = my->stop_replay_at;
+   db_open_args.replay_report = my->replay_report;
+   db_open_args.replay_report_interval = my->replay_report_interval;
 
-   auto benchmark_lambda = [&dumper, &get_indexes_memory_details, dump_memory_details] ( uint32_t current_block_number,
+   auto benchmark_lambda = [&dumper, &get_indexes_memory_details, dump_memory_details, this] ( uint32_t current_block_number,
       const chainbase::database::abstract_index_cntr_t& abstract_index_cntr )
    {
       if( current_block_number == 0 ) // initial call
@@ -457,6 +520,9 @@ void chain_plugin::plugin_startup()
          ("ct", measure.cpu_ms)
          ("cm", measure.current_mem)
          ("pm", measure.peak_mem) );
+      ilog( "Signature cache: ${s}", ("s", sophiatx::protocol::recovered_signature_cache::instance().get_statistics()) );
+      if( my->profile_blocks )
+         ilog( "Block profile: ${p}", ("p", my->db.get_block_profile()) );
    };
 
    if(my->replay)
@@ -519,6 +585,9 @@ void chain_plugin::plugin_startup()
 
 void chain_plugin::plugin_shutdown()
 {
+   ilog( "Signature cache: ${s}", ("s", sophiatx::protocol::recovered_signature_cache::instance().get_statistics()) );
+   if( my->profile_blocks )
+      ilog( "Block profile: ${p}", ("p", my->db.get_block_profile()) );
    ilog("closing chain database");
    my->stop_write_processing();
    my->db.close();
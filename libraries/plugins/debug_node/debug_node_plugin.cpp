@@ -58,7 +58,7 @@ void debug_node_plugin::plugin_initialize( const variables_map& options )
    }
 
    // connect needed signals
-   my->applied_block_connection = my->_db.applied_block.connect( 0, [this](const chain::signed_block& b){ on_applied_block(b); });
+   my->applied_block_connection = my->_db.add_applied_block_handler( [this](const chain::signed_block& b){ on_applied_block(b); }, name(), 0 );
 }
 
 void debug_node_plugin::plugin_startup()
@@ -0,0 +1,187 @@
+#include <sophiatx/plugins/json_rpc/binary_rpc_client.hpp>
+
+#include <fc/log/logger.hpp>
+#include <fc/thread/future.hpp>
+
+#include <websocketpp/config/asio_no_tls_client.hpp>
+#include <websocketpp/client.hpp>
+
+#include <atomic>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace sophiatx { namespace plugins { namespace json_rpc {
+
+namespace detail {
+
+   typedef websocketpp::client< websocketpp::config::asio_client > websocket_client_type;
+
+   class binary_rpc_client_impl
+   {
+      public:
+         void on_message( websocketpp::connection_hdl, websocket_client_type::message_ptr msg );
+         void fail_pending( const std::string& reason );
+
+         websocket_client_type                                             client;
+         websocketpp::connection_hdl                                       hdl;
+         std::thread                                                       io_thread;
+         fc::microseconds                                                  timeout;
+         std::atomic< uint64_t >                                           next_id{ 1 };
+
+         std::mutex                                                        pending_mutex;
+         std::map< uint64_t, fc::promise< binary_rpc_response >::ptr >     pending;
+         bool                                                              closed = false;
+   };
+
+   void binary_rpc_client_impl::on_message( websocketpp::connection_hdl, websocket_client_type::message_ptr msg )
+   {
+      if( msg->get_opcode() != websocketpp::frame::opcode::binary )
+         return;
+
+      binary_rpc_response response;
+      try
+      {
+         const auto& payload = msg->get_payload();
+         response = fc::raw::unpack_from_vector< binary_rpc_response >( std::vector< char >( payload.begin(), payload.end() ) );
+      }
+      catch( const fc::exception& e )
+      {
+         wlog( "Dropping binary rpc response that could not be parsed: ${e}", ("e", e.to_detail_string()) );
+         return;
+      }
+
+      fc::promise< binary_rpc_response >::ptr prom;
+      {
+         std::lock_guard< std::mutex > lock( pending_mutex );
+         auto itr = pending.find( response.id );
+         // the call may have timed out already
+         if( itr == pending.end() )
+            return;
+         prom = itr->second;
+         pending.erase( itr );
+      }
+      prom->set_value( response );
+   }
+
+   void binary_rpc_client_impl::fail_pending( const std::string& reason )
+   {
+      std::map< uint64_t, fc::promise< binary_rpc_response >::ptr > failed;
+      {
+         std::lock_guard< std::mutex > lock( pending_mutex );
+         closed = true;
+         failed.swap( pending );
+      }
+      for( auto& p : failed )
+         p.second->set_exception( std::make_shared< fc::eof_exception >( FC_LOG_MESSAGE( error, "${r}", ("r", reason) ) ) );
+   }
+
+} // detail
+
+binary_rpc_client::binary_rpc_client( const std::string& server, const fc::microseconds& timeout )
+   : my( new detail::binary_rpc_client_impl() )
+{
+   my->timeout = timeout;
+   my->client.clear_access_channels( websocketpp::log::alevel::all );
+   my->client.clear_error_channels( websocketpp::log::elevel::all );
+   my->client.init_asio();
+
+   auto opened = std::make_shared< std::promise< void > >();
+   auto opened_future = opened->get_future();
+   // the promise can be set once only, a connection may still fail after it was opened
+   auto settled = std::make_shared< std::atomic< bool > >( false );
+   my->client.set_open_handler( [opened, settled]( websocketpp::connection_hdl )
+   {
+      if( !settled->exchange( true ) )
+         opened->set_value();
+   } );
+   my->client.set_fail_handler( [this, opened, settled]( websocketpp::connection_hdl )
+   {
+      if( !settled->exchange( true ) )
+         opened->set_exception( std::make_exception_ptr( std::runtime_error( "Could not connect" ) ) );
+      my->fail_pending( "Could not connect to the node" );
+   } );
+   my->client.set_close_handler( [this]( websocketpp::connection_hdl ) { my->fail_pending( "Connection to the node closed" ); } );
+   my->client.set_message_handler( [this]( websocketpp::connection_hdl hdl, detail::websocket_client_type::message_ptr msg )
+   {
+      my->on_message( hdl, msg );
+   } );
+
+   websocketpp::lib::error_code ec;
+   auto con = my->client.get_connection( server, ec );
+   FC_ASSERT( !ec, "Invalid node endpoint ${s}: ${e}", ("s", server)("e", ec.message()) );
+   my->hdl = con->get_handle();
+   my->client.connect( con );
+   my->io_thread = std::thread( [this]() { my->client.run(); } );
+
+   try
+   {
+      FC_ASSERT( opened_future.wait_for( std::chrono::microseconds( timeout.count() ) ) == std::future_status::ready,
+                 "Timeout connecting to ${s}", ("s", server) );
+      opened_future.get();
+   }
+   catch( const std::runtime_error& )
+   {
+      my->client.stop();
+      my->io_thread.join();
+      FC_THROW( "Could not connect to ${s}", ("s", server) );
+   }
+   catch( ... )
+   {
+      my->client.stop();
+      my->io_thread.join();
+      throw;
+   }
+}
+
+binary_rpc_client::~binary_rpc_client()
+{
+   websocketpp::lib::error_code ec;
+   my->client.close( my->hdl, websocketpp::close::status::going_away, "", ec );
+   if( ec )
+      my->client.stop();
+   if( my->io_thread.joinable() )
+      my->io_thread.join();
+   my->fail_pending( "Client destroyed" );
+}
+
+bool binary_rpc_client::is_open()const
+{
+   std::lock_guard< std::mutex > lock( my->pending_mutex );
+   return !my->closed;
+}
+
+binary_rpc_response binary_rpc_client::send( binary_rpc_request& request )
+{
+   request.id = my->next_id++;
+   fc::promise< binary_rpc_response >::ptr prom( new fc::promise< binary_rpc_response >( "binary_rpc_client::send" ) );
+   {
+      std::lock_guard< std::mutex > lock( my->pending_mutex );
+      FC_ASSERT( !my->closed, "Connection to the node is closed" );
+      my->pending[ request.id ] = prom;
+   }
+
+   auto data = fc::raw::pack_to_vector( request );
+   websocketpp::lib::error_code ec;
+   my->client.send( my->hdl, data.data(), data.size(), websocketpp::frame::opcode::binary, ec );
+   if( ec )
+   {
+      std::lock_guard< std::mutex > lock( my->pending_mutex );
+      my->pending.erase( request.id );
+      FC_THROW( "Could not send ${api}.${method}: ${e}", ("api", request.api)("method", request.method)("e", ec.message()) );
+   }
+
+   try
+   {
+      return fc::future< binary_rpc_response >( prom ).wait( my->timeout );
+   }
+   catch( const fc::timeout_exception& )
+   {
+      std::lock_guard< std::mutex > lock( my->pending_mutex );
+      my->pending.erase( request.id );
+      throw;
+   }
+}
+
+} } } // sophiatx::plugins::json_rpc
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <fc/optional.hpp>
+#include <fc/reflect/reflect.hpp>
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Messages of the binary RPC transport.  Requests and responses are fc::raw packed and carried in websocket
+ * binary frames.  The arguments and the result are the fc::raw packed args and return structs of the API
+ * method, so a client has to use the types of the API it calls, e.g. block_api::get_block_args.
+ *
+ * Only the methods on the allow-list can be called this way.  A method is added to it next to its args struct
+ * with JSON_RPC_BINARY_METHOD( args_type ), all other methods stay JSON only.
+ */
+
+namespace sophiatx { namespace plugins { namespace json_rpc {
+
+struct binary_rpc_request
+{
+   /// returned in the response, to match responses to requests sent on the same connection
+   uint64_t             id = 0;
+   std::string          api;
+   std::string          method;
+   std::vector< char >  args;
+};
+
+struct binary_rpc_error
+{
+   /// one of the JSON_RPC_* codes
+   int32_t              code = 0;
+   std::string          message;
+};
+
+struct binary_rpc_response
+{
+   uint64_t                            id = 0;
+   std::vector< char >                 result;
+   fc::optional< binary_rpc_error >    error;
+};
+
+/// true for the args structs of the methods callable over the binary transport
+template< typename Args >
+struct binary_rpc_method : std::false_type {};
+
+} } } // sophiatx::plugins::json_rpc
+
+#define JSON_RPC_BINARY_METHOD( ARGS )                                                          \
+namespace sophiatx { namespace plugins { namespace json_rpc {                                   \
+   template<> struct binary_rpc_method< ARGS > : std::true_type {};                             \
+} } }
+
+FC_REFLECT( sophiatx::plugins::json_rpc::binary_rpc_request, (id)(api)(method)(args) )
+FC_REFLECT( sophiatx::plugins::json_rpc::binary_rpc_error, (code)(message) )
+FC_REFLECT( sophiatx::plugins::json_rpc::binary_rpc_response, (id)(result)(error) )
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <sophiatx/plugins/json_rpc/binary_rpc.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/io/raw_variant.hpp>
+#include <fc/time.hpp>
+
+#include <memory>
+#include <string>
+
+namespace sophiatx { namespace plugins { namespace json_rpc {
+
+namespace detail { class binary_rpc_client_impl; }
+
+/**
+ * Client of the binary RPC transport of the webserver plugin.  Several fc tasks and threads may call at once,
+ * each call waits for its own response.
+ *
+ * Ex.
+ * auto r = client.call< block_api::get_block_return >( "block_api", "get_block", block_api::get_block_args{ num } );
+ */
+class binary_rpc_client
+{
+   public:
+      /// connects to the websocket endpoint of a node, e.g. ws://127.0.0.1:9191
+      explicit binary_rpc_client( const std::string& server, const fc::microseconds& timeout = fc::seconds( 30 ) );
+      ~binary_rpc_client();
+
+      bool is_open()const;
+
+      /// Args and Ret have to be the args and return structs of the called method
+      template< typename Ret, typename Args >
+      Ret call( const std::string& api, const std::string& method, const Args& args )
+      {
+         binary_rpc_request request;
+         request.api = api;
+         request.method = method;
+         request.args = fc::raw::pack_to_vector( args );
+
+         auto response = send( request );
+         FC_ASSERT( !response.error, "${api}.${method} failed: ${e}",
+                    ("api", api)("method", method)("e", response.error->message) );
+         return fc::raw::unpack_from_vector< Ret >( response.result );
+      }
+
+   private:
+      binary_rpc_response send( binary_rpc_request& request );
+
+      std::unique_ptr< detail::binary_rpc_client_impl > my;
+};
+
+} } } // sophiatx::plugins::json_rpc
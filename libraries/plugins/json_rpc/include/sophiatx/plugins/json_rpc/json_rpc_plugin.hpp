@@ -2,7 +2,11 @@
 
 #include <appbase/application.hpp>
 
+#include <sophiatx/plugins/json_rpc/binary_rpc.hpp>
+
 #include <fc/variant.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/io/raw_variant.hpp>
 #include <fc/io/json.hpp>
 #include <fc/reflect/variant.hpp>
 #include <fc/exception/exception.hpp>
@@ -33,6 +37,10 @@
  *
  * For methods that do not require arguments, use api_void_args
  * as the argument type.
+ *
+ * Methods on the JSON_RPC_BINARY_METHOD allow-list can also be
+ * called with fc::raw packed arguments through call_binary, see
+ * binary_rpc.hpp.
  */
 
 #define SOPHIATX_JSON_RPC_PLUGIN_NAME "json_rpc"
@@ -65,6 +73,14 @@ using namespace appbase;
  */
 typedef std::function< fc::variant(const fc::variant&) > api_method;
 
+/**
+ * @brief Internal type used to bind api methods to names
+ * for the binary transport.
+ *
+ * Arguments: fc::raw packed args struct, returns the packed return struct
+ */
+typedef std::function< std::vector< char >(const std::vector< char >&) > binary_api_method;
+
 /**
  * @brief An API, containing APIs and Methods
  *
@@ -80,6 +96,14 @@ struct api_method_signature
    fc::variant ret;
 };
 
+/// Wall time spent in the successful calls of one method, in microseconds
+struct api_method_timing
+{
+   uint64_t count = 0;
+   uint64_t total_us = 0;
+   uint64_t max_us = 0;
+};
+
 namespace detail
 {
    class json_rpc_plugin_impl;
@@ -100,8 +124,16 @@ class json_rpc_plugin : public appbase::plugin< json_rpc_plugin >
       virtual void plugin_startup() override;
       virtual void plugin_shutdown() override;
 
-      void add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig );
+      void add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig,
+                           const binary_api_method& binary_api = binary_api_method() );
       string call( const string& body );
+      /// calls the method of an fc::raw packed binary_rpc_request, returns the packed binary_rpc_response
+      std::vector< char > call_binary( const std::vector< char >& body );
+
+      /// measure the calls of every method, off by default
+      void set_method_timing( bool enabled );
+      /// timing of the methods called since the last reset, by api.method name
+      std::map< string, api_method_timing > get_method_timing( bool reset = false );
 
    private:
       std::unique_ptr< detail::json_rpc_plugin_impl > my;
@@ -130,10 +162,26 @@ namespace detail {
                {
                   return fc::variant( (plugin.*method)( args.as< Args >(), true ) );
                },
-               api_method_signature{ fc::variant( Args() ), fc::variant( Ret() ) } );
+               api_method_signature{ fc::variant( Args() ), fc::variant( Ret() ) },
+               binary_method< Args >( plugin, method, binary_rpc_method< Args >() ) );
          }
 
       private:
+         template< typename Args, typename Plugin, typename Method >
+         static binary_api_method binary_method( Plugin& plugin, Method method, std::true_type )
+         {
+            return [&plugin,method]( const std::vector< char >& args ) -> std::vector< char >
+            {
+               return fc::raw::pack_to_vector( (plugin.*method)( fc::raw::unpack_from_vector< Args >( args ), true ) );
+            };
+         }
+
+         template< typename Args, typename Plugin, typename Method >
+         static binary_api_method binary_method( Plugin&, Method, std::false_type )
+         {
+            return binary_api_method();
+         }
+
          std::string _api_name;
          sophiatx::plugins::json_rpc::json_rpc_plugin& _json_rpc_plugin;
    };
@@ -143,3 +191,4 @@ namespace detail {
 } } } // sophiatx::plugins::json_rpc
 
 FC_REFLECT( sophiatx::plugins::json_rpc::api_method_signature, (args)(ret) )
+FC_REFLECT( sophiatx::plugins::json_rpc::api_method_timing, (count)(total_us)(max_us) )
@@ -10,6 +10,9 @@
 
 #include <chainbase/chainbase.hpp>
 
+#include <atomic>
+#include <mutex>
+
 #define ENABLE_JSON_RPC_LOG
 
 namespace sophiatx { namespace plugins { namespace json_rpc {
@@ -131,13 +134,16 @@ namespace detail
          json_rpc_plugin_impl();
          ~json_rpc_plugin_impl();
 
-         void add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig );
+         void add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig,
+                              const binary_api_method& binary_api );
 
          api_method* find_api_method( std::string api, std::string method );
-         api_method* process_params( string method, const fc::variant_object& request, fc::variant& func_args );
+         api_method* process_params( string method, const fc::variant_object& request, fc::variant& func_args, string& method_name );
+         void record_timing( const string& method_name, const fc::microseconds& elapsed );
          void rpc_id( const fc::variant_object& request, json_rpc_response& response );
          void rpc_jsonrpc( const fc::variant_object& request, json_rpc_response& response );
          json_rpc_response rpc( const fc::variant& message );
+         binary_rpc_response rpc_binary( const vector< char >& message );
 
          void initialize();
 
@@ -152,17 +158,25 @@ namespace detail
             (get_signature) )
 
          map< string, api_description >                     _registered_apis;
+         map< string, map< string, binary_api_method > >    _registered_binary_apis;
          vector< string >                                   _methods;
          map< string, map< string, api_method_signature > > _method_sigs;
          std::unique_ptr< json_rpc_logger >                 _logger;
+
+         std::atomic< bool >                                _timing_enabled{ false };
+         std::mutex                                         _timing_mutex;
+         map< string, api_method_timing >                   _timing;
    };
 
    json_rpc_plugin_impl::json_rpc_plugin_impl() {}
    json_rpc_plugin_impl::~json_rpc_plugin_impl() {}
 
-   void json_rpc_plugin_impl::add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig )
+   void json_rpc_plugin_impl::add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig,
+                                              const binary_api_method& binary_api )
    {
       _registered_apis[ api_name ][ method_name ] = api;
+      if( binary_api )
+         _registered_binary_apis[ api_name ][ method_name ] = binary_api;
       _method_sigs[ api_name ][ method_name ] = sig;
 
       std::stringstream canonical_name;
@@ -170,6 +184,16 @@ namespace detail
       _methods.push_back( canonical_name.str() );
    }
 
+   void json_rpc_plugin_impl::record_timing( const string& method_name, const fc::microseconds& elapsed )
+   {
+      const uint64_t us = elapsed.count();
+      std::lock_guard< std::mutex > lock( _timing_mutex );
+      auto& timing = _timing[ method_name ];
+      ++timing.count;
+      timing.total_us += us;
+      timing.max_us = std::max( timing.max_us, us );
+   }
+
    void json_rpc_plugin_impl::initialize()
    {
       JSON_RPC_REGISTER_API( "jsonrpc" );
@@ -208,7 +232,7 @@ namespace detail
       return &(method_itr->second);
    }
 
-   api_method* json_rpc_plugin_impl::process_params( string method, const fc::variant_object& request, fc::variant& func_args )
+   api_method* json_rpc_plugin_impl::process_params( string method, const fc::variant_object& request, fc::variant& func_args, string& method_name )
    {
       api_method* ret = nullptr;
 
@@ -224,6 +248,7 @@ namespace detail
          FC_ASSERT( v.size() == 2 || v.size() == 3, "params should be {\"api\", \"method\", \"args\"" );
 
          ret = find_api_method( v[0].as_string(), v[1].as_string() );
+         method_name = v[0].as_string() + "." + v[1].as_string();
 
          func_args = ( v.size() == 3 ) ? v[2] : fc::json::from_string( "{}" );
       }
@@ -235,6 +260,7 @@ namespace detail
          FC_ASSERT( v.size() == 2, "method specification invalid. Should be api.method" );
 
          ret = find_api_method( v[0], v[1] );
+         method_name = method;
 
          func_args = request.contains( "params" ) ? request[ "params" ] : fc::json::from_string( "{}" );
       }
@@ -277,10 +303,11 @@ namespace detail
                {
                   fc::variant func_args;
                   api_method* call = nullptr;
+                  string method_name;
 
                   try
                   {
-                     call = process_params( method, request, func_args );
+                     call = process_params( method, request, func_args, method_name );
                   }
                   catch( fc::assert_exception& e )
                   {
@@ -290,7 +317,12 @@ namespace detail
                   try
                   {
                      if( call )
+                     {
+                        const fc::time_point start = _timing_enabled ? fc::time_point::now() : fc::time_point();
                         response.result = (*call)( func_args );
+                        if( _timing_enabled )
+                           record_timing( method_name, fc::time_point::now() - start );
+                     }
                   }
                   catch( chainbase::lock_exception& e )
                   {
@@ -378,6 +410,64 @@ namespace detail
 
       return response;
    }
+
+   binary_rpc_response json_rpc_plugin_impl::rpc_binary( const vector< char >& message )
+   {
+      binary_rpc_response response;
+      binary_rpc_request request;
+
+      try
+      {
+         request = fc::raw::unpack_from_vector< binary_rpc_request >( message );
+         response.id = request.id;
+      }
+      catch( fc::exception& e )
+      {
+         response.error = binary_rpc_error{ JSON_RPC_PARSE_ERROR, e.to_string() };
+         return response;
+      }
+
+      binary_api_method* call = nullptr;
+      auto api_itr = _registered_binary_apis.find( request.api );
+      if( api_itr != _registered_binary_apis.end() )
+      {
+         auto method_itr = api_itr->second.find( request.method );
+         if( method_itr != api_itr->second.end() )
+            call = &method_itr->second;
+      }
+
+      if( call == nullptr )
+      {
+         response.error = binary_rpc_error{ JSON_RPC_METHOD_NOT_FOUND, "Could not find method " + request.api + "." + request.method };
+         return response;
+      }
+
+      try
+      {
+         const fc::time_point start = _timing_enabled ? fc::time_point::now() : fc::time_point();
+         response.result = (*call)( request.args );
+         if( _timing_enabled )
+            record_timing( request.api + "." + request.method, fc::time_point::now() - start );
+      }
+      catch( chainbase::lock_exception& e )
+      {
+         response.error = binary_rpc_error{ JSON_RPC_ERROR_DURING_CALL, e.what() };
+      }
+      catch( fc::exception& e )
+      {
+         response.error = binary_rpc_error{ JSON_RPC_ERROR_DURING_CALL, e.to_string() };
+      }
+      catch( std::exception& e )
+      {
+         response.error = binary_rpc_error{ JSON_RPC_SERVER_ERROR, e.what() };
+      }
+      catch( ... )
+      {
+         response.error = binary_rpc_error{ JSON_RPC_SERVER_ERROR, "Unknown error" };
+      }
+
+      return response;
+   }
 }
 
 using detail::json_rpc_error;
@@ -418,9 +508,10 @@ void json_rpc_plugin::plugin_startup()
 
 void json_rpc_plugin::plugin_shutdown() {}
 
-void json_rpc_plugin::add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig )
+void json_rpc_plugin::add_api_method( const string& api_name, const string& method_name, const api_method& api, const api_method_signature& sig,
+                                      const binary_api_method& binary_api )
 {
-   my->add_api_method( api_name, method_name, api, sig );
+   my->add_api_method( api_name, method_name, api, sig, binary_api );
 }
 
 string json_rpc_plugin::call( const string& message )
@@ -472,6 +563,27 @@ string json_rpc_plugin::call( const string& message )
 
 }
 
+void json_rpc_plugin::set_method_timing( bool enabled )
+{
+   my->_timing_enabled = enabled;
+}
+
+map< string, api_method_timing > json_rpc_plugin::get_method_timing( bool reset )
+{
+   std::lock_guard< std::mutex > lock( my->_timing_mutex );
+   map< string, api_method_timing > result;
+   if( reset )
+      result.swap( my->_timing );
+   else
+      result = my->_timing;
+   return result;
+}
+
+vector< char > json_rpc_plugin::call_binary( const vector< char >& message )
+{
+   return fc::raw::pack_to_vector( my->rpc_binary( message ) );
+}
+
 } } } // sophiatx::plugins::json_rpc
 
 FC_REFLECT( sophiatx::plugins::json_rpc::detail::json_rpc_error, (code)(message)(data) )
@@ -2,6 +2,8 @@
 
 #include <sophiatx/plugins/chain/chain_plugin.hpp>
 
+#include <graphene/net/node.hpp>
+
 #include <appbase/application.hpp>
 
 #define SOPHIATX_P2P_PLUGIN_NAME "p2p"
@@ -31,6 +33,8 @@ public:
    void broadcast_transaction( const sophiatx::protocol::signed_transaction& tx );
    void set_block_production( bool producing_blocks );
 
+   graphene::net::network_telemetry get_network_telemetry() const;
+
 private:
    std::unique_ptr< detail::p2p_plugin_impl > my;
 };
@@ -104,6 +104,7 @@ public:
    string user_agent;
    fc::mutable_variant_object config;
    uint32_t max_connections = 0;
+   fc::optional< uint32_t > io_threads;
    bool force_validate = false;
    bool block_producer = false;
    bool running = true;
@@ -485,6 +486,7 @@ void p2p_plugin::set_program_options( bpo::options_description& cli, bpo::option
    cfg.add_options()
       ("p2p-endpoint", bpo::value<string>()->implicit_value("127.0.0.1:9876"), "The local IP address and port to listen for incoming connections.")
       ("p2p-max-connections", bpo::value<uint32_t>(), "Maxmimum number of incoming connections on P2P endpoint.")
+      ("p2p-io-threads", bpo::value<uint32_t>(), "Number of threads doing socket I/O and encryption for P2P connections, 0 to use the P2P thread only.")
       ("p2p-seed-node", bpo::value<vector<string>>()->composing(), "The IP address and port of a remote peer to sync with.")
       ("p2p-parameters", bpo::value<string>(), ("P2P network parameters. (Default: " + fc::json::to_string(graphene::net::node_configuration()) + " )").c_str() )
       ;
@@ -506,6 +508,9 @@ void p2p_plugin::plugin_initialize(const boost::program_options::variables_map&
    if( options.count( "p2p-max-connections" ) )
       my->max_connections = options.at( "p2p-max-connections" ).as< uint32_t >();
 
+   if( options.count( "p2p-io-threads" ) )
+      my->io_threads = options.at( "p2p-io-threads" ).as< uint32_t >();
+
    vector< string > seeds;
    if( options.count( "p2p-seed-node" ) )
    {
@@ -579,6 +584,14 @@ void p2p_plugin::plugin_startup()
          my->config.set( "maximum_number_of_connections", fc::variant( my->max_connections ) );
       }
 
+      if( my->io_threads )
+      {
+         if( my->config.find( "io_thread_count" ) != my->config.end() )
+            ilog( "Overriding advanded_node_parameters[ \"io_thread_count\" ] with ${n}", ("n", *my->io_threads) );
+
+         my->config.set( "io_thread_count", fc::variant( *my->io_threads ) );
+      }
+
       my->node->set_advanced_node_parameters( my->config );
       my->node->listen_to_p2p_network();
       my->node->connect_to_p2p_network();
@@ -622,4 +635,10 @@ void p2p_plugin::set_block_production( bool producing_blocks )
    my->block_producer = producing_blocks;
 }
 
+graphene::net::network_telemetry p2p_plugin::get_network_telemetry() const
+{
+   FC_ASSERT( my->node, "P2P node is not running" );
+   return my->node->get_network_telemetry();
+}
+
 } } } // namespace sophiatx::plugins::p2p
@@ -269,8 +269,8 @@ void smt_test_plugin::plugin_initialize( const boost::program_options::variables
       ilog( "Initializing smt_test plugin" );
       chain::database& db = appbase::app().get_plugin< sophiatx::plugins::chain::chain_plugin >().db();
 
-      db.pre_apply_operation.connect( 0, [&]( const operation_notification& o ){ my->pre_operation( o ); } );
-      db.post_apply_operation.connect( 0, [&]( const operation_notification& o ){ my->post_operation( o ); } );
+      db.add_pre_apply_operation_handler( [&]( const operation_notification& o ){ my->pre_operation( o ); }, name(), 0 );
+      db.add_post_apply_operation_handler( [&]( const operation_notification& o ){ my->post_operation( o ); }, name(), 0 );
 
       // add_plugin_index< key_lookup_index >(db);
    }
@@ -0,0 +1,78 @@
+#include <sophiatx/plugins/webserver/content_encoding.hpp>
+
+#include <fc/compress/zlib.hpp>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/crc.hpp>
+
+#include <vector>
+
+namespace sophiatx { namespace plugins { namespace webserver {
+
+using std::string;
+using boost::optional;
+
+content_encoding accepted_encoding( const string& accept_encoding )
+{
+   bool gzip = false;
+   bool deflate = false;
+
+   std::vector< string > codings;
+   boost::split( codings, accept_encoding, boost::is_any_of( "," ) );
+   for( auto& coding : codings )
+   {
+      std::vector< string > params;
+      boost::split( params, coding, boost::is_any_of( ";" ) );
+      string name = boost::algorithm::to_lower_copy( boost::algorithm::trim_copy( params[0] ) );
+
+      bool refused = false;
+      for( size_t i = 1; i < params.size(); ++i )
+      {
+         string param = boost::algorithm::erase_all_copy( params[i], " " );
+         if( param == "q=0" || param == "q=0.0" || param == "q=0.00" || param == "q=0.000" )
+            refused = true;
+      }
+      if( refused )
+         continue;
+
+      if( name == "gzip" || name == "x-gzip" )
+         gzip = true;
+      else if( name == "deflate" )
+         deflate = true;
+   }
+
+   return gzip ? content_encoding::gzip : deflate ? content_encoding::deflate : content_encoding::identity;
+}
+
+optional< string > compress_body( const string& body, content_encoding encoding )
+{
+   string zlib = fc::zlib_compress( body );
+
+   // 2 byte header of a deflate stream without preset dictionary, 4 byte adler32 trailer
+   if( zlib.size() < 6 || ( zlib[0] & 0x0f ) != 8 || ( zlib[1] & 0x20 ) ||
+       ( ( uint8_t( zlib[0] ) << 8 ) | uint8_t( zlib[1] ) ) % 31 != 0 )
+      return optional< string >();
+
+   if( encoding == content_encoding::deflate )
+      return zlib;
+
+   boost::crc_32_type crc;
+   crc.process_bytes( body.data(), body.size() );
+   auto append_le32 = []( string& out, uint32_t value )
+   {
+      for( int i = 0; i < 4; ++i )
+         out.push_back( char( ( value >> ( 8 * i ) ) & 0xff ) );
+   };
+
+   // magic, deflate, no flags, no modification time, no extra flags, unknown OS
+   static const char gzip_header[] = { '\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff' };
+   string gzip;
+   gzip.reserve( sizeof( gzip_header ) + zlib.size() + 2 );
+   gzip.append( gzip_header, sizeof( gzip_header ) );
+   gzip.append( zlib, 2, zlib.size() - 6 );
+   append_le32( gzip, crc.checksum() );
+   append_le32( gzip, uint32_t( body.size() ) );
+   return gzip;
+}
+
+} } } // sophiatx::plugins::webserver
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include <string>
+
+namespace sophiatx { namespace plugins { namespace webserver {
+
+enum class content_encoding { identity, gzip, deflate };
+
+/// the encoding of the response preferred by the Accept-Encoding header of the request
+content_encoding accepted_encoding( const std::string& accept_encoding );
+
+/**
+ * The body compressed with the given encoding, or nothing if it can not be compressed.  The deflate content coding
+ * is the zlib format, gzip wraps the deflate data of it into a gzip member.
+ */
+boost::optional< std::string > compress_body( const std::string& body, content_encoding encoding );
+
+} } } // sophiatx::plugins::webserver
@@ -17,7 +17,8 @@ using namespace appbase;
 /**
   * This plugin starts an HTTP/ws webserver and dispatches queries to
   * registered handles based on payload. The payload must be conform
-  * to the JSONRPC 2.0 spec.
+  * to the JSONRPC 2.0 spec. Websocket binary frames carry fc::raw
+  * packed requests of the binary transport, see json_rpc/binary_rpc.hpp.
   *
   * The handler will be called from the appbase application io_service
   * thread.  The callback can be called from any thread and will
@@ -1,4 +1,5 @@
 #include <sophiatx/plugins/webserver/webserver_plugin.hpp>
+#include <sophiatx/plugins/webserver/content_encoding.hpp>
 
 #include <sophiatx/plugins/chain/chain_plugin.hpp>
 
@@ -19,6 +20,7 @@
 #include <websocketpp/client.hpp>
 #include <websocketpp/logger/stub.hpp>
 
+#include <atomic>
 #include <thread>
 #include <memory>
 #include <iostream>
@@ -108,6 +110,20 @@ std::vector<fc::ip::endpoint> resolve_string_to_ip_endpoints( const std::string&
    FC_CAPTURE_AND_RETHROW( (endpoint_string) )
 }
 
+/// Counters of the requests served since the last stats line
+struct webserver_stats
+{
+   std::atomic< uint64_t > http_requests{ 0 };
+   std::atomic< uint64_t > ws_connections{ 0 };
+   std::atomic< uint64_t > ws_messages{ 0 };
+   std::atomic< uint64_t > response_bytes{ 0 };
+   std::atomic< uint64_t > compressed_responses{ 0 };
+   /// bytes saved by compression
+   std::atomic< uint64_t > compression_saved_bytes{ 0 };
+   /// time the requests waited for a thread of the pool
+   std::atomic< uint64_t > queue_wait_us{ 0 };
+};
+
 class webserver_plugin_impl
 {
    public:
@@ -123,6 +139,9 @@ class webserver_plugin_impl
 
       void handle_ws_message( websocket_server_type*, connection_hdl, detail::websocket_server_type::message_ptr );
       void handle_http_message( websocket_server_type*, connection_hdl );
+      void init_server( websocket_server_type& server, asio::io_service& ios );
+      void schedule_stats();
+      void log_stats();
 
       shared_ptr< std::thread >  http_thread;
       asio::io_service           http_ios;
@@ -140,10 +159,86 @@ class webserver_plugin_impl
 
       plugins::json_rpc::json_rpc_plugin* api;
       boost::signals2::connection         chain_sync_con;
+
+      /// responses of at least this size are compressed if the client accepts it, 0 disables compression
+      uint32_t                   compression_threshold = 0;
+      bool                       tcp_nodelay = true;
+      /// seconds between the stats lines, 0 disables them
+      uint32_t                   stats_interval = 0;
+      webserver_stats            stats;
+      fc::time_point             stats_start;
+      std::unique_ptr< asio::deadline_timer > stats_timer;
 };
 
+void webserver_plugin_impl::init_server( websocket_server_type& server, asio::io_service& ios )
+{
+   server.clear_access_channels( websocketpp::log::alevel::all );
+   server.clear_error_channels( websocketpp::log::elevel::all );
+   server.init_asio( &ios );
+   server.set_reuse_addr( true );
+
+   if( tcp_nodelay )
+   {
+      // responses are written at once, waiting for more data to fill the segment only delays them
+      server.set_socket_init_handler( []( connection_hdl, asio::ip::tcp::socket& socket )
+      {
+         boost::system::error_code ec;
+         socket.set_option( tcp::no_delay( true ), ec );
+      });
+   }
+}
+
+void webserver_plugin_impl::schedule_stats()
+{
+   stats_timer->expires_from_now( boost::posix_time::seconds( stats_interval ) );
+   stats_timer->async_wait( [this]( const boost::system::error_code& ec )
+   {
+      if( ec )
+         return;
+      log_stats();
+      schedule_stats();
+   });
+}
+
+void webserver_plugin_impl::log_stats()
+{
+   const fc::time_point now = fc::time_point::now();
+   const double seconds = std::max< int64_t >( ( now - stats_start ).count(), 1 ) / 1000000.0;
+   stats_start = now;
+
+   const uint64_t http_requests = stats.http_requests.exchange( 0 );
+   const uint64_t ws_messages = stats.ws_messages.exchange( 0 );
+   const uint64_t requests = std::max< uint64_t >( http_requests + ws_messages, 1 );
+
+   // every http request is a connection of its own, websocket connections are reused by their messages
+   ilog( "webserver: ${r} requests/s, ${h} http requests, ${w} ws messages on ${c} new ws connections, "
+         "${b} response bytes, ${z} compressed responses saving ${s} bytes, ${q} us average wait for a thread",
+         ("r", uint64_t( ( http_requests + ws_messages ) / seconds ))("h", http_requests)("w", ws_messages)
+         ("c", stats.ws_connections.exchange( 0 ))("b", stats.response_bytes.exchange( 0 ))
+         ("z", stats.compressed_responses.exchange( 0 ))("s", stats.compression_saved_bytes.exchange( 0 ))
+         ("q", stats.queue_wait_us.exchange( 0 ) / requests) );
+
+   auto timing = api->get_method_timing( true );
+   std::vector< std::pair< string, plugins::json_rpc::api_method_timing > > by_total( timing.begin(), timing.end() );
+   std::sort( by_total.begin(), by_total.end(), []( const auto& a, const auto& b )
+   {
+      return a.second.total_us > b.second.total_us;
+   });
+   for( const auto& t : by_total )
+      ilog( "webserver: ${m} ${c} calls, ${a} us average, ${x} us max",
+            ("m", t.first)("c", t.second.count)("a", t.second.total_us / t.second.count)("x", t.second.max_us) );
+}
+
 void webserver_plugin_impl::start_webserver()
 {
+   if( stats_interval )
+   {
+      api->set_method_timing( true );
+      stats_start = fc::time_point::now();
+      stats_timer.reset( new asio::deadline_timer( thread_pool_ios ) );
+      schedule_stats();
+   }
+
    if( ws_endpoint )
    {
       ws_thread = std::make_shared<std::thread>( [&]()
@@ -151,11 +246,9 @@ void webserver_plugin_impl::start_webserver()
          ilog( "start processing ws thread" );
          try
          {
-            ws_server.clear_access_channels( websocketpp::log::alevel::all );
-            ws_server.clear_error_channels( websocketpp::log::elevel::all );
-            ws_server.init_asio( &ws_ios );
-            ws_server.set_reuse_addr( true );
+            init_server( ws_server, ws_ios );
 
+            ws_server.set_open_handler( [this]( connection_hdl ) { ++stats.ws_connections; } );
             ws_server.set_message_handler( boost::bind( &webserver_plugin_impl::handle_ws_message, this, &ws_server, _1, _2 ) );
 
             if( http_endpoint && http_endpoint == ws_endpoint )
@@ -185,10 +278,7 @@ void webserver_plugin_impl::start_webserver()
          ilog( "start processing http thread" );
          try
          {
-            http_server.clear_access_channels( websocketpp::log::alevel::all );
-            http_server.clear_error_channels( websocketpp::log::elevel::all );
-            http_server.init_asio( &http_ios );
-            http_server.set_reuse_addr( true );
+            init_server( http_server, http_ios );
 
             http_server.set_http_handler( boost::bind( &webserver_plugin_impl::handle_http_message, this, &http_server, _1 ) );
 
@@ -215,6 +305,9 @@ void webserver_plugin_impl::stop_webserver()
    if( http_server.is_listening() )
       http_server.stop_listening();
 
+   if( stats_timer )
+      stats_timer->cancel();
+
    thread_pool_ios.stop();
    thread_pool.join_all();
 
@@ -236,15 +329,32 @@ void webserver_plugin_impl::stop_webserver()
 void webserver_plugin_impl::handle_ws_message( websocket_server_type* server, connection_hdl hdl, detail::websocket_server_type::message_ptr msg )
 {
    auto con = server->get_con_from_hdl( hdl );
+   const fc::time_point received = fc::time_point::now();
 
-   thread_pool_ios.post( [con, msg, this]()
+   thread_pool_ios.post( [con, msg, received, this]()
    {
+      ++stats.ws_messages;
+      stats.queue_wait_us += ( fc::time_point::now() - received ).count();
+
       try
       {
          if( msg->get_opcode() == websocketpp::frame::opcode::text )
-            con->send( api->call( msg->get_payload() ) );
+         {
+            auto response = api->call( msg->get_payload() );
+            stats.response_bytes += response.size();
+            con->send( response );
+         }
+         else if( msg->get_opcode() == websocketpp::frame::opcode::binary )
+         {
+            const auto& payload = msg->get_payload();
+            auto response = api->call_binary( std::vector< char >( payload.begin(), payload.end() ) );
+            stats.response_bytes += response.size();
+            con->send( response.data(), response.size(), websocketpp::frame::opcode::binary );
+         }
          else
+         {
             con->send( "error: string payload expected" );
+         }
       }
       catch( fc::exception& e )
       {
@@ -275,14 +385,38 @@ void webserver_plugin_impl::handle_http_message( websocket_server_type* server,
 {
    auto con = server->get_con_from_hdl( hdl );
    con->defer_http_response();
+   const fc::time_point received = fc::time_point::now();
 
-   thread_pool_ios.post( [con, this]()
+   thread_pool_ios.post( [con, received, this]()
    {
+      ++stats.http_requests;
+      stats.queue_wait_us += ( fc::time_point::now() - received ).count();
+
       auto body = con->get_request_body();
 
+      // websocketpp closes the connection after every http response, tell the client not to reuse it
+      con->replace_header( "Connection", "close" );
+
       try
       {
-         con->set_body( api->call( body ) );
+         auto response = api->call( body );
+         if( compression_threshold && response.size() >= compression_threshold )
+         {
+            auto encoding = accepted_encoding( con->get_request_header( "Accept-Encoding" ) );
+            optional< string > compressed;
+            if( encoding != content_encoding::identity )
+               compressed = compress_body( response, encoding );
+            if( compressed && compressed->size() < response.size() )
+            {
+               ++stats.compressed_responses;
+               stats.compression_saved_bytes += response.size() - compressed->size();
+               con->replace_header( "Content-Encoding", encoding == content_encoding::gzip ? "gzip" : "deflate" );
+               response = std::move( *compressed );
+            }
+            con->replace_header( "Vary", "Accept-Encoding" );
+         }
+         stats.response_bytes += response.size();
+         con->set_body( std::move( response ) );
          con->set_status( websocketpp::http::status_code::ok );
       }
       catch( fc::exception& e )
@@ -328,6 +462,12 @@ void webserver_plugin::set_program_options( options_description&, options_descri
       ("webserver-ws-endpoint", bpo::value< string >(), "Local websocket endpoint for webserver requests.")
       ("webserver-thread-pool-size", bpo::value<thread_pool_size_t>()->default_value(16),
        "Number of threads used to handle queries. Default: 16.")
+      ("webserver-compression-threshold", bpo::value<uint32_t>()->default_value(16384),
+       "HTTP responses of at least this many bytes are compressed with gzip or deflate if the client accepts it, 0 disables compression.")
+      ("webserver-tcp-nodelay", bpo::value<bool>()->default_value(true),
+       "Send responses without waiting to fill TCP segments (TCP_NODELAY).")
+      ("webserver-stats-interval", bpo::value<uint32_t>()->default_value(0),
+       "Seconds between logging the requests served, the bytes sent and the time spent in each API method, 0 disables it.")
       ;
 }
 
@@ -337,6 +477,9 @@ void webserver_plugin::plugin_initialize( const variables_map& options )
    FC_ASSERT(thread_pool_size > 0, "webserver-thread-pool-size must be greater than 0");
    ilog("configured with ${tps} thread pool size", ("tps", thread_pool_size));
    my.reset(new detail::webserver_plugin_impl(thread_pool_size));
+   my->compression_threshold = options.at( "webserver-compression-threshold" ).as< uint32_t >();
+   my->tcp_nodelay = options.at( "webserver-tcp-nodelay" ).as< bool >();
+   my->stats_interval = options.at( "webserver-stats-interval" ).as< uint32_t >();
 
    if( options.count( "webserver-http-endpoint" ) )
    {
@@ -443,9 +443,9 @@ void witness_plugin::plugin_initialize(const boost::program_options::variables_m
       my->_required_witness_participation = SOPHIATX_1_PERCENT * options.at( "required-participation" ).as< uint32_t >();
    }
 
-   my->on_pre_apply_transaction_connection = my->_db.on_pre_apply_transaction.connect( 0, [&]( const signed_transaction& tx ){ my->pre_transaction( tx ); } );
-   my->pre_apply_connection = my->_db.pre_apply_operation.connect( 0, [&]( const operation_notification& note ){ my->pre_operation( note ); } );
-   my->applied_block_connection = my->_db.applied_block.connect( 0, [&]( const signed_block& b ){ my->on_block( b ); } );
+   my->on_pre_apply_transaction_connection = my->_db.add_pre_apply_transaction_handler( [&]( const signed_transaction& tx ){ my->pre_transaction( tx ); }, name(), 0 );
+   my->pre_apply_connection = my->_db.add_pre_apply_operation_handler( [&]( const operation_notification& note ){ my->pre_operation( note ); }, name(), 0 );
+   my->applied_block_connection = my->_db.add_applied_block_handler( [&]( const signed_block& b ){ my->on_block( b ); }, name(), 0 );
 
    add_plugin_index< account_bandwidth_index >( my->_db );
    add_plugin_index< reserve_ratio_index     >( my->_db );
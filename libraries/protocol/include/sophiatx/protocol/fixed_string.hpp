@@ -8,6 +8,9 @@
 #include <fc/crypto/ripemd160.hpp>
 
 #include <boost/endian/conversion.hpp>
+#include <boost/utility/string_ref.hpp>
+
+#include <stdexcept>
 
 #include <sophiatx/protocol/types_fwd.hpp>
 
@@ -63,10 +66,45 @@ namespace fc
 
 namespace sophiatx { namespace protocol {
 
+namespace detail {
+
+   /**
+    * Lookup tables of the base64m alphabet.  They are derived from fc::base64m_encode() once, so the codec
+    * below can never disagree with fc about which characters are valid or what they decode to.
+    */
+   struct base64m_tables
+   {
+      base64m_tables()
+      {
+         memset( decode, -1, sizeof( decode ) );
+         for( uint8_t v = 0; v < 64; ++v )
+         {
+            const unsigned char group[3] = { 0, 0, v };
+            encode[v] = fc::base64m_encode( group, 3 )[3];
+            decode[ uint8_t( encode[v] ) ] = v;
+         }
+      }
+
+      char     encode[64];
+      int8_t   decode[256]; ///< -1 for characters outside of the alphabet
+   };
+
+   inline const base64m_tables& get_base64m_tables()
+   {
+      static const base64m_tables tables;
+      return tables;
+   }
+
+} // detail
+
 /**
  * This class is an in-place memory allocation of a fixed length character string.
  *
  * The string will serialize the same way as std::string for variant and raw formats.
+ *
+ * The characters are stored base64m decoded.  Conversions go through the tables above on stack buffers, only
+ * strings with characters outside of the alphabet take the fc::base64m_decode() path, which stops at the first
+ * such character.
  */
 template< typename Storage >
 class fixed_string_impl
@@ -74,49 +112,68 @@ class fixed_string_impl
    public:
       fixed_string_impl(){}
       fixed_string_impl( const fixed_string_impl& c ) : data( c.data ), _size (c._size){}
-      fixed_string_impl( const char* str ) : fixed_string_impl( std::string( str ) ) {}
-      fixed_string_impl( const std::string& str )
+      fixed_string_impl( const char* str ) : fixed_string_impl( boost::string_ref( str ) ) {}
+      fixed_string_impl( const std::string& str ) : fixed_string_impl( boost::string_ref( str ) ) {}
+      fixed_string_impl( boost::string_ref str )
       {
-         //prepare the string to have length divisible by 4
-         std::string tmp_str = str;
-         while(tmp_str.size() % 4)
-            tmp_str +='A';
-
-         Storage d;
-
-         std::string s = fc::base64m_decode(tmp_str);
-         int count = s.size();
-         if( count <= sizeof(d) )
-            _size = count;
-         else
-            _size = sizeof(d);
-         memcpy( (char*)&d, s.c_str(), _size );
-         data = boost::endian::big_to_native( d );
-
+         const auto& tables = detail::get_base64m_tables();
+         for( char c : str )
+         {
+            if( tables.decode[ uint8_t( c ) ] < 0 )
+            {
+               decode_with_fc( str );
+               return;
+            }
+         }
+
+         // the string is decoded as if padded with 'A' to a length divisible by 4, bytes past Storage are dropped
+         unsigned char d[ sizeof( Storage ) + 2 ] = {};
+         const size_t groups = ( str.size() + 3 ) / 4;
+         const size_t decoded_size = std::min( groups * 3, sizeof( Storage ) );
+         for( size_t g = 0, pos = 0; g * 3 < decoded_size; ++g, pos += 4 )
+         {
+            uint32_t bits = 0;
+            for( size_t i = pos; i < pos + 4; ++i )
+               bits = ( bits << 6 ) | ( i < str.size() ? tables.decode[ uint8_t( str[i] ) ] : 0 );
+            d[ g * 3 ]     = uint8_t( bits >> 16 );
+            d[ g * 3 + 1 ] = uint8_t( bits >> 8 );
+            d[ g * 3 + 2 ] = uint8_t( bits );
+         }
+
+         Storage s;
+         _size = decoded_size;
+         memcpy( (char*)&s, d, sizeof( Storage ) );
+         data = boost::endian::big_to_native( s );
       }
 
       operator std::string()const
       {
-         Storage d = boost::endian::native_to_big( data );
-
-         unsigned char data[sizeof(Storage)+3];
-         memcpy(data, (char*)&d, _size);
-         //do the padding to avoid '=' at the end of the result string
-         std::string s;
-         if(_size % 3 == 1) {
-            data[ _size ] = data[ _size + 1 ] = 0;
-            s = fc::base64m_encode((char*)&d, _size+2);
-         }else if(_size % 3 == 2) {
-            data[ _size ] = 0;
-            s = fc::base64m_encode((char*)&d, _size+1);
-         }else
-            s = fc::base64m_encode((char*)&d, _size);
-
-         if(s.size())
-            while( s.at(s.size()-1) == 'A')
-               s.erase(s.size()-1);
-
-         return s;
+         const auto& tables = detail::get_base64m_tables();
+         const Storage s = boost::endian::native_to_big( data );
+
+         //pad with zeros to a length divisible by 3 to avoid '=' at the end of the result string
+         unsigned char d[ sizeof( Storage ) + 2 ] = {};
+         memcpy( d, (const char*)&s, _size );
+
+         char result[ ( sizeof( Storage ) + 2 ) / 3 * 4 ];
+         size_t length = 0;
+         for( size_t pos = 0; pos < _size; pos += 3 )
+         {
+            const uint32_t bits = ( uint32_t( d[ pos ] ) << 16 ) | ( uint32_t( d[ pos + 1 ] ) << 8 ) | d[ pos + 2 ];
+            result[ length++ ] = tables.encode[ ( bits >> 18 ) & 0x3f ];
+            result[ length++ ] = tables.encode[ ( bits >> 12 ) & 0x3f ];
+            result[ length++ ] = tables.encode[ ( bits >> 6 ) & 0x3f ];
+            result[ length++ ] = tables.encode[ bits & 0x3f ];
+         }
+
+         const size_t encoded_length = length;
+         while( length && result[ length - 1 ] == 'A' )
+            --length;
+         // trimming used to run past the front of the string, a non empty string of zeros still fails the same way
+         if( encoded_length && !length )
+            throw std::out_of_range( "fixed_string has no significant characters" );
+
+         return std::string( result, length );
       }
 
       uint32_t size()const
@@ -145,6 +202,29 @@ class fixed_string_impl
          return *this;
       }
 
+      Storage data;
+      uint32_t _size=0;
+
+   private:
+      void decode_with_fc( boost::string_ref str )
+      {
+         //prepare the string to have length divisible by 4
+         std::string tmp_str( str.begin(), str.end() );
+         while(tmp_str.size() % 4)
+            tmp_str +='A';
+
+         Storage d;
+
+         std::string s = fc::base64m_decode(tmp_str);
+         if( s.size() <= sizeof(d) )
+            _size = s.size();
+         else
+            _size = sizeof(d);
+         memcpy( (char*)&d, s.c_str(), _size );
+         data = boost::endian::big_to_native( d );
+      }
+
+   public:
       friend std::string operator + ( const fixed_string_impl& a, const std::string& b ) { return std::string( a ) + b; }
       friend std::string operator + ( const std::string& a, const fixed_string_impl& b ){ return a + std::string( b ); }
       friend bool operator < ( const fixed_string_impl& a, const fixed_string_impl& b ) { return a.data < b.data; }
@@ -154,9 +234,6 @@ class fixed_string_impl
       friend bool operator == ( const fixed_string_impl& a, const fixed_string_impl& b ) { return a.data == b.data; }
       friend bool operator != ( const fixed_string_impl& a, const fixed_string_impl& b ) { return a.data != b.data; }
 
-      Storage data;
-      uint32_t _size=0;
-
 };
 
 // These storage types work with memory layout and should be used instead of a custom template.
@@ -0,0 +1,100 @@
+#pragma once
+#include <sophiatx/protocol/types.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+
+#include <cstring>
+#include <mutex>
+
+namespace sophiatx { namespace protocol {
+
+/**
+ *  Bounded LRU cache of public keys recovered from transaction signatures, keyed by the signature
+ *  digest and the signature itself.
+ *
+ *  A transaction's signatures are recovered when it is pushed to the mempool, again when pending
+ *  transactions are re-applied while producing a block, and again when the same transaction arrives
+ *  inside a block.  signed_transaction::get_signature_keys() consults this cache so that the (expensive)
+ *  ECDSA recovery is done only once.
+ *
+ *  The cache is process wide and disabled (capacity 0) until set_capacity() is called.  It is safe to
+ *  use from multiple threads.
+ */
+class recovered_signature_cache
+{
+   public:
+      struct statistics
+      {
+         uint64_t hits = 0;
+         uint64_t misses = 0;
+         uint64_t evictions = 0;
+         uint32_t size = 0;
+         uint32_t capacity = 0;
+      };
+
+      static recovered_signature_cache& instance();
+
+      /** shrinking the capacity evicts the least recently used entries */
+      void set_capacity( uint32_t capacity );
+
+      /** returns the key recovered from signature over digest, recovering and caching it if needed */
+      public_key_type recover( const digest_type& digest, const signature_type& signature );
+
+      statistics get_statistics()const;
+      void       clear();
+
+   private:
+      struct entry
+      {
+         struct key_type
+         {
+            digest_type    digest;
+            signature_type signature;
+
+            friend bool operator == ( const key_type& a, const key_type& b )
+            {
+               return a.digest == b.digest && memcmp( a.signature.begin(), b.signature.begin(), b.signature.size() ) == 0;
+            }
+         };
+
+         struct key_hash
+         {
+            size_t operator()( const key_type& k )const
+            {
+               // both parts are already uniformly distributed
+               size_t digest_part, signature_part;
+               memcpy( &digest_part, k.digest.data(), sizeof( digest_part ) );
+               memcpy( &signature_part, k.signature.begin() + 1, sizeof( signature_part ) );
+               return digest_part ^ signature_part;
+            }
+         };
+
+         key_type        key;
+         public_key_type public_key;
+      };
+
+      struct by_key;
+
+      typedef boost::multi_index_container<
+         entry,
+         boost::multi_index::indexed_by<
+            boost::multi_index::sequenced<>,
+            boost::multi_index::hashed_unique< boost::multi_index::tag< by_key >,
+               boost::multi_index::member< entry, entry::key_type, &entry::key >, entry::key_hash >
+         >
+      > entry_index_type;
+
+      void evict_to( uint32_t size );
+
+      mutable std::mutex _mutex;
+      entry_index_type   _entries; ///< most recently used first
+      uint32_t           _capacity = 0;
+      statistics         _statistics;
+};
+
+} } // sophiatx::protocol
+
+FC_REFLECT( sophiatx::protocol::recovered_signature_cache::statistics, (hits)(misses)(evictions)(size)(capacity) )
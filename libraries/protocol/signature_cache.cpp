@@ -0,0 +1,74 @@
+#include <sophiatx/protocol/signature_cache.hpp>
+
+namespace sophiatx { namespace protocol {
+
+recovered_signature_cache& recovered_signature_cache::instance()
+{
+   static recovered_signature_cache cache;
+   return cache;
+}
+
+void recovered_signature_cache::set_capacity( uint32_t capacity )
+{
+   std::lock_guard< std::mutex > guard( _mutex );
+   _capacity = capacity;
+   evict_to( capacity );
+}
+
+public_key_type recovered_signature_cache::recover( const digest_type& digest, const signature_type& signature )
+{
+   entry::key_type key{ digest, signature };
+   {
+      std::lock_guard< std::mutex > guard( _mutex );
+      if( _capacity > 0 )
+      {
+         auto& key_idx = _entries.get< by_key >();
+         auto itr = key_idx.find( key );
+         if( itr != key_idx.end() )
+         {
+            ++_statistics.hits;
+            _entries.relocate( _entries.begin(), _entries.project< 0 >( itr ) );
+            return itr->public_key;
+         }
+         ++_statistics.misses;
+      }
+   }
+
+   // recover without holding the lock, also when the cache is disabled, so other threads may recover
+   // signatures concurrently
+   public_key_type public_key = fc::ecc::public_key( signature, digest );
+
+   std::lock_guard< std::mutex > guard( _mutex );
+   if( _capacity == 0 )
+      return public_key;
+   if( _entries.push_front( entry{ key, public_key } ).second )
+      evict_to( _capacity );
+   return public_key;
+}
+
+recovered_signature_cache::statistics recovered_signature_cache::get_statistics()const
+{
+   std::lock_guard< std::mutex > guard( _mutex );
+   statistics result = _statistics;
+   result.size = _entries.size();
+   result.capacity = _capacity;
+   return result;
+}
+
+void recovered_signature_cache::clear()
+{
+   std::lock_guard< std::mutex > guard( _mutex );
+   _entries.clear();
+   _statistics = statistics();
+}
+
+void recovered_signature_cache::evict_to( uint32_t size )
+{
+   while( _entries.size() > size )
+   {
+      _entries.pop_back();
+      ++_statistics.evictions;
+   }
+}
+
+} } // sophiatx::protocol
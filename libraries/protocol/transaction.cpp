@@ -1,6 +1,7 @@
 
 #include <sophiatx/protocol/transaction.hpp>
 #include <sophiatx/protocol/transaction_util.hpp>
+#include <sophiatx/protocol/signature_cache.hpp>
 
 #include <fc/io/raw.hpp>
 #include <fc/bitutil.hpp>
@@ -85,11 +86,13 @@ void transaction::get_required_authorities( flat_set< account_name_type >& activ
 flat_set<public_key_type> signed_transaction::get_signature_keys( const chain_id_type& chain_id )const
 { try {
    auto d = sig_digest( chain_id );
+   auto& cache = recovered_signature_cache::instance();
    flat_set<public_key_type> result;
+   result.reserve( signatures.size() );
    for( const auto&  sig : signatures )
    {
       SOPHIATX_ASSERT(
-         result.insert( fc::ecc::public_key(sig,d) ).second,
+         result.insert( cache.recover( d, sig ) ).second,
          tx_duplicate_sig,
          "Duplicate Signature detected" );
    }
@@ -0,0 +1,34 @@
+#include <sophiatx/utilities/batch_thread_pool.hpp>
+
+#include <fc/log/logger.hpp>
+
+namespace sophiatx { namespace utilities {
+
+batch_thread_pool::batch_thread_pool( uint32_t number_of_threads )
+   : _desired_size( number_of_threads )
+{
+}
+
+batch_thread_pool::~batch_thread_pool()
+{
+   for( const auto& thread : _threads )
+   {
+      try
+      {
+         thread->quit();
+      }
+      catch( const fc::exception& e )
+      {
+         wlog( "Exception thrown while shutting down batch thread, ignoring: ${e}", ("e", e) );
+      }
+   }
+}
+
+void batch_thread_pool::start_threads()
+{
+   std::lock_guard< std::mutex > lock( _start_mutex );
+   while( _threads.size() < _desired_size )
+      _threads.emplace_back( new fc::thread( "batch-" + std::to_string( _threads.size() ) ) );
+}
+
+} } // sophiatx::utilities
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <fc/thread/thread.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sophiatx { namespace utilities {
+
+/**
+ * A set of worker threads the items of a batch are split over, for CPU bound work such as signing, signature
+ * recovery and encryption.  Threads are started lazily by the first batch, with a size of zero or one the items
+ * are processed on the calling thread.
+ */
+class batch_thread_pool
+{
+   public:
+      explicit batch_thread_pool( uint32_t number_of_threads );
+      ~batch_thread_pool();
+
+      uint32_t size()const { return _desired_size; }
+
+      /**
+       * Calls f( i ) for every i below count and returns once all calls returned.  Thread t processes the items
+       * t, t + size(), ... so results written to index i keep the order of the batch.  The first exception thrown
+       * is rethrown after all threads finished.
+       */
+      template< typename Function >
+      void run( size_t count, const Function& f )
+      {
+         if( _desired_size <= 1 || count <= 1 )
+         {
+            for( size_t i = 0; i < count; ++i )
+               f( i );
+            return;
+         }
+
+         start_threads();
+
+         const size_t threads = std::min( _threads.size(), count );
+         std::vector< fc::future< void > > done;
+         done.reserve( threads );
+         for( size_t t = 0; t < threads; ++t )
+            done.push_back( _threads[t]->async( [&f, t, threads, count]()
+            {
+               for( size_t i = t; i < count; i += threads )
+                  f( i );
+            }, "batch" ) );
+
+         std::exception_ptr error;
+         for( auto& d : done )
+         {
+            try
+            {
+               d.wait();
+            }
+            catch( ... )
+            {
+               if( !error )
+                  error = std::current_exception();
+            }
+         }
+         if( error )
+            std::rethrow_exception( error );
+      }
+
+   private:
+      void start_threads();
+
+      std::vector< std::unique_ptr< fc::thread > > _threads;
+      uint32_t                                     _desired_size = 0;
+      std::mutex                                   _start_mutex;
+};
+
+} } // sophiatx::utilities
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sophiatx { namespace utilities {
+
+/**
+ * Reserves count consecutive memo nonces and returns the first one.  Nonces follow the clock in microseconds but
+ * are unique within the process, across threads and whichever api encrypted the memo, so no two memos encrypted
+ * for the same key pair share the encryption key.
+ */
+int64_t reserve_memo_nonces( int64_t count );
+
+} } // sophiatx::utilities
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <fc/crypto/elliptic.hpp>
+#include <fc/crypto/sha256.hpp>
+#include <fc/crypto/sha512.hpp>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+
+namespace sophiatx { namespace utilities {
+
+/// overwrites the memory in a way the compiler does not optimize away
+void secure_wipe( void* data, size_t size );
+
+/**
+ * Keeps the ECDH shared secrets of the most recently used (private key, public key) pairs, so that encrypting and
+ * decrypting many memos between the same two parties derives the secret once.  Pairs are identified by a hash
+ * of both keys, the least recently used pair is dropped once the capacity is reached.  Secrets are wiped from
+ * memory when they are dropped, on clear() and on destruction.  Safe to use from several threads.
+ */
+class shared_secret_cache
+{
+   public:
+      explicit shared_secret_cache( size_t capacity );
+      ~shared_secret_cache();
+
+      shared_secret_cache( const shared_secret_cache& ) = delete;
+      shared_secret_cache& operator=( const shared_secret_cache& ) = delete;
+
+      /// identifies a pair by the serialized private key in any format, e.g. WIF, and the public key
+      static fc::sha256 pair_id( const char* private_key, size_t size, const fc::ecc::public_key_data& public_key );
+
+      /**
+       * Returns the secret of the pair, calling derive() on a miss.  Exceptions thrown by derive() are passed
+       * on and nothing is cached.
+       */
+      fc::sha512 get( const fc::sha256& pair_id, const std::function< fc::sha512() >& derive );
+
+      void clear();
+
+      size_t capacity()const { return _capacity; }
+      size_t size()const;
+
+   private:
+      struct entry
+      {
+         fc::sha256 pair_id;
+         fc::sha512 secret;
+      };
+
+      static void wipe( entry& e );
+
+      size_t                                                    _capacity;
+      /// most recently used first
+      std::list< entry >                                        _entries;
+      std::map< fc::sha256, std::list< entry >::iterator >      _index;
+      mutable std::mutex                                        _mutex;
+};
+
+} } // sophiatx::utilities
@@ -0,0 +1,29 @@
+#include <sophiatx/utilities/memo_nonce.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/time.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+namespace sophiatx { namespace utilities {
+
+namespace {
+   /// last nonce handed out in this process
+   std::atomic< int64_t > last_memo_nonce( 0 );
+}
+
+int64_t reserve_memo_nonces( int64_t count )
+{
+   FC_ASSERT( count > 0 );
+   const int64_t now = fc::time_point::now().time_since_epoch().count();
+   int64_t last = last_memo_nonce.load();
+   int64_t first;
+   do
+   {
+      first = std::max( now, last + 1 );
+   } while( !last_memo_nonce.compare_exchange_weak( last, first + count - 1 ) );
+   return first;
+}
+
+} } // sophiatx::utilities
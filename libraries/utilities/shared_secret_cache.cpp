@@ -0,0 +1,91 @@
+#include <sophiatx/utilities/shared_secret_cache.hpp>
+
+#include <fc/exception/exception.hpp>
+
+namespace sophiatx { namespace utilities {
+
+void secure_wipe( void* data, size_t size )
+{
+   volatile char* p = static_cast< volatile char* >( data );
+   while( size-- )
+      *p++ = 0;
+}
+
+shared_secret_cache::shared_secret_cache( size_t capacity )
+   : _capacity( capacity )
+{
+   FC_ASSERT( _capacity > 0 );
+}
+
+shared_secret_cache::~shared_secret_cache()
+{
+   clear();
+}
+
+fc::sha256 shared_secret_cache::pair_id( const char* private_key, size_t size, const fc::ecc::public_key_data& public_key )
+{
+   fc::sha256::encoder enc;
+   enc.write( private_key, size );
+   enc.write( public_key.data, sizeof( public_key.data ) );
+   return enc.result();
+}
+
+fc::sha512 shared_secret_cache::get( const fc::sha256& pair_id, const std::function< fc::sha512() >& derive )
+{
+   {
+      std::lock_guard< std::mutex > lock( _mutex );
+      auto itr = _index.find( pair_id );
+      if( itr != _index.end() )
+      {
+         _entries.splice( _entries.begin(), _entries, itr->second );
+         return itr->second->secret;
+      }
+   }
+
+   // derived without the lock, threads deriving the same pair at once store the same secret
+   entry e{ pair_id, derive() };
+
+   std::lock_guard< std::mutex > lock( _mutex );
+   auto itr = _index.find( pair_id );
+   if( itr != _index.end() )
+   {
+      wipe( e );
+      _entries.splice( _entries.begin(), _entries, itr->second );
+      return itr->second->secret;
+   }
+
+   _entries.push_front( e );
+   _index[ pair_id ] = _entries.begin();
+   if( _entries.size() > _capacity )
+   {
+      _index.erase( _entries.back().pair_id );
+      wipe( _entries.back() );
+      _entries.pop_back();
+   }
+   fc::sha512 secret = e.secret;
+   wipe( e );
+   return secret;
+}
+
+void shared_secret_cache::clear()
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+   for( auto& e : _entries )
+      wipe( e );
+   _entries.clear();
+   _index.clear();
+}
+
+size_t shared_secret_cache::size()const
+{
+   std::lock_guard< std::mutex > lock( _mutex );
+   return _entries.size();
+}
+
+void shared_secret_cache::wipe( entry& e )
+{
+   secure_wipe( e.pair_id.data(), e.pair_id.data_size() );
+   secure_wipe( e.secret.data(), e.secret.data_size() );
+}
+
+} } // sophiatx::utilities
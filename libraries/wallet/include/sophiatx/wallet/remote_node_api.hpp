@@ -1,5 +1,6 @@
 #pragma once
 #include <sophiatx/plugins/condenser_api/condenser_api.hpp>
+#include <sophiatx/plugins/json_rpc/binary_rpc_client.hpp>
 
 namespace sophiatx { namespace wallet {
 
@@ -81,6 +81,9 @@ class wallet_api
       wallet_api( const wallet_data& initial_data, const sophiatx::protocol::chain_id_type& _sophiatx_chain_id, fc::api< remote_node_api > rapi );
       virtual ~wallet_api();
 
+      /// fetches blocks and documents through the binary RPC transport of the node instead of the remote api
+      void use_binary_rpc( std::shared_ptr< json_rpc::binary_rpc_client > client );
+
       bool copy_wallet_file( string destination_filename );
 
 
@@ -789,6 +789,7 @@ public:
    map<public_key_type,string>             _keys;
    fc::sha512                              _checksum;
    fc::api< remote_node_api >              _remote_api;
+   std::shared_ptr< json_rpc::binary_rpc_client > _binary_rpc;
    uint32_t                                _tx_expiration_seconds = 30;
 
    flat_map<string, operation>             _prototype_ops;
@@ -818,9 +819,21 @@ bool wallet_api::copy_wallet_file(string destination_filename)
    return my->copy_wallet_file(destination_filename);
 }
 
+void wallet_api::use_binary_rpc( std::shared_ptr< json_rpc::binary_rpc_client > client )
+{
+   my->_binary_rpc = client;
+}
+
 optional< database_api::api_signed_block_object > wallet_api::get_block(uint32_t num)
 {
-   return my->_remote_api->get_block( num );
+   if( !my->_binary_rpc )
+      return my->_remote_api->get_block( num );
+
+   auto r = my->_binary_rpc->call< block_api::get_block_return >( "block_api", "get_block", block_api::get_block_args{ num } );
+   if( !r.block )
+      return optional< database_api::api_signed_block_object >();
+
+   return database_api::api_signed_block_object( std::move( *r.block ) );
 }
 
 vector< condenser_api::api_operation_object > wallet_api::get_ops_in_block(uint32_t block_num, bool only_virtual)
@@ -1996,6 +2009,9 @@ annotated_signed_transaction wallet_api::sponsor_account_fees(string sponsoring_
 
 map< uint64_t, condenser_api::api_received_object >  wallet_api::get_received_documents(uint32_t app_id, string account_name, string search_type, string start, uint32_t count){
    try{
+      if( my->_binary_rpc )
+         return my->_binary_rpc->call< custom::get_received_documents_return >( "custom_api", "get_received_documents",
+            custom::get_received_documents_args{ app_id, account_name, search_type, start, count } ).history;
       return my->_remote_api->get_received_documents(app_id, account_name, search_type, start, count);
    }FC_CAPTURE_AND_RETHROW((app_id)(account_name)(search_type)(start)(count))
 }
@@ -2,11 +2,16 @@
 
 #include <jni.h>
 
+#include <cstring>
 #include <iostream>
+#include <thread>
 
 #include <boost/algorithm/string.hpp>
 
+#include <sophiatx/utilities/batch_thread_pool.hpp>
 #include <sophiatx/utilities/key_conversion.hpp>
+#include <sophiatx/utilities/memo_nonce.hpp>
+#include <sophiatx/utilities/shared_secret_cache.hpp>
 #include <sophiatx/protocol/transaction.hpp>
 
 #include <fc/io/json.hpp>
@@ -47,6 +52,13 @@ struct Java_AlexandriaJNI_memo_data {
    }
 };
 
+namespace {
+
+fc::sha512 memo_shared_secret(const std::vector<char>& private_key, const std::vector<char>& pub_key);
+fc::sha512 memo_encryption_key(int64_t nonce, const fc::sha512& shared_secret);
+
+} // anonymous
+
 JNIEXPORT jbyteArray JNICALL Java_AlexandriaJNI_generatePrivateKey(JNIEnv *env, jclass) {
    try {
       private_key_type priv_key = fc::ecc::private_key::generate();
@@ -377,19 +389,9 @@ JNIEXPORT jstring JNICALL Java_AlexandriaJNI_encryptMemo(JNIEnv *env, jclass, js
     try {
        Java_AlexandriaJNI_memo_data m;
 
-       auto bin_key = fc::raw::unpack_from_vector<public_key_type::binary_key>(pub_key);
-       public_key_type public_key(bin_key.data);
-
-       fc::ecc::private_key key = fc::variant(private_key).as<fc::ecc::private_key>();
+       m.nonce = reserve_memo_nonces(1);
 
-       m.nonce = fc::time_point::now().time_since_epoch().count();
-
-       auto shared_secret = key.get_shared_secret( public_key );
-
-       fc::sha512::encoder enc;
-       fc::raw::pack( enc, m.nonce );
-       fc::raw::pack( enc, shared_secret );
-       auto encrypt_key = enc.result();
+       auto encrypt_key = memo_encryption_key(m.nonce, memo_shared_secret(private_key, pub_key));
 
        m.encrypted = fc::aes_encrypt( encrypt_key, fc::raw::pack_to_vector(string(memo)) );
        m.check = fc::sha256::hash( encrypt_key )._hash[0];
@@ -444,18 +446,7 @@ JNIEXPORT jstring JNICALL Java_AlexandriaJNI_decryptedMemo(JNIEnv *env, jclass,
        auto m = Java_AlexandriaJNI_memo_data::from_string( str_memo );
 
        if( m ) {
-          fc::sha512 shared_secret;
-          auto bin_key = fc::raw::unpack_from_vector<public_key_type::binary_key>(pub_key);
-          public_key_type public_key(bin_key.data);
-
-          fc::ecc::private_key key = fc::variant(private_key).as<fc::ecc::private_key>();
-
-          shared_secret = key.get_shared_secret(public_key);
-
-          fc::sha512::encoder enc;
-          fc::raw::pack( enc, m->nonce );
-          fc::raw::pack( enc, shared_secret );
-          auto encryption_key = enc.result();
+          auto encryption_key = memo_encryption_key(m->nonce, memo_shared_secret(private_key, pub_key));
 
           uint64_t check = fc::sha256::hash( encryption_key )._hash[0];
           if( check != m->check ) {
@@ -645,4 +636,241 @@ JNIEXPORT jbyteArray JNICALL Java_AlexandriaJNI_fromBase58(JNIEnv *env, jclass,
    }
 }
 
+namespace {
+
+sophiatx::utilities::batch_thread_pool& batch_pool() {
+   static sophiatx::utilities::batch_thread_pool pool( std::max( std::thread::hardware_concurrency(), 1u ) );
+   return pool;
+}
+
+bool read_bytes(JNIEnv *env, jbyteArray array, std::vector<char>& bytes) {
+   if (array == nullptr) {
+      return false;
+   }
+   jsize length = env->GetArrayLength(array);
+   bytes.resize((size_t)length);
+   if (length > 0) {
+      env->GetByteArrayRegion(array, 0, length, reinterpret_cast<jbyte*>(bytes.data()));
+   }
+   return !env->ExceptionCheck();
+}
+
+bool read_byte_arrays(JNIEnv *env, jobjectArray arrays, std::vector<std::vector<char>>& items) {
+   jsize count = env->GetArrayLength(arrays);
+   items.resize((size_t)count);
+   for (jsize i = 0; i < count; i++) {
+      jbyteArray item = static_cast<jbyteArray>(env->GetObjectArrayElement(arrays, i));
+      bool ok = read_bytes(env, item, items[i]);
+      env->DeleteLocalRef(item);
+      if (!ok) {
+         return false;
+      }
+   }
+   return true;
+}
+
+bool read_strings(JNIEnv *env, jobjectArray strings, std::vector<string>& items) {
+   jsize count = env->GetArrayLength(strings);
+   items.resize((size_t)count);
+   for (jsize i = 0; i < count; i++) {
+      jstring item = static_cast<jstring>(env->GetObjectArrayElement(strings, i));
+      if (item == nullptr) {
+         return false;
+      }
+      const char *chars = env->GetStringUTFChars(item, 0);
+      if (chars == nullptr) {
+         env->DeleteLocalRef(item);
+         return false;
+      }
+      items[i] = chars;
+      env->ReleaseStringUTFChars(item, chars);
+      env->DeleteLocalRef(item);
+   }
+   return true;
+}
+
+/// null elements stand for items that failed
+jobjectArray to_string_array(JNIEnv *env, const std::vector<fc::optional<string>>& items) {
+   jobjectArray ret = env->NewObjectArray(static_cast<jsize>(items.size()), env->FindClass("java/lang/String"), nullptr);
+   if (env->ExceptionCheck() || ret == nullptr) {
+      return nullptr;
+   }
+   for (size_t i = 0; i < items.size(); i++) {
+      if (!items[i]) {
+         continue;
+      }
+      jstring item = env->NewStringUTF(items[i]->c_str());
+      if (env->ExceptionCheck() || item == nullptr) {
+         return nullptr;
+      }
+      env->SetObjectArrayElement(ret, static_cast<jsize>(i), item);
+      env->DeleteLocalRef(item);
+   }
+   return ret;
+}
+
+/// memos are mostly exchanged between the same parties, the secret is derived the first time a pair is used
+fc::sha512 memo_shared_secret(const std::vector<char>& private_key, const std::vector<char>& pub_key) {
+   static shared_secret_cache secrets(1024);
+   auto bin_key = fc::raw::unpack_from_vector<public_key_type::binary_key>(pub_key);
+   auto id = shared_secret_cache::pair_id(private_key.data(), private_key.size(), bin_key.data);
+   return secrets.get(id, [&]() {
+      public_key_type public_key(bin_key.data);
+      fc::ecc::private_key key = fc::variant(private_key).as<fc::ecc::private_key>();
+      return key.get_shared_secret(public_key);
+   });
+}
+
+fc::sha512 memo_encryption_key(int64_t nonce, const fc::sha512& shared_secret) {
+   fc::sha512::encoder enc;
+   fc::raw::pack( enc, nonce );
+   fc::raw::pack( enc, shared_secret );
+   return enc.result();
+}
+
+} // anonymous
+
+JNIEXPORT jobjectArray JNICALL Java_AlexandriaJNI_signDigests(JNIEnv *env, jclass, jobjectArray inJNIDigests,
+                                                              jbyteArray inJNIPrivateKey) {
+   std::vector<std::vector<char>> digests;
+   std::vector<char> private_key;
+   if (!read_byte_arrays(env, inJNIDigests, digests) || !read_bytes(env, inJNIPrivateKey, private_key)) {
+      return nullptr;
+   }
+
+   try {
+      fc::ecc::private_key key = fc::variant(private_key).as<fc::ecc::private_key>();
+      std::vector<compact_signature> signatures(digests.size());
+      batch_pool().run(digests.size(), [&](size_t i) {
+         signatures[i] = key.sign_compact(fc::sha256(digests[i].data(), digests[i].size()));
+      });
+
+      jobjectArray ret = env->NewObjectArray(static_cast<jsize>(signatures.size()), env->FindClass("[B"), nullptr);
+      if (env->ExceptionCheck() || ret == nullptr) {
+         return nullptr;
+      }
+      for (size_t i = 0; i < signatures.size(); i++) {
+         jbyteArray sig = env->NewByteArray(sizeof(compact_signature));
+         if (env->ExceptionCheck() || sig == nullptr) {
+            return nullptr;
+         }
+         env->SetByteArrayRegion(sig, 0, sizeof(compact_signature), reinterpret_cast<jbyte*>(&signatures[i]));
+         env->SetObjectArrayElement(ret, static_cast<jsize>(i), sig);
+         env->DeleteLocalRef(sig);
+         if (env->ExceptionCheck()) {
+            return nullptr;
+         }
+      }
+      return ret;
+   } catch (const fc::exception& e) {
+      return nullptr;
+   }
+}
+
+JNIEXPORT jbooleanArray JNICALL Java_AlexandriaJNI_verifySignatures(JNIEnv *env, jclass, jobjectArray inJNIDigests,
+                                                                    jbyteArray inJNIPublicKey, jobjectArray inJNISignatures) {
+   std::vector<std::vector<char>> digests;
+   std::vector<std::vector<char>> signatures;
+   std::vector<char> pub_key;
+   if (!read_byte_arrays(env, inJNIDigests, digests) || !read_byte_arrays(env, inJNISignatures, signatures) ||
+       !read_bytes(env, inJNIPublicKey, pub_key) || digests.size() != signatures.size()) {
+      return nullptr;
+   }
+
+   try {
+      auto bin_key = fc::raw::unpack_from_vector<public_key_type::binary_key>(pub_key);
+      public_key_type public_key(bin_key.data);
+
+      std::vector<jboolean> valid(digests.size(), JNI_FALSE);
+      batch_pool().run(digests.size(), [&](size_t i) {
+         if (signatures[i].size() != sizeof(compact_signature)) {
+            return;
+         }
+         try {
+            compact_signature signature;
+            memcpy(&signature, signatures[i].data(), sizeof(compact_signature));
+            fc::sha256 dig(digests[i].data(), digests[i].size());
+            valid[i] = public_key == fc::ecc::public_key(signature, dig) ? JNI_TRUE : JNI_FALSE;
+         } catch (const fc::exception& e) {
+         }
+      });
+
+      jbooleanArray ret = env->NewBooleanArray(static_cast<jsize>(valid.size()));
+      if (env->ExceptionCheck() || ret == nullptr) {
+         return nullptr;
+      }
+      env->SetBooleanArrayRegion(ret, 0, static_cast<jsize>(valid.size()), valid.data());
+      if (env->ExceptionCheck()) {
+         return nullptr;
+      }
+      return ret;
+   } catch (const fc::exception& e) {
+      return nullptr;
+   }
+}
+
+JNIEXPORT jobjectArray JNICALL Java_AlexandriaJNI_encryptMemos(JNIEnv *env, jclass, jobjectArray inJNIStrMemos,
+                                                               jbyteArray inJNIPrivateKey, jbyteArray inJNIPublicKey) {
+   std::vector<string> memos;
+   std::vector<char> private_key;
+   std::vector<char> pub_key;
+   if (!read_strings(env, inJNIStrMemos, memos) || !read_bytes(env, inJNIPrivateKey, private_key) ||
+       !read_bytes(env, inJNIPublicKey, pub_key)) {
+      return nullptr;
+   }
+
+   try {
+      auto shared_secret = memo_shared_secret(private_key, pub_key);
+      int64_t nonce = reserve_memo_nonces(std::max<int64_t>(memos.size(), 1));
+
+      std::vector<fc::optional<string>> encrypted(memos.size());
+      batch_pool().run(memos.size(), [&](size_t i) {
+         Java_AlexandriaJNI_memo_data m;
+         m.nonce = nonce + int64_t(i);
+         auto encrypt_key = memo_encryption_key(m.nonce, shared_secret);
+         m.encrypted = fc::aes_encrypt( encrypt_key, fc::raw::pack_to_vector(memos[i]) );
+         m.check = fc::sha256::hash( encrypt_key )._hash[0];
+         encrypted[i] = string(m);
+      });
+      return to_string_array(env, encrypted);
+   } catch (const fc::exception& e) {
+      return nullptr;
+   }
+}
+
+JNIEXPORT jobjectArray JNICALL Java_AlexandriaJNI_decryptMemos(JNIEnv *env, jclass, jobjectArray inJNIStrMemos,
+                                                               jbyteArray inJNIPrivateKey, jbyteArray inJNIPublicKey) {
+   std::vector<string> memos;
+   std::vector<char> private_key;
+   std::vector<char> pub_key;
+   if (!read_strings(env, inJNIStrMemos, memos) || !read_bytes(env, inJNIPrivateKey, private_key) ||
+       !read_bytes(env, inJNIPublicKey, pub_key)) {
+      return nullptr;
+   }
+
+   try {
+      auto shared_secret = memo_shared_secret(private_key, pub_key);
+
+      std::vector<fc::optional<string>> decrypted(memos.size());
+      batch_pool().run(memos.size(), [&](size_t i) {
+         try {
+            auto m = Java_AlexandriaJNI_memo_data::from_string( memos[i] );
+            if (!m) {
+               return;
+            }
+            auto encryption_key = memo_encryption_key(m->nonce, shared_secret);
+            if (fc::sha256::hash( encryption_key )._hash[0] != m->check) {
+               return;
+            }
+            vector<char> plain = fc::aes_decrypt( encryption_key, m->encrypted );
+            decrypted[i] = fc::raw::unpack_from_vector<std::string>( plain );
+         } catch (const fc::exception& e) {
+         }
+      });
+      return to_string_array(env, decrypted);
+   } catch (const fc::exception& e) {
+      return nullptr;
+   }
+}
+
 FC_REFLECT( Java_AlexandriaJNI_memo_data, (nonce)(check)(encrypted) )
\ No newline at end of file
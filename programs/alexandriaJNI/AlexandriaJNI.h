@@ -127,6 +127,38 @@ JNIEXPORT jstring JNICALL Java_AlexandriaJNI_toBase58
 JNIEXPORT jbyteArray JNICALL Java_AlexandriaJNI_fromBase58
       (JNIEnv *, jclass, jstring);
 
+/*
+ * Class:     AlexandriaJNI
+ * Method:    signDigests
+ * Signature: ([[B[B)[[B
+ */
+JNIEXPORT jobjectArray JNICALL Java_AlexandriaJNI_signDigests
+      (JNIEnv *, jclass, jobjectArray, jbyteArray);
+
+/*
+ * Class:     AlexandriaJNI
+ * Method:    verifySignatures
+ * Signature: ([[B[B[[B)[Z
+ */
+JNIEXPORT jbooleanArray JNICALL Java_AlexandriaJNI_verifySignatures
+      (JNIEnv *, jclass, jobjectArray, jbyteArray, jobjectArray);
+
+/*
+ * Class:     AlexandriaJNI
+ * Method:    encryptMemos
+ * Signature: ([Ljava/lang/String;[B[B)[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_AlexandriaJNI_encryptMemos
+      (JNIEnv *, jclass, jobjectArray, jbyteArray, jbyteArray);
+
+/*
+ * Class:     AlexandriaJNI
+ * Method:    decryptMemos
+ * Signature: ([Ljava/lang/String;[B[B)[Ljava/lang/String;
+ */
+JNIEXPORT jobjectArray JNICALL Java_AlexandriaJNI_decryptMemos
+      (JNIEnv *, jclass, jobjectArray, jbyteArray, jbyteArray);
+
 #ifdef __cplusplus
 }
 #endif
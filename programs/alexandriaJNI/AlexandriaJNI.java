@@ -18,6 +18,11 @@ public class AlexandriaJNI {
    public static native byte[] wifToPrivateKey(String wif_key);
    public static native String toBase58(byte[] data);
    public static native byte[] fromBase58(String data);
+   // batch variants, the key is parsed once and the items are processed in parallel, results keep the input order
+   public static native byte[][] signDigests(byte[][] digests, byte[] private_key);
+   public static native boolean[] verifySignatures(byte[][] digests, byte[] public_key, byte[][] signed_digests);
+   public static native String[] encryptMemos(String[] memos, byte[] private_key, byte[] public_key);
+   public static native String[] decryptMemos(String[] memos, byte[] private_key, byte[] public_key);
 
    public static byte[] hexStringToByteArray(String s) {
     int len = s.length();
@@ -53,5 +58,21 @@ public class AlexandriaJNI {
       {
          System.out.println("Encryption failed");
       }
+
+      byte[][] digests = { digest, test.hexStringToByteArray("0101010101010101010101010101010101010101010101010101010101010101") };
+      byte[][] signatures = test.signDigests(digests, private_key);
+      for(boolean valid : test.verifySignatures(digests, public_key, signatures))
+      {
+         if(!valid)
+            System.out.println("Batch signing failed");
+      }
+
+      String[] memos = { "testabc", "testdef" };
+      String[] decrypted = test.decryptMemos(test.encryptMemos(memos, private_key, public_keyB), private_keyB, public_key);
+      for(int i = 0; i < memos.length; i++)
+      {
+         if(!memos[i].equals(decrypted[i]))
+            System.out.println("Batch encryption failed");
+      }
    }
 }
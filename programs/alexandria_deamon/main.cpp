@@ -41,6 +41,7 @@
 #include <sophiatx/protocol/protocol.hpp>
 #include <sophiatx/alexandria/remote_node_api.hpp>
 #include <sophiatx/alexandria/lib_alexandria.hpp>
+#include <sophiatx/alexandria/remote_node_pool.hpp>
 
 #include <fc/interprocess/signals.hpp>
 #include <boost/algorithm/string.hpp>
@@ -68,6 +69,8 @@ int main( int argc, char** argv )
          opts.add_options()
          ("help,h", "Print this help message and exit.")
          ("server-rpc-endpoint,s", bpo::value<string>()->implicit_value("ws://127.0.0.1:9191"), "Server websocket RPC endpoint")
+         ("server-connections,n", bpo::value<uint32_t>()->default_value(4), "Number of websocket connections to the server, calls and broadcasts are spread over them")
+         ("server-binary-rpc", "Fetch blocks and documents from the server over the binary RPC transport")
          ("rpc-endpoint,r", bpo::value<string>()->implicit_value("127.0.0.1:9192"), "Endpoint for alexandria websocket RPC to listen on")
          ("rpc-http-endpoint,H", bpo::value<string>()->implicit_value("127.0.0.1:9195"), "Endpoint for alexandria HTTP RPC to listen on")
          ("rpc-http-cors,C", bpo::value<string>()->implicit_value("*"), "Access-Control-Allow-Origin response header")
@@ -111,13 +114,10 @@ int main( int argc, char** argv )
       if( options.count("server-rpc-endpoint") )
          ws_server = options.at("server-rpc-endpoint").as<std::string>();
 
-      fc::http::websocket_client client;
-      auto con  = client.connect( ws_server );
-      auto apic = std::make_shared<fc::rpc::websocket_api_connection>(*con);
+      auto remote_nodes = std::make_shared<remote_node_pool>( ws_server, options.at("server-connections").as<uint32_t>(),
+                                                              options.count("server-binary-rpc") > 0 );
 
-      auto remote_api = apic->get_remote_api< sophiatx::alexandria::remote_node_api >( 0, "condenser_api" );
-
-      auto alex_apiptr = std::make_shared<alexandria_api>( remote_api );
+      auto alex_apiptr = std::make_shared<alexandria_api>( remote_nodes );
 
       fc::api<alexandria_api> alex_api(alex_apiptr);
 
@@ -125,12 +125,6 @@ int main( int argc, char** argv )
       for( auto& name_formatter : alex_apiptr->get_result_formatters() )
          alexandria_deamon->format_result( name_formatter.first, name_formatter.second );
 
-      boost::signals2::scoped_connection closed_connection(con->closed.connect([=]{
-         cerr << "Server has disconnected us.\n";
-         alexandria_deamon->stop();
-      }));
-      (void)(closed_connection);
-
       auto _websocket_server = std::make_shared<fc::http::websocket_server>();
       if( options.count("rpc-endpoint") )
         {
@@ -183,8 +177,6 @@ int main( int argc, char** argv )
         ilog( "Entering Daemon Mode, ^C to exit" );
         exit_promise->wait();
       }
-
-      closed_connection.disconnect();
    }
    catch ( const fc::exception& e )
    {
@@ -75,6 +75,7 @@ int main( int argc, char** argv )
          opts.add_options()
          ("help,h", "Print this help message and exit.")
          ("server-rpc-endpoint,s", bpo::value<string>()->implicit_value("ws://127.0.0.1:9191"), "Server websocket RPC endpoint")
+         ("server-binary-rpc", "Fetch blocks and documents from the server over the binary RPC transport")
          ("cert-authority,a", bpo::value<string>()->default_value("_default"), "Trusted CA bundle file for connecting to wss:// TLS server")
          ("rpc-endpoint,r", bpo::value<string>()->implicit_value("127.0.0.1:9192"), "Endpoint for wallet websocket RPC to listen on")
          ("rpc-tls-endpoint,t", bpo::value<string>()->implicit_value("127.0.0.1:9194"), "Endpoint for wallet websocket TLS RPC to listen on")
@@ -161,6 +162,8 @@ int main( int argc, char** argv )
       auto remote_api = apic->get_remote_api< sophiatx::wallet::remote_node_api >( 0, "condenser_api" );
 
       auto wapiptr = std::make_shared<wallet_api>( wdata, _sophiatx_chain_id, remote_api );
+      if( options.count("server-binary-rpc") )
+         wapiptr->use_binary_rpc( std::make_shared< sophiatx::plugins::json_rpc::binary_rpc_client >( wdata.ws_server ) );
       wapiptr->set_wallet_filename( wallet_file.generic_string() );
       wapiptr->load_wallet_file();
 
@@ -2,7 +2,10 @@
 #include <sophiatx/protocol/fixed_string.hpp>
 
 #include <fc/io/raw.hpp>
+#include <fc/crypto/base64m.hpp>
 
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -85,6 +88,79 @@ void check_pack( const std::string& s, const sophiatx::protocol::fixed_string_im
    }
 }
 
+// The conversions fixed_string_impl used to do through fc, for comparison
+template< typename Storage >
+sophiatx::protocol::fixed_string_impl< Storage > fc_from_string( const std::string& str )
+{
+   std::string tmp_str = str;
+   while(tmp_str.size() % 4)
+      tmp_str +='A';
+
+   std::string s = fc::base64m_decode(tmp_str);
+   sophiatx::protocol::fixed_string_impl< Storage > result;
+   Storage d;
+   result._size = std::min( s.size(), sizeof(d) );
+   memcpy( (char*)&d, s.c_str(), result._size );
+   result.data = boost::endian::big_to_native( d );
+   return result;
+}
+
+template< typename Storage >
+std::string fc_to_string( const sophiatx::protocol::fixed_string_impl< Storage >& fs )
+{
+   Storage d = boost::endian::native_to_big( fs.data );
+   unsigned char data[sizeof(Storage)+2] = {};
+   memcpy( data, (char*)&d, fs._size );
+   std::string s = fc::base64m_encode( data, ( fs._size + 2 ) / 3 * 3 );
+   while( s.size() && s.back() == 'A' )
+      s.pop_back();
+   return s;
+}
+
+template< typename Storage >
+void check_fc_conversions( const std::string& s )
+{
+   sophiatx::protocol::fixed_string_impl< Storage > fs( s ), old_fs = fc_from_string< Storage >( s );
+   if( fs != old_fs || fs.size() != old_fs.size() )
+   {
+      std::cout << "decoding differs from fc on " << s << std::endl;
+      ++errors;
+   }
+   else if( fs.size() && std::string( fs ) != fc_to_string( old_fs ) )
+   {
+      std::cout << "encoding differs from fc on " << s << std::endl;
+      ++errors;
+   }
+}
+
+template< typename Storage >
+void benchmark_conversions( const std::vector< std::string >& names )
+{
+   typedef std::chrono::high_resolution_clock clock;
+   const int rounds = 20;
+   size_t checksum = 0;
+
+   auto start = clock::now();
+   for( int r = 0; r < rounds; r++ )
+      for( const auto& n : names )
+         checksum += fc_to_string( fc_from_string< Storage >( n ) ).size();
+   auto fc_time = std::chrono::duration_cast< std::chrono::microseconds >( clock::now() - start ).count();
+
+   start = clock::now();
+   for( int r = 0; r < rounds; r++ )
+      for( const auto& n : names )
+         checksum -= std::string( sophiatx::protocol::fixed_string_impl< Storage >( n ) ).size();
+   auto table_time = std::chrono::duration_cast< std::chrono::microseconds >( clock::now() - start ).count();
+
+   std::cout << "fixed_string< " << sizeof( Storage ) << " > round trip of " << rounds * names.size() << " names: fc "
+             << fc_time << " us, tables " << table_time << " us" << std::endl;
+   if( checksum != 0 )
+   {
+      std::cout << "benchmark round trips differ in length" << std::endl;
+      ++errors;
+   }
+}
+
 int main( int argc, char** argv, char** envp )
 {
    std::vector< std::string > all_strings;
@@ -314,5 +390,33 @@ int main( int argc, char** argv, char** envp )
 
    result |= (errors == 0) ? 0 : 1;
 
+   errors = 0;
+   std::vector< std::string > names = { "", "a", "ab", "abc", "abcd", "initminer", "alice.bob", "abA", "AbcA",
+      "$from", "$from.vesting", "a=b", "abc==", "ab-cd", "this.is.a.longer.name", "zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz",
+      "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789" };
+   for( int i = 0; i < 1000; i++ )
+   {
+      unsigned char bytes[21];
+      for( size_t j = 0; j < sizeof( bytes ); j++ )
+         bytes[j] = uint8_t( i * 31 + j * 17 );
+      names.push_back( fc::base64m_encode( bytes, 21 ) );
+   }
+
+   std::cout << "checking conversions against fc" << std::endl;
+   for( const auto& n : names )
+   {
+      check_fc_conversions< fc::uint128_t >( n );
+      check_fc_conversions< fc::erpair< fc::uint128_t, uint64_t > >( n );
+      check_fc_conversions< fc::erpair< fc::uint128_t, fc::uint128_t > >( n );
+   }
+
+   benchmark_conversions< fc::uint128_t >( names );
+   benchmark_conversions< fc::erpair< fc::uint128_t, uint64_t > >( names );
+   benchmark_conversions< fc::erpair< fc::uint128_t, fc::uint128_t > >( names );
+
+   std::cout << "test_fixed_string_fc found " << errors << " errors" << std::endl;
+
+   result |= (errors == 0) ? 0 : 1;
+
    return result;
 }
@@ -0,0 +1,103 @@
+#include <boost/test/unit_test.hpp>
+
+#include <sophiatx/alexandria/lib_alexandria.hpp>
+#include <sophiatx/alexandria/remote_node_pool.hpp>
+#include <sophiatx/utilities/key_conversion.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+using namespace sophiatx::alexandria;
+
+namespace {
+
+/// the batch apis do not talk to the node
+std::shared_ptr< alexandria_api > make_api()
+{
+   return std::make_shared< alexandria_api >( std::make_shared< remote_node_pool >( fc::api< remote_node_api >() ) );
+}
+
+fc::ecc::private_key make_key( const std::string& seed )
+{
+   return fc::ecc::private_key::regenerate( fc::sha256::hash( seed ) );
+}
+
+} // anonymous
+
+BOOST_AUTO_TEST_SUITE( alexandria_batch_tests )
+
+BOOST_AUTO_TEST_CASE( sign_and_verify_batch )
+{
+   try
+   {
+      auto api = make_api();
+      auto key = make_key( "alice" );
+      std::vector< digest_type > digests;
+      for( int i = 0; i < 50; ++i )
+         digests.push_back( fc::sha256::hash( std::to_string( i ) ) );
+
+      auto signatures = api->sign_digest_batch( digests, sophiatx::utilities::key_to_wif( key ) );
+      BOOST_REQUIRE_EQUAL( signatures.size(), digests.size() );
+      for( size_t i = 0; i < digests.size(); ++i )
+         BOOST_REQUIRE( signatures[i] == key.sign_compact( digests[i] ) );
+
+      auto valid = api->verify_signature_batch( digests, key.get_public_key(), signatures );
+      BOOST_REQUIRE_EQUAL( valid.size(), digests.size() );
+      BOOST_REQUIRE( std::all_of( valid.begin(), valid.end(), []( bool v ) { return v; } ) );
+
+      BOOST_TEST_MESSAGE( "--- Wrong digests, keys and signatures fail individually" );
+      std::swap( signatures[3], signatures[4] );
+      fc::ecc::compact_signature garbage;
+      memset( garbage.data, 0xff, sizeof( garbage.data ) );
+      signatures[7] = garbage;
+      valid = api->verify_signature_batch( digests, key.get_public_key(), signatures );
+      for( size_t i = 0; i < digests.size(); ++i )
+         BOOST_REQUIRE_EQUAL( valid[i], i != 3 && i != 4 && i != 7 );
+
+      valid = api->verify_signature_batch( digests, make_key( "bob" ).get_public_key(), signatures );
+      BOOST_REQUIRE( std::none_of( valid.begin(), valid.end(), []( bool v ) { return v; } ) );
+
+      BOOST_REQUIRE_THROW( api->verify_signature_batch( digests, key.get_public_key(), {} ), fc::exception );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( encrypt_and_decrypt_batch )
+{
+   try
+   {
+      auto api = make_api();
+      auto alice = make_key( "alice" );
+      auto bob = make_key( "bob" );
+      std::vector< std::string > data;
+      for( int i = 0; i < 50; ++i )
+         data.push_back( "memo " + std::to_string( i ) );
+
+      auto encrypted = api->encrypt_data_batch( data, bob.get_public_key(), sophiatx::utilities::key_to_wif( alice ) );
+      BOOST_REQUIRE_EQUAL( encrypted.size(), data.size() );
+
+      BOOST_TEST_MESSAGE( "--- The recipient decrypts the batch with the sender's public key" );
+      auto decrypted = api->decrypt_data_batch( encrypted, alice.get_public_key(), sophiatx::utilities::key_to_wif( bob ) );
+      BOOST_REQUIRE( decrypted == data );
+      BOOST_REQUIRE_EQUAL( api->decrypt_data( encrypted[5], alice.get_public_key(), sophiatx::utilities::key_to_wif( bob ) ), data[5] );
+
+      BOOST_TEST_MESSAGE( "--- Batches and single memos never share a nonce" );
+      auto again = api->encrypt_data_batch( data, bob.get_public_key(), sophiatx::utilities::key_to_wif( alice ) );
+      auto single = api->encrypt_data( data[0], bob.get_public_key(), sophiatx::utilities::key_to_wif( alice ) );
+      std::set< int64_t > nonces;
+      for( const auto& e : encrypted )
+         nonces.insert( memo_data::from_string( e )->nonce );
+      for( const auto& e : again )
+         nonces.insert( memo_data::from_string( e )->nonce );
+      nonces.insert( memo_data::from_string( single )->nonce );
+      BOOST_REQUIRE_EQUAL( nonces.size(), 2 * data.size() + 1 );
+
+      BOOST_TEST_MESSAGE( "--- A memo for someone else fails the batch" );
+      encrypted[2] = api->encrypt_data( data[2], make_key( "carol" ).get_public_key(), sophiatx::utilities::key_to_wif( alice ) );
+      BOOST_REQUIRE_THROW( api->decrypt_data_batch( encrypted, alice.get_public_key(), sophiatx::utilities::key_to_wif( bob ) ), fc::exception );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
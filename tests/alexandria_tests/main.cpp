@@ -0,0 +1,6 @@
+#include <boost/test/included/unit_test.hpp>
+
+boost::unit_test::test_suite* init_unit_test_suite(int argc, char* argv[])
+{
+   return nullptr;
+}
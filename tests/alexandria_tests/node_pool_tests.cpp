@@ -0,0 +1,156 @@
+#include <boost/test/unit_test.hpp>
+
+#include <sophiatx/alexandria/confirmation_tracker.hpp>
+#include <sophiatx/alexandria/remote_node_pool.hpp>
+
+#include <fc/thread/thread.hpp>
+
+#include <algorithm>
+
+using namespace sophiatx::alexandria;
+
+namespace {
+
+/// a connection whose get_dynamic_global_properties reports head_block_number and counts the calls
+std::shared_ptr< remote_node_pool::node_connection > make_connection( uint32_t& calls, uint32_t head_block_number )
+{
+   auto c = std::make_shared< remote_node_pool::node_connection >();
+   c->api->get_dynamic_global_properties = [&calls, head_block_number]()
+   {
+      ++calls;
+      sophiatx::plugins::condenser_api::extended_dynamic_global_properties props;
+      props.head_block_number = head_block_number;
+      props.head_block_id._hash[0] = head_block_number;
+      props.time = fc::time_point_sec( 1000000 + head_block_number * SOPHIATX_BLOCK_INTERVAL );
+      return props;
+   };
+   return c;
+}
+
+transaction_id_type make_id( uint32_t n )
+{
+   transaction_id_type id;
+   id._hash[0] = n;
+   return id;
+}
+
+} // anonymous
+
+BOOST_AUTO_TEST_SUITE( alexandria_node_pool_tests )
+
+BOOST_AUTO_TEST_CASE( round_robin_and_reconnect )
+{
+   try
+   {
+      uint32_t calls = 0;
+      std::vector< std::weak_ptr< remote_node_pool::node_connection > > opened;
+      remote_node_pool pool( [&]()
+      {
+         auto c = make_connection( calls, opened.size() );
+         opened.push_back( c );
+         return c;
+      }, 2 );
+      BOOST_REQUIRE_EQUAL( pool.size(), 2u );
+      BOOST_REQUIRE_EQUAL( opened.size(), 2u );
+
+      BOOST_TEST_MESSAGE( "--- Connections are handed out round robin" );
+      BOOST_REQUIRE_EQUAL( pool.get()->get_dynamic_global_properties().head_block_number, 0u );
+      BOOST_REQUIRE_EQUAL( pool.get()->get_dynamic_global_properties().head_block_number, 1u );
+      BOOST_REQUIRE_EQUAL( pool.get()->get_dynamic_global_properties().head_block_number, 0u );
+
+      BOOST_TEST_MESSAGE( "--- A closed connection is replaced and freed after its last lease" );
+      auto in_flight = pool.get(); // connection 1
+      opened[1].lock()->closed = true;
+      pool.get(); // connection 0
+      BOOST_REQUIRE_EQUAL( pool.get()->get_dynamic_global_properties().head_block_number, 2u );
+      BOOST_REQUIRE_EQUAL( opened.size(), 3u );
+      BOOST_REQUIRE( !opened[1].expired() );
+      BOOST_REQUIRE_EQUAL( in_flight->get_dynamic_global_properties().head_block_number, 1u );
+      in_flight = pool.get();
+      BOOST_REQUIRE( opened[1].expired() );
+
+      BOOST_TEST_MESSAGE( "--- A flapping node does not accumulate connections" );
+      for( int i = 0; i < 100; ++i )
+      {
+         opened.back().lock()->closed = true;
+         pool.get();
+         pool.get();
+      }
+      size_t alive = std::count_if( opened.begin(), opened.end(), []( const auto& c ) { return !c.expired(); } );
+      BOOST_REQUIRE_LE( alive, 3u ); // two pooled ones and the one in_flight holds
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( reference_block_cache )
+{
+   try
+   {
+      uint32_t calls = 0;
+      uint32_t head = 10;
+      remote_node_pool pool( [&]() { return make_connection( calls, head++ ); }, 1 );
+
+      auto first = pool.get_reference_block();
+      auto second = pool.get_reference_block();
+      BOOST_REQUIRE_EQUAL( calls, 1u );
+      BOOST_REQUIRE( first.head_block_id == second.head_block_id );
+      BOOST_REQUIRE( first.time == fc::time_point_sec( 1000000 + 10 * SOPHIATX_BLOCK_INTERVAL ) );
+
+      BOOST_TEST_MESSAGE( "--- The reference is fetched again once it is a block interval old" );
+      fc::usleep( fc::seconds( SOPHIATX_BLOCK_INTERVAL ) );
+      auto third = pool.get_reference_block();
+      BOOST_REQUIRE_EQUAL( calls, 2u );
+      BOOST_REQUIRE( third.fetched > first.fetched );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( confirmation_tracking )
+{
+   try
+   {
+      confirmation_tracker tracker( 2 );
+      BOOST_REQUIRE( !tracker.find( make_id( 1 ) ).valid() );
+
+      tracker.start( make_id( 1 ) );
+      BOOST_REQUIRE( tracker.find( make_id( 1 ) ).valid() );
+      BOOST_REQUIRE( !tracker.find( make_id( 1 ) )->confirmed );
+
+      transaction_confirmation c;
+      c.id = make_id( 1 );
+      c.confirmed = true;
+      c.block_num = 5;
+      tracker.finish( c );
+      BOOST_REQUIRE( tracker.find( make_id( 1 ) )->confirmed );
+      BOOST_REQUIRE_EQUAL( tracker.find( make_id( 1 ) )->block_num, 5u );
+
+      BOOST_TEST_MESSAGE( "--- The oldest outcomes are forgotten" );
+      for( uint32_t n = 2; n <= 3; ++n )
+      {
+         tracker.start( make_id( n ) );
+         c.id = make_id( n );
+         tracker.finish( c );
+      }
+      BOOST_REQUIRE( !tracker.find( make_id( 1 ) ).valid() );
+      BOOST_REQUIRE( tracker.find( make_id( 2 ) ).valid() );
+      BOOST_REQUIRE( tracker.find( make_id( 3 ) ).valid() );
+
+      BOOST_TEST_MESSAGE( "--- Forgetting an earlier broadcast keeps the outcome of the rebroadcast" );
+      tracker.start( make_id( 2 ) );
+      c.id = make_id( 2 );
+      c.block_num = 7;
+      tracker.finish( c );
+      c.id = make_id( 4 );
+      tracker.finish( c ); // drops the first outcome of 2
+      BOOST_REQUIRE( tracker.find( make_id( 2 ) ).valid() );
+      BOOST_REQUIRE_EQUAL( tracker.find( make_id( 2 ) )->block_num, 7u );
+      c.id = make_id( 5 );
+      tracker.finish( c ); // drops 3 and the outcome of the rebroadcast
+      BOOST_REQUIRE( !tracker.find( make_id( 2 ) ).valid() );
+      BOOST_REQUIRE( !tracker.find( make_id( 3 ) ).valid() );
+      BOOST_REQUIRE_EQUAL( tracker.size(), 2u );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,289 @@
+#include <boost/test/unit_test.hpp>
+
+#include <sophiatx/chain/account_object.hpp>
+#include <sophiatx/chain/database.hpp>
+#include <sophiatx/chain/witness_objects.hpp>
+
+#include <fc/io/json.hpp>
+
+#include "../db_fixture/database_fixture.hpp"
+
+#include <fstream>
+#include <functional>
+
+using namespace sophiatx;
+using namespace sophiatx::chain;
+using namespace sophiatx::protocol;
+
+/**
+ * Block application benchmarks.  Every test case synthesizes one workload, produces blocks from it with
+ * generate_block() and writes one JSON line per measurement, e.g. with the wall time and the block_profile of
+ * those blocks.
+ *
+ * Options are passed after "--":
+ *    chain_bench -- --blocks 20 --transactions 100 --recipients 10 --output bench.json
+ */
+struct bench_fixture : public clean_database_fixture
+{
+   struct bench_account
+   {
+      string                  name;
+      fc::ecc::private_key    key;
+   };
+
+   uint32_t    blocks = 20;
+   uint32_t    transactions = 100;
+   uint32_t    recipients = 10;
+   string      output;
+   uint32_t    sequence = 0;
+
+   bench_fixture()
+   {
+      int argc = boost::unit_test::framework::master_test_suite().argc;
+      char** argv = boost::unit_test::framework::master_test_suite().argv;
+      for( int i = 1; i + 1 < argc; i++ )
+      {
+         const std::string arg = argv[i];
+         if( arg == "--blocks" )
+            blocks = std::stoul( argv[++i] );
+         else if( arg == "--transactions" )
+            transactions = std::stoul( argv[++i] );
+         else if( arg == "--recipients" )
+            recipients = std::stoul( argv[++i] );
+         else if( arg == "--output" )
+            output = argv[++i];
+      }
+   }
+
+   vector< bench_account > create_accounts( const string& prefix, uint32_t count, const asset& balance )
+   {
+      vector< bench_account > accounts;
+      for( uint32_t i = 0; i < count; i++ )
+      {
+         bench_account a{ prefix + fc::to_string( i ), generate_private_key( prefix + fc::to_string( i ) ) };
+         account_create( a.name, a.key.get_public_key() );
+         if( balance.amount > 0 )
+            fund( AN( a.name ), balance );
+         accounts.push_back( a );
+      }
+      generate_block();
+      return accounts;
+   }
+
+   void push( const operation& op, const fc::ecc::private_key& key )
+   {
+      signed_transaction tx;
+      tx.operations.push_back( op );
+      tx.set_expiration( db->head_block_time() + SOPHIATX_MAX_TIME_UNTIL_EXPIRATION );
+      tx.sign( key, db->get_chain_id() );
+      db->push_transaction( tx, 0 );
+   }
+
+   /// pushes `transactions` transactions made by make_tx( block, transaction ) before each of `blocks` blocks
+   void run( const string& workload, const std::function< void( uint32_t, uint32_t ) >& make_tx )
+   {
+      fc::microseconds push_time, generate_time;
+      uint32_t included = 0;
+
+      db->reset_block_profile();
+      db->set_block_profiling( true );
+      for( uint32_t b = 0; b < blocks; b++ )
+      {
+         auto start = fc::time_point::now();
+         for( uint32_t t = 0; t < transactions; t++ )
+            make_tx( b, t );
+         push_time += fc::time_point::now() - start;
+
+         start = fc::time_point::now();
+         generate_block();
+         generate_time += fc::time_point::now() - start;
+         included += db->fetch_block_by_number( db->head_block_num() )->transactions.size();
+      }
+      db->set_block_profiling( false );
+      validate_database();
+
+      fc::variant profile;
+      fc::to_variant( db->get_block_profile(), profile );
+      emit( fc::mutable_variant_object()
+         ( "workload", workload )
+         ( "blocks", blocks )
+         ( "transactions", included )
+         ( "push_us", push_time.count() )
+         ( "generate_block_us", generate_time.count() )
+         ( "profile", profile ) );
+   }
+
+   /// prints one JSON line and appends it to the output file
+   void emit( const fc::variant_object& result )
+   {
+      std::string line = fc::json::to_string( result );
+
+      std::cout << line << std::endl;
+      if( output.size() )
+      {
+         std::ofstream out( output, std::ios::app );
+         out << line << '\n';
+      }
+   }
+};
+
+BOOST_FIXTURE_TEST_SUITE( chain_bench, bench_fixture )
+
+BOOST_AUTO_TEST_CASE( transfers )
+{
+   try
+   {
+      auto senders = create_accounts( "sender", transactions, ASSET( "100000.000000 SPHTX" ) );
+      auto receivers = create_accounts( "receiver", transactions, asset( 0, SOPHIATX_SYMBOL ) );
+
+      run( "transfers", [&]( uint32_t b, uint32_t t )
+      {
+         transfer_operation op;
+         op.from = AN( senders[t].name );
+         op.to = AN( receivers[ ( t + b ) % receivers.size() ].name );
+         op.amount = asset( 1000 + b, SOPHIATX_SYMBOL );
+         op.fee = ASSET( "0.100000 SPHTX" );
+         push( op, senders[t].key );
+      });
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( custom_json )
+{
+   try
+   {
+      auto senders = create_accounts( "sender", transactions, ASSET( "100000.000000 SPHTX" ) );
+      auto receivers = create_accounts( "receiver", recipients, asset( 0, SOPHIATX_SYMBOL ) );
+
+      run( "custom_json", [&]( uint32_t b, uint32_t t )
+      {
+         custom_json_operation op;
+         op.sender = AN( senders[t].name );
+         for( const auto& r : receivers )
+            op.recipients.insert( AN( r.name ) );
+         op.app_id = 1;
+         op.json = "{\"block\":" + fc::to_string( b ) + "}";
+         op.fee = ASSET( "0.100000 SPHTX" );
+         push( op, senders[t].key );
+      });
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( account_creation )
+{
+   try
+   {
+      auto creators = create_accounts( "creator", transactions, ASSET( "100000.000000 SPHTX" ) );
+      share_type fee = std::max( db->get_witness_schedule_object().median_props.account_creation_fee.amount, share_type( 100 ) );
+
+      run( "account_creation", [&]( uint32_t b, uint32_t t )
+      {
+         auto key = generate_private_key( "created" ).get_public_key();
+         account_create_operation op;
+         op.creator = AN( creators[t].name );
+         op.name_seed = "created" + fc::to_string( ++sequence );
+         op.fee = asset( fee, SOPHIATX_SYMBOL );
+         op.owner = authority( 1, key, 1 );
+         op.active = authority( 1, key, 1 );
+         op.memo_key = key;
+         push( op, creators[t].key );
+      });
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( escrow )
+{
+   try
+   {
+      auto senders = create_accounts( "sender", transactions, ASSET( "100000.000000 SPHTX" ) );
+      auto parties = create_accounts( "party", 2, asset( 0, SOPHIATX_SYMBOL ) );
+
+      run( "escrow", [&]( uint32_t b, uint32_t t )
+      {
+         escrow_transfer_operation op;
+         op.from = AN( senders[t].name );
+         op.to = AN( parties[0].name );
+         op.agent = AN( parties[1].name );
+         op.escrow_id = b;
+         op.sophiatx_amount = ASSET( "1.000000 SPHTX" );
+         op.escrow_fee = ASSET( "0.100000 SPHTX" );
+         op.fee = ASSET( "0.100000 SPHTX" );
+         op.ratification_deadline = db->head_block_time() + SOPHIATX_BLOCK_INTERVAL * ( blocks + 10 );
+         op.escrow_expiration = op.ratification_deadline + SOPHIATX_BLOCK_INTERVAL;
+         push( op, senders[t].key );
+      });
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( witness_votes )
+{
+   try
+   {
+      auto voters = create_accounts( "voter", transactions, ASSET( "100000.000000 SPHTX" ) );
+      vector< account_name_type > witnesses;
+      for( const auto& w : db->get_index< witness_index, by_id >() )
+         witnesses.push_back( w.owner );
+
+      // every voter approves a witness in one block and removes the vote in the next
+      run( "witness_votes", [&]( uint32_t b, uint32_t t )
+      {
+         account_witness_vote_operation op;
+         op.account = AN( voters[t].name );
+         op.witness = witnesses[ ( b / 2 + t ) % witnesses.size() ];
+         op.approve = ( b % 2 == 0 );
+         op.fee = ASSET( "0.100000 SPHTX" );
+         push( op, voters[t].key );
+      });
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( pending_pool )
+{
+   try
+   {
+      auto senders = create_accounts( "sender", transactions, ASSET( "100000.000000 SPHTX" ) );
+      auto receivers = create_accounts( "receiver", recipients, asset( 0, SOPHIATX_SYMBOL ) );
+
+      uint32_t applied = 0;
+      boost::signals2::scoped_connection counter = db->on_pre_apply_transaction.connect(
+         [&]( const signed_transaction& ) { ++applied; } );
+
+      // block production time by the size of the pending pool, each sender pushes pool_size / transactions
+      for( uint32_t pool_size : { transactions, transactions * 10 } )
+      {
+         for( uint32_t t = 0; t < pool_size; t++ )
+         {
+            transfer_operation op;
+            op.from = AN( senders[ t % senders.size() ].name );
+            op.to = AN( receivers[ t % receivers.size() ].name );
+            op.amount = asset( 1000 + t, SOPHIATX_SYMBOL );
+            op.fee = ASSET( "0.100000 SPHTX" );
+            push( op, senders[ t % senders.size() ].key );
+         }
+
+         applied = 0;
+         auto start = fc::time_point::now();
+         generate_block();
+         auto generate_time = fc::time_point::now() - start;
+
+         emit( fc::mutable_variant_object()
+            ( "workload", "pending_pool" )
+            ( "pool", pool_size )
+            ( "transactions", db->fetch_block_by_number( db->head_block_num() )->transactions.size() )
+            ( "applied", applied )
+            ( "generate_block_us", generate_time.count() ) );
+
+         while( db->get_pending_transactions().size() )
+            generate_block();
+      }
+      validate_database();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
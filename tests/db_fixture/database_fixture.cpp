@@ -584,7 +584,7 @@ void database_fixture::validate_database( void )
 {
    try
    {
-      db->validate_invariants();
+      db->audit_invariants();
 #ifdef SOPHIATX_ENABLE_SMT
       db->validate_smt_invariants();
 #endif
@@ -0,0 +1,203 @@
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/net/config.hpp>
+#include <graphene/net/core_messages.hpp>
+#include <graphene/net/io_thread_pool.hpp>
+#include <graphene/net/message_oriented_connection.hpp>
+
+#include <fc/network/tcp_socket.hpp>
+#include <fc/thread/thread.hpp>
+
+#include <functional>
+#include <set>
+#include <vector>
+
+using namespace graphene::net;
+
+namespace {
+
+/// records what is delivered, in order, optionally yielding inside on_message like a busy p2p thread
+struct recording_delegate : public message_oriented_connection_delegate
+{
+   std::vector< int64_t >  received;
+   uint32_t                closed = 0;
+   bool                    closed_after_messages = true;
+   fc::microseconds        handling_time;
+   /// called on the first message, while its handling has not finished yet
+   std::function< void() > on_first_message;
+
+   virtual void on_message( message_oriented_connection*, const message& received_message ) override
+   {
+      if( closed )
+         closed_after_messages = false;
+      received.push_back( received_message.as< current_time_request_message >().request_sent_time.time_since_epoch().count() );
+      if( received.size() == 1 && on_first_message )
+         on_first_message();
+      if( handling_time.count() )
+         fc::usleep( handling_time );
+   }
+
+   virtual void on_connection_closed( message_oriented_connection* ) override
+   {
+      ++closed;
+   }
+};
+
+struct connection_pair
+{
+   io_thread_pool                               pool;
+   recording_delegate                           client_delegate;
+   recording_delegate                           server_delegate;
+   std::unique_ptr< message_oriented_connection > client;
+   std::unique_ptr< message_oriented_connection > server;
+
+   explicit connection_pair( uint32_t io_threads ) : pool( io_threads )
+   {
+      client.reset( new message_oriented_connection( &client_delegate, pool.get_thread() ) );
+      server.reset( new message_oriented_connection( &server_delegate, pool.get_thread() ) );
+
+      fc::tcp_server listener;
+      listener.listen( fc::ip::endpoint( fc::ip::address( "127.0.0.1" ), 0 ) );
+      auto connected = fc::async( [&]()
+      {
+         client->connect_to( fc::ip::endpoint( fc::ip::address( "127.0.0.1" ), listener.get_local_endpoint().port() ) );
+      }, "connect test client" );
+      listener.accept( server->get_socket() );
+      server->accept();
+      connected.wait();
+   }
+
+   ~connection_pair()
+   {
+      client.reset();
+      server.reset();
+   }
+
+   void send( int64_t first, int64_t count, uint32_t padding = 0 )
+   {
+      for( int64_t i = first; i < first + count; ++i )
+      {
+         message m( current_time_request_message( fc::time_point( fc::microseconds( i ) ) ) );
+         m.data.resize( m.data.size() + padding );
+         m.size = m.data.size();
+         client->send_message( m );
+      }
+   }
+
+   /// waits on the test's thread, which is also the delegates' thread, until done() or the timeout
+   template< typename Predicate >
+   bool wait_for( Predicate done, fc::microseconds timeout = fc::seconds( 10 ) )
+   {
+      auto deadline = fc::time_point::now() + timeout;
+      while( !done() && fc::time_point::now() < deadline )
+         fc::usleep( fc::milliseconds( 5 ) );
+      return done();
+   }
+};
+
+std::vector< int64_t > sequence( int64_t count )
+{
+   std::vector< int64_t > result;
+   for( int64_t i = 0; i < count; ++i )
+      result.push_back( i );
+   return result;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( message_oriented_connection_tests )
+
+BOOST_AUTO_TEST_CASE( io_thread_pool_assignment )
+{
+   io_thread_pool disabled;
+   BOOST_REQUIRE( disabled.get_thread() == nullptr );
+
+   io_thread_pool pool( 2 );
+   fc::thread* first = pool.get_thread();
+   fc::thread* second = pool.get_thread();
+   BOOST_REQUIRE( first != nullptr && second != nullptr );
+   BOOST_REQUIRE( first != second );
+   BOOST_REQUIRE( first != &fc::thread::current() );
+   std::set< fc::thread* > assigned{ pool.get_thread(), pool.get_thread() };
+   BOOST_REQUIRE( assigned == ( std::set< fc::thread* >{ first, second } ) );
+
+   BOOST_TEST_MESSAGE( "--- Growing the pool starts another thread, shrinking keeps the running ones" );
+   pool.resize( 3 );
+   fc::thread* third = pool.get_thread();
+   BOOST_REQUIRE( third != first && third != second );
+   pool.resize( 1 );
+   BOOST_REQUIRE_EQUAL( pool.size(), 1u );
+   BOOST_REQUIRE( pool.get_thread() == first );
+
+   pool.resize( 0 );
+   BOOST_REQUIRE( pool.get_thread() == nullptr );
+}
+
+BOOST_AUTO_TEST_CASE( delivery_order )
+{
+   for( uint32_t io_threads : { 0u, 2u } )
+   {
+      BOOST_TEST_MESSAGE( "--- Messages arrive in order with " << io_threads << " io threads" );
+      connection_pair c( io_threads );
+      c.send( 0, 500 );
+      BOOST_REQUIRE( c.wait_for( [&]() { return c.server_delegate.received.size() == 500; } ) );
+      BOOST_REQUIRE( c.server_delegate.received == sequence( 500 ) );
+      BOOST_REQUIRE_EQUAL( c.server_delegate.closed, 0u );
+   }
+}
+
+BOOST_AUTO_TEST_CASE( delivery_back_pressure )
+{
+   connection_pair c( 2 );
+   const uint32_t padding = 16 * 1024;
+   const int64_t count = GRAPHENE_NET_MAX_QUEUED_RECEIVED_MESSAGES * 4;
+
+   // the delegate's thread is stalled on the first message, so the io thread has to stop reading
+   uint64_t bytes_read_while_stalled = 0;
+   c.server_delegate.on_first_message = [&]()
+   {
+      fc::usleep( fc::milliseconds( 500 ) );
+      bytes_read_while_stalled = c.server->get_total_bytes_received();
+   };
+   auto sent = fc::async( [&]() { c.send( 0, count, padding ); }, "send test messages" );
+
+   BOOST_REQUIRE( c.wait_for( [&]() { return c.server_delegate.received.size() == size_t( count ); } ) );
+   sent.wait();
+   BOOST_REQUIRE( c.server_delegate.received == sequence( count ) );
+   BOOST_TEST_MESSAGE( "read " << bytes_read_while_stalled << " bytes while stalled" );
+   BOOST_REQUIRE_LT( bytes_read_while_stalled, uint64_t( GRAPHENE_NET_MAX_QUEUED_RECEIVED_MESSAGES + 8 ) * padding );
+   BOOST_REQUIRE_GE( c.server->get_total_bytes_received(), uint64_t( count ) * padding );
+}
+
+BOOST_AUTO_TEST_CASE( delivery_close )
+{
+   connection_pair c( 2 );
+
+   BOOST_TEST_MESSAGE( "--- The connection closed notification comes once, after the messages read before it" );
+   c.server_delegate.handling_time = fc::milliseconds( 1 );
+   c.send( 0, 100 );
+   c.client->close_connection();
+   BOOST_REQUIRE( c.wait_for( [&]() { return c.server_delegate.closed > 0; } ) );
+   fc::usleep( fc::milliseconds( 100 ) );
+   BOOST_REQUIRE_EQUAL( c.server_delegate.closed, 1u );
+   BOOST_REQUIRE( c.server_delegate.closed_after_messages );
+   BOOST_REQUIRE( c.server_delegate.received == sequence( 100 ) );
+}
+
+BOOST_AUTO_TEST_CASE( delivery_after_destroy )
+{
+   connection_pair c( 2 );
+
+   BOOST_TEST_MESSAGE( "--- Messages still queued when the connection is destroyed are dropped" );
+   c.server_delegate.handling_time = fc::milliseconds( 200 );
+   c.send( 0, 10 );
+   BOOST_REQUIRE( c.wait_for( [&]() { return c.server_delegate.received.size() == 1; } ) );
+   // the drain task is still inside on_message for the first message
+   c.server.reset();
+   c.client->close_connection();
+   fc::usleep( fc::milliseconds( 500 ) );
+   BOOST_REQUIRE_EQUAL( c.server_delegate.received.size(), 1u );
+   BOOST_REQUIRE_EQUAL( c.server_delegate.closed, 0u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
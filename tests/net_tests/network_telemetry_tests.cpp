@@ -0,0 +1,96 @@
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/net/node.hpp>
+#include <graphene/net/peer_connection.hpp>
+
+#include <fc/thread/thread.hpp>
+
+using namespace graphene::net;
+
+namespace {
+
+/// a node_delegate for a node that never gets to exchange items
+struct idle_node_delegate : public node_delegate
+{
+   virtual sophiatx::protocol::chain_id_type get_chain_id() const override { return sophiatx::protocol::chain_id_type(); }
+   virtual bool has_item( const item_id& ) override { return false; }
+   virtual bool handle_block( const block_message&, bool, std::vector< fc::uint160_t >& ) override { return false; }
+   virtual void handle_transaction( const trx_message& ) override {}
+   virtual void handle_message( const message& ) override {}
+   virtual std::vector< item_hash_t > get_block_ids( const std::vector< item_hash_t >&, uint32_t& remaining_item_count, uint32_t ) override
+   {
+      remaining_item_count = 0;
+      return std::vector< item_hash_t >();
+   }
+   virtual message get_item( const item_id& id ) override { FC_THROW_EXCEPTION( fc::key_not_found_exception, "${id}", ("id", id) ); }
+   virtual std::vector< item_hash_t > get_blockchain_synopsis( const item_hash_t&, uint32_t ) override { return std::vector< item_hash_t >(); }
+   virtual void sync_status( uint32_t, uint32_t ) override {}
+   virtual void connection_count_changed( uint32_t ) override {}
+   virtual uint32_t get_block_number( const item_hash_t& ) override { return 0; }
+   virtual fc::time_point_sec get_block_time( const item_hash_t& ) override { return fc::time_point_sec(); }
+   virtual fc::time_point_sec get_blockchain_now() override { return fc::time_point::now(); }
+   virtual item_hash_t get_head_block_id() const override { return item_hash_t(); }
+   virtual uint32_t estimate_last_known_fork_from_git_revision_timestamp( uint32_t ) const override { return 0; }
+   virtual void error_encountered( const std::string&, const fc::oexception& ) override {}
+};
+
+struct idle_peer_connection_delegate : public peer_connection_delegate
+{
+   virtual void on_message( peer_connection*, const message& ) override {}
+   virtual void on_connection_closed( peer_connection* ) override {}
+   virtual shared_message_ptr get_message_for_item( const item_id& ) override { return nullptr; }
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE( network_telemetry_tests )
+
+BOOST_AUTO_TEST_CASE( telemetry_without_peers )
+{
+   idle_node_delegate delegate;
+   node n( "net_test" );
+   n.set_node_delegate( &delegate );
+
+   network_telemetry telemetry = n.get_network_telemetry();
+   BOOST_REQUIRE( telemetry.peers.empty() );
+
+   BOOST_TEST_MESSAGE( "--- Every delegate method is reported, none has been called yet" );
+   BOOST_REQUIRE( telemetry.delegate_calls.contains( "_histogram_bucket_limits" ) );
+   for( const char* method : { "has_item", "handle_block", "handle_transaction", "get_item" } )
+   {
+      BOOST_REQUIRE( telemetry.delegate_calls.contains( method ) );
+      const fc::variant_object& stats = telemetry.delegate_calls[ method ].get_object();
+      BOOST_REQUIRE_EQUAL( stats[ "count" ].as_uint64(), 0u );
+      for( const fc::variant& bucket : stats[ "histogram" ].get_array() )
+         BOOST_REQUIRE_EQUAL( bucket.as_uint64(), 0u );
+   }
+
+   BOOST_TEST_MESSAGE( "--- The telemetry serializes the way the API returns it" );
+   fc::variant v;
+   fc::to_variant( telemetry, v );
+   BOOST_REQUIRE( v.get_object()[ "peers" ].get_array().empty() );
+}
+
+BOOST_AUTO_TEST_CASE( peer_fetch_latency )
+{
+   idle_peer_connection_delegate delegate;
+   peer_connection_ptr peer = peer_connection::make_shared( &delegate );
+
+   BOOST_REQUIRE_EQUAL( peer->get_queued_message_count(), 0u );
+   BOOST_REQUIRE_EQUAL( peer->get_total_queued_messages_size(), 0u );
+   BOOST_REQUIRE_EQUAL( peer->requested_items_received, 0u );
+
+   BOOST_TEST_MESSAGE( "--- Each item fetched adds its latency to the total and the maximum" );
+   peer->record_item_fetch_latency( fc::time_point::now() - fc::milliseconds( 5 ) );
+   peer->record_item_fetch_latency( fc::time_point::now() - fc::milliseconds( 20 ) );
+   peer->record_item_fetch_latency( fc::time_point::now() - fc::milliseconds( 5 ) );
+   BOOST_REQUIRE_EQUAL( peer->requested_items_received, 3u );
+   BOOST_REQUIRE_GE( peer->max_item_fetch_latency.count(), fc::milliseconds( 20 ).count() );
+   BOOST_REQUIRE_LT( peer->max_item_fetch_latency.count(), fc::milliseconds( 25 ).count() );
+   BOOST_REQUIRE_GE( peer->total_item_fetch_latency.count(), fc::milliseconds( 30 ).count() );
+   BOOST_REQUIRE_LT( peer->total_item_fetch_latency.count(), fc::milliseconds( 45 ).count() );
+
+   peer->destroy();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,122 @@
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/net/config.hpp>
+#include <graphene/net/peer_database.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <boost/filesystem.hpp>
+
+using namespace graphene::net;
+
+namespace {
+
+fc::ip::endpoint peer( uint16_t port )
+{
+   return fc::ip::endpoint( fc::ip::address( "10.0.0.1" ), port );
+}
+
+potential_peer_record record( uint16_t port, uint32_t successful_connections )
+{
+   potential_peer_record result( peer( port ), fc::time_point_sec( 1000 + port ), last_connection_succeeded );
+   result.number_of_successful_connection_attempts = successful_connections;
+   return result;
+}
+
+/// size of one log entry: type, payload size and the packed record
+uint64_t entry_size( const potential_peer_record& r )
+{
+   return sizeof( uint8_t ) + sizeof( uint32_t ) + fc::raw::pack_size( r );
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( peer_database_tests )
+
+BOOST_AUTO_TEST_CASE( log_replay )
+{
+   fc::temp_directory dir( fc::temp_directory_path() );
+   fc::path filename = dir.path() / "peers.dat";
+
+   peer_database written;
+   written.open( filename );
+   for( uint16_t port = 1; port <= 5; ++port )
+      written.update_entry( record( port, 0 ) );
+   written.update_entry( record( 2, 7 ) );
+   written.erase( peer( 3 ) );
+
+   BOOST_TEST_MESSAGE( "--- Every change is in the log before the database is closed" );
+   peer_database replayed;
+   replayed.open( filename );
+   BOOST_REQUIRE_EQUAL( replayed.size(), 4u );
+   BOOST_REQUIRE( !replayed.lookup_entry_for_endpoint( peer( 3 ) ) );
+   BOOST_REQUIRE( replayed.lookup_entry_for_endpoint( peer( 5 ) ) );
+   BOOST_REQUIRE_EQUAL( replayed.lookup_entry_for_endpoint( peer( 2 ) )->number_of_successful_connection_attempts, 7u );
+
+   BOOST_TEST_MESSAGE( "--- A clear entry drops the peers logged before it" );
+   replayed.clear();
+   replayed.update_entry( record( 9, 1 ) );
+   peer_database cleared;
+   cleared.open( filename );
+   BOOST_REQUIRE_EQUAL( cleared.size(), 1u );
+   BOOST_REQUIRE( cleared.lookup_entry_for_endpoint( peer( 9 ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( truncated_tail_recovery )
+{
+   fc::temp_directory dir( fc::temp_directory_path() );
+   fc::path filename = dir.path() / "peers.dat";
+
+   peer_database written;
+   written.open( filename );
+   for( uint16_t port = 1; port <= 3; ++port )
+      written.update_entry( record( port, 0 ) );
+   written.update_entry( record( 4, 0 ) );
+
+   BOOST_TEST_MESSAGE( "--- A partially written last entry is dropped, the entries before it are kept" );
+   uint64_t log_size = fc::file_size( filename );
+   BOOST_REQUIRE_EQUAL( log_size, 2 * sizeof( uint32_t ) + 4 * entry_size( record( 4, 0 ) ) );
+   boost::filesystem::resize_file( boost::filesystem::path( filename.generic_string() ), log_size - 3 );
+
+   peer_database recovered;
+   recovered.open( filename );
+   BOOST_REQUIRE_EQUAL( recovered.size(), 3u );
+   BOOST_REQUIRE( !recovered.lookup_entry_for_endpoint( peer( 4 ) ) );
+
+   BOOST_TEST_MESSAGE( "--- Entries appended after the recovery are not read as part of the truncated one" );
+   recovered.update_entry( record( 5, 0 ) );
+   peer_database reopened;
+   reopened.open( filename );
+   BOOST_REQUIRE_EQUAL( reopened.size(), 4u );
+   BOOST_REQUIRE( reopened.lookup_entry_for_endpoint( peer( 5 ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( log_compaction )
+{
+   fc::temp_directory dir( fc::temp_directory_path() );
+   fc::path filename = dir.path() / "peers.dat";
+
+   peer_database db;
+   db.open( filename );
+   for( uint16_t port = 1; port <= 3; ++port )
+      db.update_entry( record( port, 0 ) );
+
+   BOOST_TEST_MESSAGE( "--- Updating the same peer over and over doesn't grow the log without bound" );
+   const uint32_t updates = 2 * 3 + GRAPHENE_NET_MAX_PEERDB_SIZE + 10;
+   for( uint32_t i = 1; i <= updates; ++i )
+      db.update_entry( record( 1, i ) );
+   BOOST_REQUIRE_EQUAL( db.size(), 3u );
+   BOOST_REQUIRE_LT( fc::file_size( filename ), 2 * sizeof( uint32_t ) + 100 * entry_size( record( 1, updates ) ) );
+
+   peer_database reopened;
+   reopened.open( filename );
+   BOOST_REQUIRE_EQUAL( reopened.size(), 3u );
+   BOOST_REQUIRE_EQUAL( reopened.lookup_entry_for_endpoint( peer( 1 ) )->number_of_successful_connection_attempts, updates );
+
+   BOOST_TEST_MESSAGE( "--- Closing writes one entry per peer" );
+   reopened.close();
+   BOOST_REQUIRE_EQUAL( fc::file_size( filename ), 2 * sizeof( uint32_t ) + entry_size( record( 1, updates ) )
+                                                   + entry_size( record( 2, 0 ) ) + entry_size( record( 3, 0 ) ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
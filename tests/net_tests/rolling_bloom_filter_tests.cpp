@@ -0,0 +1,91 @@
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/net/rolling_bloom_filter.hpp>
+
+#include <string>
+
+using namespace graphene::net;
+
+namespace {
+
+fc::ripemd160 item( uint32_t i )
+{
+   return fc::ripemd160::hash( "item " + std::to_string( i ) );
+}
+
+/// number of items in [first, first + count) the filter reports as present
+uint32_t count_contained( rolling_bloom_filter& filter, uint32_t first, uint32_t count )
+{
+   uint32_t found = 0;
+   for( uint32_t i = first; i < first + count; ++i )
+      if( filter.contains( item( i ) ) )
+         ++found;
+   return found;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( rolling_bloom_filter_tests )
+
+BOOST_AUTO_TEST_CASE( contains_after_insert )
+{
+   rolling_bloom_filter filter( 1000, 0.01 );
+   BOOST_REQUIRE_EQUAL( count_contained( filter, 0, 1000 ), 0u );
+
+   for( uint32_t i = 0; i < 1000; ++i )
+   {
+      filter.insert( item( i ) );
+      BOOST_REQUIRE( filter.contains( item( i ) ) );
+   }
+   BOOST_REQUIRE_EQUAL( count_contained( filter, 0, 1000 ), 1000u );
+   BOOST_REQUIRE_EQUAL( filter.get_statistics().inserts, 1000u );
+   BOOST_REQUIRE_EQUAL( filter.get_statistics().generations_rotated, 0u );
+
+   filter.clear();
+   BOOST_REQUIRE_LT( count_contained( filter, 0, 1000 ), 10u );
+}
+
+BOOST_AUTO_TEST_CASE( false_positive_rate_near_capacity )
+{
+   const uint32_t items_per_generation = 10000;
+   const double   false_positive_rate = 0.01;
+   rolling_bloom_filter filter( items_per_generation, false_positive_rate );
+
+   BOOST_TEST_MESSAGE( "--- Both generations are full, nothing has been forgotten yet" );
+   for( uint32_t i = 0; i < 2 * items_per_generation; ++i )
+      filter.insert( item( i ) );
+   BOOST_REQUIRE_EQUAL( filter.get_statistics().generations_rotated, 1u );
+   BOOST_REQUIRE_EQUAL( count_contained( filter, 0, 2 * items_per_generation ), 2 * items_per_generation );
+
+   const uint32_t lookups = 100000;
+   double rate = double( count_contained( filter, 1000000, lookups ) ) / lookups;
+   BOOST_TEST_MESSAGE( "false positive rate " << rate );
+   BOOST_REQUIRE_LT( rate, 2 * false_positive_rate );
+   // the filter is not simply oversized
+   BOOST_REQUIRE_GT( rate, false_positive_rate / 5 );
+}
+
+BOOST_AUTO_TEST_CASE( generation_rollover )
+{
+   const uint32_t items_per_generation = 100;
+   rolling_bloom_filter filter( items_per_generation, 0.001 );
+
+   for( uint32_t i = 0; i < 2 * items_per_generation; ++i )
+      filter.insert( item( i ) );
+
+   BOOST_TEST_MESSAGE( "--- Starting a third generation wipes the oldest one" );
+   for( uint32_t i = 2 * items_per_generation; i < 3 * items_per_generation; ++i )
+      filter.insert( item( i ) );
+   BOOST_REQUIRE_EQUAL( filter.get_statistics().generations_rotated, 2u );
+   BOOST_REQUIRE_LT( count_contained( filter, 0, items_per_generation ), 5u );
+   BOOST_REQUIRE_EQUAL( count_contained( filter, items_per_generation, 2 * items_per_generation ), 2 * items_per_generation );
+
+   BOOST_TEST_MESSAGE( "--- The last items_per_generation inserts are always remembered" );
+   for( uint32_t i = 3 * items_per_generation; i < 3 * items_per_generation + 10; ++i )
+      filter.insert( item( i ) );
+   BOOST_REQUIRE_EQUAL( filter.get_statistics().generations_rotated, 3u );
+   BOOST_REQUIRE_EQUAL( count_contained( filter, 2 * items_per_generation + 10, items_per_generation ), items_per_generation );
+   BOOST_REQUIRE_LT( count_contained( filter, items_per_generation, items_per_generation ), 5u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
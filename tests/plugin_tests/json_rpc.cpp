@@ -4,6 +4,7 @@
 #include <sophiatx/chain/account_object.hpp>
 #include <sophiatx/protocol/sophiatx_operations.hpp>
 #include <sophiatx/plugins/json_rpc/json_rpc_plugin.hpp>
+#include <sophiatx/plugins/block_api/block_api_args.hpp>
 
 #include "../db_fixture/database_fixture.hpp"
 
@@ -311,5 +312,85 @@ BOOST_AUTO_TEST_CASE( semantics_validation )
    FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE( method_timing )
+{
+   try
+   {
+      auto& rpc = appbase::app().get_plugin< sophiatx::plugins::json_rpc::json_rpc_plugin >();
+      std::string request = "{\"jsonrpc\":\"2.0\", \"method\":\"call\", \"params\":[\"database_api\", \"get_dynamic_global_properties\"], \"id\":30 }";
+
+      make_positive_request( request );
+      BOOST_REQUIRE( rpc.get_method_timing().empty() );
+
+      rpc.set_method_timing( true );
+      make_positive_request( request );
+      request = "{\"jsonrpc\":\"2.0\", \"method\":\"database_api.get_dynamic_global_properties\", \"params\":{}, \"id\":31 }";
+      make_positive_request( request );
+
+      auto timing = rpc.get_method_timing( true );
+      BOOST_REQUIRE_EQUAL( timing.size(), 1u );
+      BOOST_REQUIRE_EQUAL( timing[ "database_api.get_dynamic_global_properties" ].count, 2u );
+      BOOST_REQUIRE( timing[ "database_api.get_dynamic_global_properties" ].max_us <= timing[ "database_api.get_dynamic_global_properties" ].total_us );
+      BOOST_REQUIRE( rpc.get_method_timing().empty() );
+
+      rpc.set_method_timing( false );
+      make_positive_request( request );
+      BOOST_REQUIRE( rpc.get_method_timing().empty() );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( binary_validation )
+{
+   try
+   {
+      using namespace sophiatx::plugins::json_rpc;
+      auto& rpc = appbase::app().get_plugin< json_rpc_plugin >();
+      auto call = [&rpc]( const std::vector< char >& request )
+      {
+         return fc::raw::unpack_from_vector< binary_rpc_response >( rpc.call_binary( request ) );
+      };
+
+      generate_block();
+
+      binary_rpc_request request;
+      request.id = 7;
+      request.api = "block_api";
+      request.method = "get_block";
+      request.args = fc::raw::pack_to_vector( sophiatx::plugins::block_api::get_block_args{ db->head_block_num() } );
+
+      auto response = call( fc::raw::pack_to_vector( request ) );
+      BOOST_REQUIRE( !response.error );
+      BOOST_REQUIRE_EQUAL( response.id, 7u );
+      auto r = fc::raw::unpack_from_vector< sophiatx::plugins::block_api::get_block_return >( response.result );
+      BOOST_REQUIRE( r.block );
+      BOOST_REQUIRE( r.block->block_id == db->head_block_id() );
+
+      request.method = "get_nothing";
+      response = call( fc::raw::pack_to_vector( request ) );
+      BOOST_REQUIRE( response.error );
+      BOOST_REQUIRE_EQUAL( response.id, 7u );
+      BOOST_REQUIRE_EQUAL( response.error->code, JSON_RPC_METHOD_NOT_FOUND );
+
+      BOOST_TEST_MESSAGE( "--- Methods off the binary allow-list are JSON only" );
+      request.method = "get_block_header";
+      request.args = fc::raw::pack_to_vector( sophiatx::plugins::block_api::get_block_header_args{ db->head_block_num() } );
+      response = call( fc::raw::pack_to_vector( request ) );
+      BOOST_REQUIRE( response.error );
+      BOOST_REQUIRE_EQUAL( response.error->code, JSON_RPC_METHOD_NOT_FOUND );
+
+      request.method = "get_block";
+      request.args.clear();
+      response = call( fc::raw::pack_to_vector( request ) );
+      BOOST_REQUIRE( response.error );
+      BOOST_REQUIRE_EQUAL( response.error->code, JSON_RPC_ERROR_DURING_CALL );
+
+      response = call( std::vector< char >{ 1 } );
+      BOOST_REQUIRE( response.error );
+      BOOST_REQUIRE_EQUAL( response.error->code, JSON_RPC_PARSE_ERROR );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 #endif
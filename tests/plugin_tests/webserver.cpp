@@ -0,0 +1,80 @@
+#include <boost/test/unit_test.hpp>
+
+#include <sophiatx/plugins/webserver/content_encoding.hpp>
+
+#include <fc/exception/exception.hpp>
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <sstream>
+
+using namespace sophiatx::plugins::webserver;
+
+namespace {
+
+template< typename Decompressor >
+std::string decompress( const std::string& data )
+{
+   std::stringstream in( data );
+   std::stringstream out;
+   boost::iostreams::filtering_streambuf< boost::iostreams::input > filter;
+   filter.push( Decompressor() );
+   filter.push( in );
+   boost::iostreams::copy( filter, out );
+   return out.str();
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE( webserver )
+
+BOOST_AUTO_TEST_CASE( accepted_encoding_test )
+{
+   try
+   {
+      BOOST_REQUIRE( accepted_encoding( "" ) == content_encoding::identity );
+      BOOST_REQUIRE( accepted_encoding( "identity" ) == content_encoding::identity );
+      BOOST_REQUIRE( accepted_encoding( "gzip" ) == content_encoding::gzip );
+      BOOST_REQUIRE( accepted_encoding( "x-gzip" ) == content_encoding::gzip );
+      BOOST_REQUIRE( accepted_encoding( "deflate" ) == content_encoding::deflate );
+      BOOST_REQUIRE( accepted_encoding( "deflate, GZip;q=0.5" ) == content_encoding::gzip );
+
+      BOOST_TEST_MESSAGE( "--- Codings with a zero q-value are refused" );
+      BOOST_REQUIRE( accepted_encoding( "gzip;q=0, deflate" ) == content_encoding::deflate );
+      BOOST_REQUIRE( accepted_encoding( "gzip; q=0.000, deflate;q=0" ) == content_encoding::identity );
+      BOOST_REQUIRE( accepted_encoding( "gzip;q=0.01" ) == content_encoding::gzip );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( compress_body_test )
+{
+   try
+   {
+      std::string body;
+      for( int i = 0; i < 2000; ++i )
+         body += "{\"block_num\":" + std::to_string( i ) + ",\"witness\":\"initminer\"},";
+
+      BOOST_TEST_MESSAGE( "--- gzip output inflates with a standard gzip decompressor" );
+      auto gzip = compress_body( body, content_encoding::gzip );
+      BOOST_REQUIRE( gzip );
+      BOOST_REQUIRE_LT( gzip->size(), body.size() );
+      BOOST_REQUIRE( decompress< boost::iostreams::gzip_decompressor >( *gzip ) == body );
+
+      BOOST_TEST_MESSAGE( "--- deflate output inflates with a standard zlib decompressor" );
+      auto deflate = compress_body( body, content_encoding::deflate );
+      BOOST_REQUIRE( deflate );
+      BOOST_REQUIRE( decompress< boost::iostreams::zlib_decompressor >( *deflate ) == body );
+
+      BOOST_TEST_MESSAGE( "--- An empty body makes a valid gzip member" );
+      auto empty = compress_body( std::string(), content_encoding::gzip );
+      BOOST_REQUIRE( empty );
+      BOOST_REQUIRE( decompress< boost::iostreams::gzip_decompressor >( *empty ).empty() );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
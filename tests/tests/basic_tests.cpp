@@ -24,17 +24,26 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <sophiatx/chain/authority_checker.hpp>
 #include <sophiatx/chain/database.hpp>
+#include <sophiatx/chain/transaction_prevalidator.hpp>
 #include <sophiatx/protocol/protocol.hpp>
 
+#include <sophiatx/protocol/signature_cache.hpp>
 #include <sophiatx/protocol/sophiatx_operations.hpp>
 
+#include <sophiatx/utilities/batch_thread_pool.hpp>
+#include <sophiatx/utilities/memo_nonce.hpp>
+#include <sophiatx/utilities/shared_secret_cache.hpp>
+
 #include <fc/crypto/digest.hpp>
 #include <fc/crypto/hex.hpp>
 #include "../db_fixture/database_fixture.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <random>
+#include <thread>
 
 using namespace sophiatx;
 using namespace sophiatx::chain;
@@ -324,4 +333,299 @@ BOOST_AUTO_TEST_CASE( merkle_root )
    BOOST_CHECK( block.calculate_merkle_root() == c(dO) );
 }
 
+BOOST_AUTO_TEST_CASE( authority_checker_matches_verify_authority )
+{
+   try
+   {
+      ACTORS( (alice)(bob)(charlie) )
+
+      BOOST_TEST_MESSAGE( "Setting alice's active authority to 2 of her key, bob and charlie" );
+      db->modify( db->get< account_authority_object, by_account >( AN("alice") ), [&]( account_authority_object& a )
+      {
+         a.active = authority( 2, alice_public_key, 1, AN("bob"), 1, AN("charlie"), 1 );
+      });
+
+      transfer_operation op;
+      op.from = AN("alice");
+      op.to = AN("bob");
+      op.fee = ASSET( "0.100000 SPHTX" );
+      op.amount = ASSET( "1.000000 SPHTX" );
+
+      signed_transaction tx;
+      tx.set_expiration( db->head_block_time() + SOPHIATX_MAX_TIME_UNTIL_EXPIRATION );
+      tx.operations.push_back( op );
+
+      auto get_active = [&]( const string& name ) { return authority( db->get< account_authority_object, by_account >( name ).active ); };
+      auto get_owner  = [&]( const string& name ) { return authority( db->get< account_authority_object, by_account >( name ).owner ); };
+
+      // 0 if the authority is satisfied, otherwise the code of the exception thrown
+      auto protocol_result = [&]() -> int64_t
+      {
+         try { tx.verify_authority( db->get_chain_id(), get_active, get_owner ); }
+         catch( const fc::exception& e ) { return e.code(); }
+         return 0;
+      };
+      auto checker_result = [&]() -> int64_t
+      {
+         try
+         {
+            const auto keys = tx.get_signature_keys( db->get_chain_id() );
+            authority_checker( *db, keys ).verify( tx );
+         }
+         catch( const fc::exception& e ) { return e.code(); }
+         return 0;
+      };
+
+      std::vector< std::vector< fc::ecc::private_key > > signer_sets =
+      {
+         {},
+         { alice_private_key },
+         { alice_private_key, bob_private_key },
+         { bob_private_key, charlie_private_key },
+         { alice_private_key, bob_private_key, charlie_private_key },
+         { charlie_private_key }
+      };
+
+      for( const auto& signers : signer_sets )
+      {
+         tx.signatures.clear();
+         for( const auto& key : signers )
+            tx.sign( key, db->get_chain_id() );
+         BOOST_REQUIRE_EQUAL( checker_result(), protocol_result() );
+      }
+
+      tx.signatures.clear();
+      tx.sign( bob_private_key, db->get_chain_id() );
+      tx.sign( charlie_private_key, db->get_chain_id() );
+      BOOST_REQUIRE_EQUAL( checker_result(), 0 );
+
+      tx.sign( alice_private_key, db->get_chain_id() );
+      BOOST_REQUIRE_EQUAL( checker_result(), int64_t( tx_irrelevant_sig::code_value ) );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( recovered_signature_cache_test )
+{
+   try
+   {
+      auto& cache = recovered_signature_cache::instance();
+      const uint32_t original_capacity = cache.get_statistics().capacity;
+      cache.set_capacity( 2 );
+      cache.clear();
+
+      std::vector< fc::ecc::private_key > keys;
+      std::vector< signed_transaction > txs( 3 );
+      for( size_t i = 0; i < txs.size(); ++i )
+      {
+         keys.push_back( fc::ecc::private_key::regenerate( fc::sha256::hash( std::to_string( i ) ) ) );
+         txs[i].set_expiration( db->head_block_time() + uint32_t( i + 1 ) );
+         txs[i].sign( keys[i], db->get_chain_id() );
+      }
+
+      BOOST_TEST_MESSAGE( "--- Recovering a signature twice hits the cache" );
+      BOOST_REQUIRE( txs[0].get_signature_keys( db->get_chain_id() ) == flat_set< public_key_type >{ keys[0].get_public_key() } );
+      BOOST_REQUIRE( txs[0].get_signature_keys( db->get_chain_id() ) == flat_set< public_key_type >{ keys[0].get_public_key() } );
+      auto stats = cache.get_statistics();
+      BOOST_REQUIRE_EQUAL( stats.misses, 1u );
+      BOOST_REQUIRE_EQUAL( stats.hits, 1u );
+
+      BOOST_TEST_MESSAGE( "--- The least recently used entry is evicted" );
+      txs[1].get_signature_keys( db->get_chain_id() );
+      txs[0].get_signature_keys( db->get_chain_id() );
+      txs[2].get_signature_keys( db->get_chain_id() );
+      stats = cache.get_statistics();
+      BOOST_REQUIRE_EQUAL( stats.size, 2u );
+      BOOST_REQUIRE_EQUAL( stats.evictions, 1u );
+      BOOST_REQUIRE_EQUAL( stats.hits, 2u );
+
+      txs[1].get_signature_keys( db->get_chain_id() );
+      BOOST_REQUIRE_EQUAL( cache.get_statistics().misses, 4u );
+
+      BOOST_TEST_MESSAGE( "--- A different chain id is a different digest" );
+      BOOST_REQUIRE( txs[0].get_signature_keys( chain_id_type() ) != flat_set< public_key_type >{ keys[0].get_public_key() } );
+
+      BOOST_TEST_MESSAGE( "--- A disabled cache recovers without storing anything" );
+      cache.set_capacity( 0 );
+      cache.clear();
+      BOOST_REQUIRE( txs[0].get_signature_keys( db->get_chain_id() ) == flat_set< public_key_type >{ keys[0].get_public_key() } );
+      stats = cache.get_statistics();
+      BOOST_REQUIRE_EQUAL( stats.size, 0u );
+      BOOST_REQUIRE_EQUAL( stats.misses, 0u );
+
+      cache.set_capacity( original_capacity );
+      cache.clear();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( transaction_prevalidator_test )
+{
+   try
+   {
+      std::vector< fc::ecc::private_key > keys;
+      std::vector< signed_transaction > txs( 5 );
+      for( size_t i = 0; i < txs.size(); ++i )
+      {
+         transfer_operation op;
+         op.from = AN("alice");
+         op.to = AN("bob");
+         op.fee = ASSET( "0.100000 SPHTX" );
+         op.amount = asset( i + 1, SOPHIATX_SYMBOL );
+
+         keys.push_back( fc::ecc::private_key::regenerate( fc::sha256::hash( std::to_string( i ) ) ) );
+         txs[i].set_expiration( db->head_block_time() + SOPHIATX_MAX_TIME_UNTIL_EXPIRATION );
+         txs[i].operations.push_back( op );
+         txs[i].sign( keys[i], db->get_chain_id() );
+      }
+      // fails validate(), which has to be left to the applying thread
+      txs[3].operations.front().get< transfer_operation >().amount = asset( -1, SOPHIATX_SYMBOL );
+
+      transaction_prevalidator prevalidator( 3 );
+      auto result = prevalidator.prevalidate( txs, db->get_chain_id(), true, true );
+      BOOST_REQUIRE_EQUAL( result.size(), txs.size() );
+      for( size_t i = 0; i < txs.size(); ++i )
+      {
+         BOOST_REQUIRE( result[i].id_computed );
+         BOOST_REQUIRE( result[i].id == txs[i].id() );
+         if( i == 3 )
+         {
+            BOOST_REQUIRE( !result[i].validated );
+            BOOST_REQUIRE( !result[i].signatures_recovered );
+            continue;
+         }
+         BOOST_REQUIRE( result[i].validated );
+         BOOST_REQUIRE( result[i].signatures_recovered );
+         BOOST_REQUIRE( result[i].signature_keys == flat_set< public_key_type >{ keys[i].get_public_key() } );
+      }
+
+      BOOST_TEST_MESSAGE( "--- Skipped steps are not flagged" );
+      result = prevalidator.prevalidate( txs, db->get_chain_id(), false, false );
+      BOOST_REQUIRE( !result[0].validated && !result[0].signatures_recovered );
+
+      BOOST_TEST_MESSAGE( "--- A disabled prevalidator does nothing" );
+      prevalidator.resize( 0 );
+      result = prevalidator.prevalidate( txs, db->get_chain_id(), true, true );
+      BOOST_REQUIRE( !result[0].id_computed && !result[0].validated );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( batch_thread_pool_test )
+{
+   try
+   {
+      sophiatx::utilities::batch_thread_pool pool( 4 );
+
+      BOOST_TEST_MESSAGE( "--- Every item is processed once and results keep the batch order" );
+      std::vector< std::atomic< uint32_t > > calls( 100 );
+      std::vector< uint64_t > squares( calls.size() );
+      pool.run( calls.size(), [&]( size_t i )
+      {
+         ++calls[i];
+         squares[i] = uint64_t( i ) * i;
+      });
+      for( size_t i = 0; i < calls.size(); ++i )
+      {
+         BOOST_REQUIRE_EQUAL( calls[i].load(), 1u );
+         BOOST_REQUIRE_EQUAL( squares[i], uint64_t( i ) * i );
+      }
+
+      BOOST_TEST_MESSAGE( "--- An exception is passed on after the batch finished" );
+      std::atomic< uint32_t > processed( 0 );
+      SOPHIATX_REQUIRE_THROW( pool.run( 20, [&]( size_t i )
+      {
+         ++processed;
+         FC_ASSERT( i != 3 );
+      }), fc::exception );
+      BOOST_REQUIRE_EQUAL( processed.load(), 20u );
+
+      BOOST_TEST_MESSAGE( "--- Without threads the items are processed on the calling thread" );
+      sophiatx::utilities::batch_thread_pool inline_pool( 0 );
+      const auto caller = std::this_thread::get_id();
+      bool on_caller = true;
+      inline_pool.run( 5, [&]( size_t ) { on_caller = on_caller && std::this_thread::get_id() == caller; } );
+      BOOST_REQUIRE( on_caller );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( memo_nonce_reservation )
+{
+   try
+   {
+      using sophiatx::utilities::reserve_memo_nonces;
+
+      int64_t first = reserve_memo_nonces( 5 );
+      BOOST_REQUIRE_GE( reserve_memo_nonces( 1 ), first + 5 );
+
+      BOOST_TEST_MESSAGE( "--- Ranges reserved from several threads at once never overlap" );
+      sophiatx::utilities::batch_thread_pool pool( 4 );
+      std::vector< int64_t > firsts( 1000 );
+      pool.run( firsts.size(), [&]( size_t i ) { firsts[i] = reserve_memo_nonces( 3 ); } );
+      std::sort( firsts.begin(), firsts.end() );
+      for( size_t i = 1; i < firsts.size(); ++i )
+         BOOST_REQUIRE_GE( firsts[i], firsts[i - 1] + 3 );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( shared_secret_cache_test )
+{
+   try
+   {
+      using sophiatx::utilities::shared_secret_cache;
+
+      auto alice = fc::ecc::private_key::regenerate( fc::sha256::hash( std::string( "alice" ) ) );
+      auto bob = fc::ecc::private_key::regenerate( fc::sha256::hash( std::string( "bob" ) ) );
+      auto carol = fc::ecc::private_key::regenerate( fc::sha256::hash( std::string( "carol" ) ) );
+      auto dave = fc::ecc::private_key::regenerate( fc::sha256::hash( std::string( "dave" ) ) );
+
+      auto id_of = [&]( const fc::ecc::private_key& priv, const fc::ecc::private_key& pub ) {
+         auto secret = priv.get_secret();
+         return shared_secret_cache::pair_id( secret.data(), secret.data_size(), pub.get_public_key().serialize() );
+      };
+
+      shared_secret_cache cache( 2 );
+      int derived = 0;
+      auto get = [&]( const fc::ecc::private_key& priv, const fc::ecc::private_key& pub ) {
+         return cache.get( id_of( priv, pub ), [&]() {
+            ++derived;
+            return priv.get_shared_secret( pub.get_public_key() );
+         } );
+      };
+
+      BOOST_TEST_MESSAGE( "--- A miss derives the secret" );
+      BOOST_REQUIRE( get( alice, bob ) == alice.get_shared_secret( bob.get_public_key() ) );
+      BOOST_REQUIRE_EQUAL( derived, 1 );
+      BOOST_REQUIRE_EQUAL( cache.size(), 1u );
+
+      BOOST_TEST_MESSAGE( "--- A hit returns the same secret without deriving it" );
+      BOOST_REQUIRE( get( alice, bob ) == alice.get_shared_secret( bob.get_public_key() ) );
+      BOOST_REQUIRE_EQUAL( derived, 1 );
+
+      BOOST_TEST_MESSAGE( "--- Both sides of a pair derive the same secret" );
+      BOOST_REQUIRE( get( bob, alice ) == alice.get_shared_secret( bob.get_public_key() ) );
+      BOOST_REQUIRE_EQUAL( derived, 2 );
+      BOOST_REQUIRE_EQUAL( cache.size(), 2u );
+
+      BOOST_TEST_MESSAGE( "--- The least recently used pair is dropped at capacity" );
+      get( alice, bob );
+      BOOST_REQUIRE( get( carol, dave ) == carol.get_shared_secret( dave.get_public_key() ) );
+      BOOST_REQUIRE_EQUAL( derived, 3 );
+      BOOST_REQUIRE_EQUAL( cache.size(), 2u );
+      get( alice, bob );
+      BOOST_REQUIRE_EQUAL( derived, 3 );
+      get( bob, alice );
+      BOOST_REQUIRE_EQUAL( derived, 4 );
+
+      BOOST_TEST_MESSAGE( "--- A failing derivation caches nothing" );
+      cache.clear();
+      BOOST_REQUIRE_EQUAL( cache.size(), 0u );
+      SOPHIATX_REQUIRE_THROW( cache.get( id_of( alice, dave ), []() -> fc::sha512 { FC_ASSERT( false ); } ), fc::exception );
+      BOOST_REQUIRE_EQUAL( cache.size(), 0u );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_SUITE_END()
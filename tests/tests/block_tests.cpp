@@ -29,12 +29,17 @@
 #include <sophiatx/chain/database.hpp>
 #include <sophiatx/chain/sophiatx_objects.hpp>
 #include <sophiatx/chain/history_object.hpp>
+#include <sophiatx/chain/replay_report.hpp>
+#include <sophiatx/chain/transaction_object.hpp>
 
 #include <sophiatx/plugins/account_history/account_history_plugin.hpp>
 
 #include <sophiatx/utilities/tempdir.hpp>
 
 #include <fc/crypto/digest.hpp>
+#include <fc/io/json.hpp>
+
+#include <fstream>
 
 #include "../db_fixture/database_fixture.hpp"
 
@@ -128,6 +133,51 @@ BOOST_AUTO_TEST_CASE( generate_empty_blocks )
    }
 }
 
+BOOST_AUTO_TEST_CASE( replay_report )
+{
+   try {
+      fc::temp_directory data_dir( sophiatx::utilities::temp_directory_path() );
+      fc::ecc::private_key init_account_priv_key = *(sophiatx::utilities::wif_to_key("5JPwY3bwFgfsGtxMeLkLqXzUrQDMAsqSyAZDnMBkg7PDDRhQgaV"));
+      {
+         database db;
+         db._log_hardforks = false;
+         open_test_database( db, data_dir.path() );
+         for( uint32_t i = 0; i < 60; ++i )
+            db.generate_block( db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing );
+         db.close();
+      }
+
+      database db;
+      db._log_hardforks = false;
+      genesis_state_type gen;
+      gen.genesis_time = fc::time_point_sec(1530644400);
+      database::open_args args;
+      args.data_dir = data_dir.path();
+      args.shared_mem_dir = data_dir.path();
+      args.shared_file_size = TEST_SHARED_MEM_SIZE;
+      args.replay_report = data_dir.path() / "replay_report.json";
+      args.replay_report_interval = 10;
+      uint32_t last_block = db.reindex( args, gen );
+      BOOST_REQUIRE_GE( last_block, 20u );
+      BOOST_REQUIRE( !db.get_block_profile().enabled );
+
+      std::ifstream report( args.replay_report.string() );
+      std::vector< replay_report_line > lines;
+      for( std::string line; std::getline( report, line ); )
+         lines.push_back( fc::json::from_string( line ).as< replay_report_line >() );
+
+      BOOST_REQUIRE_EQUAL( lines.size(), ( last_block + 9 ) / 10 );
+      BOOST_REQUIRE_EQUAL( lines[0].block_num, 10u );
+      BOOST_REQUIRE_EQUAL( lines[0].blocks, 10u );
+      BOOST_REQUIRE_EQUAL( lines.back().block_num, last_block );
+      BOOST_REQUIRE( !lines.back().indices.empty() );
+      for( const auto& index : lines[0].indices )
+         BOOST_REQUIRE_EQUAL( index.growth, int64_t( index.bytes ) );
+      db.close();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_CASE( undo_block )
 {
    try {
@@ -361,6 +411,87 @@ BOOST_AUTO_TEST_CASE( duplicate_transactions )
    }
 }
 
+BOOST_AUTO_TEST_CASE( state_digest_tracks_blocks )
+{
+   try {
+      fc::temp_directory dir1( sophiatx::utilities::temp_directory_path() ),
+                         dir2( sophiatx::utilities::temp_directory_path() );
+      database db1,
+               db2;
+      db1._log_hardforks = false;
+      db1.set_state_digest_history( 5 );
+      open_test_database( db1, dir1.path() );
+      db2._log_hardforks = false;
+      db2.set_state_digest_history( 5 );
+      open_test_database( db2, dir2.path() );
+
+      fc::ecc::private_key init_account_priv_key = *(sophiatx::utilities::wif_to_key("5JPwY3bwFgfsGtxMeLkLqXzUrQDMAsqSyAZDnMBkg7PDDRhQgaV"));
+      public_key_type init_account_pub_key  = init_account_priv_key.get_public_key();
+
+      BOOST_TEST_MESSAGE( "--- Nodes applying the same blocks have the same digest" );
+      signed_transaction trx;
+      account_create_operation cop;
+      cop.name_seed = "alice";
+      cop.creator = SOPHIATX_INIT_MINER_NAME;
+      cop.owner = authority(1, init_account_pub_key, 1);
+      cop.active = cop.owner;
+      cop.fee = asset(50000, SOPHIATX_SYMBOL);
+      trx.operations.push_back(cop);
+      trx.set_expiration( db1.head_block_time() + SOPHIATX_MAX_TIME_UNTIL_EXPIRATION );
+      trx.sign( init_account_priv_key, db1.get_chain_id() );
+      PUSH_TX( db1, trx );
+
+      for( uint32_t i = 0; i < 8; ++i )
+      {
+         auto b = db1.generate_block( db1.get_slot_time(1), db1.get_scheduled_witness(1), init_account_priv_key, database::skip_nothing );
+         PUSH_BLOCK( db2, b );
+
+         auto d1 = db1.find_state_digest( b.block_num() );
+         auto d2 = db2.find_state_digest( b.block_num() );
+         BOOST_REQUIRE( d1.valid() && d2.valid() );
+         BOOST_REQUIRE( d1->block_id == b.id() );
+         BOOST_REQUIRE( d1->digest == d2->digest );
+         BOOST_REQUIRE( d1->digest == db1.compute_state_digest().digest );
+      }
+
+      BOOST_TEST_MESSAGE( "--- Only the last blocks are kept" );
+      uint32_t head = db1.head_block_num();
+      BOOST_REQUIRE( !db1.find_state_digest( head - 5 ).valid() );
+      BOOST_REQUIRE( db1.find_state_digest( head - 4 ).valid() );
+      BOOST_REQUIRE( db1.find_state_digest( head - 1 )->digest != db1.find_state_digest( head )->digest );
+
+      BOOST_TEST_MESSAGE( "--- Popping a block restores the digest of the previous block" );
+      auto previous = *db1.find_state_digest( head - 1 );
+      db1.pop_block();
+      BOOST_REQUIRE( !db1.find_state_digest( head ).valid() );
+      BOOST_REQUIRE( db1.compute_state_digest().digest == previous.digest );
+
+      BOOST_TEST_MESSAGE( "--- A diverging state changes the digest of its index only" );
+      auto before = db2.compute_state_digest();
+      db2.modify( db2.get_account( AN("alice") ), [&]( account_object& a ) { a.balance.amount += 1; } );
+      auto after = db2.compute_state_digest();
+      BOOST_REQUIRE( before.digest != after.digest );
+      BOOST_REQUIRE_EQUAL( before.indices.size(), after.indices.size() );
+      for( size_t i = 0; i < before.indices.size(); ++i )
+         BOOST_REQUIRE_EQUAL( before.indices[i].digest == after.indices[i].digest, before.indices[i].type_id != account_object_type );
+
+      BOOST_TEST_MESSAGE( "--- The maintained digest matches a full recomputation" );
+      db1.commit( db1.revision() );
+      auto incremental = db1.compute_state_digest();
+      for( const auto* idx : db1.get_abstract_index_cntr() )
+      {
+         if( !idx->digest_enabled() )
+            continue;
+         idx->set_digest_enabled( false );
+         idx->set_digest_enabled( true );
+      }
+      BOOST_REQUIRE( incremental.digest == db1.compute_state_digest().digest );
+   } catch (fc::exception& e) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( tapos )
 {
    try {
@@ -731,6 +862,277 @@ BOOST_FIXTURE_TEST_CASE( skip_block, clean_database_fixture )
    FC_LOG_AND_RETHROW();
 }
 
+BOOST_FIXTURE_TEST_CASE( generate_block_reuses_pending_state, clean_database_fixture )
+{
+   try
+   {
+      ACTORS( (alice)(bob) )
+      fund( AN("alice"), 1000000000 );
+
+      uint32_t applied = 0;
+      boost::signals2::scoped_connection counter = db->on_pre_apply_transaction.connect(
+         [&]( const signed_transaction& ) { ++applied; } );
+
+      auto make_transfer = [&]( uint32_t amount, uint32_t seconds_until_expiration )
+      {
+         transfer_operation op;
+         op.from = AN("alice");
+         op.to = AN("bob");
+         op.fee = ASSET( "0.100000 SPHTX" );
+         op.amount = asset( amount, SOPHIATX_SYMBOL );
+
+         signed_transaction tx;
+         tx.set_expiration( db->head_block_time() + seconds_until_expiration );
+         tx.operations.push_back( op );
+         tx.sign( alice_private_key, db->get_chain_id() );
+         return tx;
+      };
+
+      auto push_transfers = [&]( uint32_t count, uint32_t seconds_until_expiration )
+      {
+         for( uint32_t i = 0; i < count; ++i )
+            db->push_transaction( make_transfer( i + 1, seconds_until_expiration ), 0 );
+      };
+
+      BOOST_TEST_MESSAGE( "--- Pending transactions are not re-applied while generating a block" );
+      push_transfers( 20, SOPHIATX_MAX_TIME_UNTIL_EXPIRATION );
+      applied = 0;
+      generate_block();
+      BOOST_REQUIRE_EQUAL( db->fetch_block_by_number( db->head_block_num() )->transactions.size(), 20u );
+      BOOST_REQUIRE_EQUAL( applied, 20u );
+      BOOST_REQUIRE( db->_pending_tx.empty() );
+
+      BOOST_TEST_MESSAGE( "--- An expired pending transaction falls back to re-applying them" );
+      push_transfers( 1, 1 );
+      push_transfers( 5, SOPHIATX_MAX_TIME_UNTIL_EXPIRATION );
+      generate_block();
+      BOOST_REQUIRE_EQUAL( db->fetch_block_by_number( db->head_block_num() )->transactions.size(), 5u );
+
+      BOOST_TEST_MESSAGE( "--- A pool larger than a block is taken in arrival order without re-applying it" );
+      const uint32_t block_size = 20 * fc::raw::pack_size( make_transfer( 1, SOPHIATX_MAX_TIME_UNTIL_EXPIRATION ) );
+      db->modify( db->get_dynamic_global_properties(), [&]( dynamic_global_property_object& gpo )
+      {
+         gpo.maximum_block_size = block_size;
+      });
+      push_transfers( 30, SOPHIATX_MAX_TIME_UNTIL_EXPIRATION );
+      const auto first_id = db->get_pending_transactions().get< pending_transaction_pool::by_sequence >().begin()->id;
+      applied = 0;
+      generate_block();
+      const auto block = db->fetch_block_by_number( db->head_block_num() );
+      BOOST_REQUIRE_GT( block->transactions.size(), 0u );
+      BOOST_REQUIRE_LT( block->transactions.size(), 20u );
+      BOOST_REQUIRE( block->transactions.front().id() == first_id );
+      // the block applies its transactions once, the rest of the pool is restored on top of it once
+      BOOST_REQUIRE_EQUAL( applied, 30u );
+      BOOST_REQUIRE_EQUAL( db->get_pending_transactions().size(), 30u - block->transactions.size() );
+
+      validate_database();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( pending_transaction_pool_limits, clean_database_fixture )
+{
+   try
+   {
+      ACTORS( (alice)(bob) )
+      fund( AN("alice"), 10000000 );
+      fund( AN("bob"), 10000000 );
+
+      db->set_pending_transaction_limits( 3, 2 );
+
+      auto make_transfer = [&]( const string& from, const string& to, const fc::ecc::private_key& key, const char* fee )
+      {
+         transfer_operation op;
+         op.from = AN(from);
+         op.to = AN(to);
+         op.fee = ASSET( fee );
+         op.amount = ASSET( "1.000000 SPHTX" );
+
+         signed_transaction tx;
+         tx.set_expiration( db->head_block_time() + SOPHIATX_MAX_TIME_UNTIL_EXPIRATION );
+         tx.operations.push_back( op );
+         tx.sign( key, db->get_chain_id() );
+         return tx;
+      };
+
+      const asset alice_balance = db->get_account( AN("alice") ).balance;
+
+      BOOST_TEST_MESSAGE( "--- Per account limit" );
+      auto alice_low = make_transfer( "alice", "bob", alice_private_key, "0.100000 SPHTX" );
+      auto alice_mid = make_transfer( "alice", "bob", alice_private_key, "0.200000 SPHTX" );
+      db->push_transaction( alice_low, 0 );
+      db->push_transaction( alice_mid, 0 );
+      SOPHIATX_REQUIRE_THROW( db->push_transaction( make_transfer( "alice", "bob", alice_private_key, "0.300000 SPHTX" ), 0 ), fc::exception );
+
+      BOOST_TEST_MESSAGE( "--- A full pool only admits better paying transactions" );
+      auto bob_mid = make_transfer( "bob", "alice", bob_private_key, "0.300000 SPHTX" );
+      db->push_transaction( bob_mid, 0 );
+      SOPHIATX_REQUIRE_THROW( db->push_transaction( make_transfer( "bob", "alice", bob_private_key, "0.050000 SPHTX" ), 0 ), fc::exception );
+
+      auto bob_high = make_transfer( "bob", "alice", bob_private_key, "0.500000 SPHTX" );
+      db->push_transaction( bob_high, 0 );
+
+      const auto& pool = db->get_pending_transactions();
+      BOOST_REQUIRE_EQUAL( pool.size(), 3u );
+      BOOST_REQUIRE( pool.find( alice_low.id() ) == nullptr );
+      BOOST_REQUIRE( pool.find( bob_high.id() ) != nullptr );
+      BOOST_REQUIRE_EQUAL( pool.count_for_fee_payer( AN("bob") ), 2u );
+      auto stats = pool.get_statistics();
+      BOOST_REQUIRE_EQUAL( stats.evicted, 1u );
+      BOOST_REQUIRE_EQUAL( stats.rejected, 2u );
+
+      BOOST_TEST_MESSAGE( "--- The evicted transaction is unknown but stays in the pending state until the next block" );
+      BOOST_REQUIRE( !db->is_known_transaction( alice_low.id() ) );
+      SOPHIATX_REQUIRE_THROW( db->push_transaction( alice_low, 0 ), fc::exception );
+
+      BOOST_TEST_MESSAGE( "--- The block is filled best paying first" );
+      generate_block();
+      const auto block = db->fetch_block_by_number( db->head_block_num() );
+      BOOST_REQUIRE_EQUAL( block->transactions.size(), 3u );
+      BOOST_REQUIRE( block->transactions[0].id() == bob_high.id() );
+      BOOST_REQUIRE( block->transactions[1].id() == bob_mid.id() );
+      BOOST_REQUIRE( block->transactions[2].id() == alice_mid.id() );
+      BOOST_REQUIRE( pool.empty() );
+
+      // alice_mid sent 1 SPHTX plus its fee, bob sent 2 SPHTX back, alice_low is not applied
+      BOOST_REQUIRE( db->get_account( AN("alice") ).balance == alice_balance - ASSET( "1.200000 SPHTX" ) + ASSET( "2.000000 SPHTX" ) );
+
+      BOOST_TEST_MESSAGE( "--- The evicted transaction may be pushed again after the block" );
+      db->push_transaction( alice_low, 0 );
+      BOOST_REQUIRE( pool.find( alice_low.id() ) != nullptr );
+
+      validate_database();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( recent_transaction_store, clean_database_fixture )
+{
+   try
+   {
+      ACTORS( (alice)(bob) )
+      fund( AN("alice"), 10000000 );
+
+      auto push_transfer = [&]( uint32_t seconds_until_expiration )
+      {
+         transfer_operation op;
+         op.from = AN("alice");
+         op.to = AN("bob");
+         op.fee = ASSET( "0.100000 SPHTX" );
+         op.amount = ASSET( "1.000000 SPHTX" );
+
+         signed_transaction tx;
+         tx.set_expiration( db->head_block_time() + seconds_until_expiration );
+         tx.operations.push_back( op );
+         tx.sign( alice_private_key, db->get_chain_id() );
+         db->push_transaction( tx, 0 );
+         return tx;
+      };
+
+      BOOST_TEST_MESSAGE( "--- Pending transactions are served from the pending pool" );
+      auto tx = push_transfer( SOPHIATX_MAX_TIME_UNTIL_EXPIRATION );
+      BOOST_REQUIRE( db->get_recent_transaction( tx.id() ).id() == tx.id() );
+
+      BOOST_TEST_MESSAGE( "--- Only the id is kept once the transaction is in a block" );
+      generate_block();
+      BOOST_REQUIRE( db->is_known_transaction( tx.id() ) );
+      BOOST_REQUIRE( db->get_index< transaction_body_index >().indices().empty() );
+      SOPHIATX_REQUIRE_THROW( db->get_recent_transaction( tx.id() ), fc::exception );
+
+      BOOST_TEST_MESSAGE( "--- The body is kept until expiration when enabled" );
+      db->set_store_recent_transactions( true );
+      tx = push_transfer( SOPHIATX_BLOCK_INTERVAL * 2 );
+      generate_block();
+      BOOST_REQUIRE( db->get_recent_transaction( tx.id() ).id() == tx.id() );
+
+      generate_blocks( 3 );
+      BOOST_REQUIRE( !db->is_known_transaction( tx.id() ) );
+      BOOST_REQUIRE( db->get_index< transaction_body_index >().indices().empty() );
+      SOPHIATX_REQUIRE_THROW( db->get_recent_transaction( tx.id() ), fc::exception );
+
+      validate_database();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( invariant_totals, clean_database_fixture )
+{
+   try
+   {
+      ACTORS( (alice) )
+      fund( AN("alice"), 10000000 );
+      vest( AN("alice"), 1000000 );
+      generate_block();
+
+      const auto& totals = db->get_index< account_index >().aggregate();
+      share_type balance = totals.balance;
+
+      BOOST_TEST_MESSAGE( "--- Totals follow every modification, not only adjust_balance" );
+      {
+         auto session = db->start_undo_session();
+         db->modify( db->get_account( AN("alice") ), [&]( account_object& a ) { a.balance.amount += 1; } );
+         BOOST_REQUIRE( totals.balance == balance + 1 );
+         SOPHIATX_REQUIRE_THROW( db->validate_invariants(), fc::exception );
+
+         BOOST_TEST_MESSAGE( "--- Undo restores the totals" );
+         session.undo();
+      }
+      BOOST_REQUIRE( db->get_index< account_index >().aggregate().balance == balance );
+      validate_database();
+   }
+   FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( block_profiling, clean_database_fixture )
+{
+   try
+   {
+      ACTORS( (alice)(bob) )
+      fund( AN("alice"), 10000000 );
+      generate_block();
+
+      uint32_t handler_calls = 0;
+      auto connection = db->add_pre_apply_operation_handler( [&]( const operation_notification& ){ ++handler_calls; }, "test" );
+
+      BOOST_REQUIRE( !db->get_block_profile().enabled );
+      db->set_block_profiling( true );
+
+      BOOST_TEST_MESSAGE( "--- Pending transactions are not profiled" );
+      transfer_operation op;
+      op.from = AN("alice");
+      op.to = AN("bob");
+      op.amount = ASSET( "1.000000 SPHTX" );
+      op.fee = ASSET( "0.100000 SPHTX" );
+      PUSH_OP( op, alice_private_key );
+      auto profile = db->get_block_profile();
+      BOOST_REQUIRE( profile.enabled );
+      BOOST_REQUIRE_EQUAL( profile.blocks, 0u );
+      BOOST_REQUIRE( profile.operations.empty() );
+      BOOST_REQUIRE( profile.handlers.empty() );
+      BOOST_REQUIRE_GT( handler_calls, 0u );
+
+      BOOST_TEST_MESSAGE( "--- Applied blocks are profiled by phase, operation and plugin handler" );
+      handler_calls = 0;
+      generate_block();
+      profile = db->get_block_profile();
+      BOOST_REQUIRE_EQUAL( profile.blocks, 1u );
+      BOOST_REQUIRE_EQUAL( profile.phases[ "transactions" ].count, 1u );
+      BOOST_REQUIRE_EQUAL( profile.phases[ "process_interests" ].count, 1u );
+      BOOST_REQUIRE_EQUAL( profile.operations.size(), 1u );
+      BOOST_REQUIRE_EQUAL( profile.operations.begin()->second.count, 1u );
+      // generate_block() also applies the pending transactions outside of the block
+      BOOST_REQUIRE_GT( profile.handlers[ "test" ][ "pre_apply_operation" ].count, 0u );
+      BOOST_REQUIRE_LE( profile.handlers[ "test" ][ "pre_apply_operation" ].count, handler_calls );
+
+      db->set_block_profiling( false );
+      generate_block();
+      BOOST_REQUIRE_EQUAL( db->get_block_profile().blocks, 1u );
+      chain::util::disconnect_signal( connection );
+   }
+   FC_LOG_AND_RETHROW()
+}
+
 BOOST_FIXTURE_TEST_CASE( hardfork_test, database_fixture )
 {
    try
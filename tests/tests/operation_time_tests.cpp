@@ -270,6 +270,12 @@ BOOST_AUTO_TEST_CASE( interests )
       BOOST_REQUIRE( db->get_account( AN("alice") ).balance.amount.value >= 100000000 + expected_interest/10  && db->get_account( AN("alice") ).balance.amount.value <= 100000000 + 2*expected_interest/10);
       validate_database();
 
+      BOOST_TEST_MESSAGE( "--- Only accounts with holdings are scheduled for interests" );
+      const auto& batch_idx = db->get_index< account_index, by_interest_batch >();
+      BOOST_REQUIRE( db->get_account( AN("bob") ).earns_interest() );
+      for( const auto& a : db->get_index< account_index, by_id >() )
+         BOOST_REQUIRE( a.earns_interest() == ( batch_idx.count( boost::make_tuple( true, a.interest_batch(), a.id ) ) == 1 ) );
+
    }FC_LOG_AND_RETHROW()
 }
 